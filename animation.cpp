@@ -0,0 +1,265 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <unordered_map>
+
+namespace
+{
+  std::unordered_map<std::string, uint32_t> nodesByName(const SceneGraph &graph)
+  {
+    std::unordered_map<std::string, uint32_t> nodes;
+    nodes.reserve(graph.nodeCount());
+    for (uint32_t i = 0; i < graph.nodeCount(); i++)
+      nodes.emplace(graph.name(i), i); // 同名节点取先序第一个
+    return nodes;
+  }
+
+  // 在 times[first, first + count) 中查找 time 所在的关键帧区间，区间外取端点
+  void findKey(const std::vector<float> &times, uint32_t first, uint32_t count, float time, uint32_t &key0,
+               uint32_t &key1, float &alpha)
+  {
+    key0 = key1 = first;
+    alpha = 0.0f;
+    if (count <= 1)
+      return;
+    const float *begin = times.data() + first;
+    const float *end = begin + count;
+    const float *it = std::upper_bound(begin, end, time);
+    if (it == begin)
+      return;
+    if (it == end)
+    {
+      key0 = key1 = first + count - 1;
+      return;
+    }
+    key1 = static_cast<uint32_t>(it - times.data());
+    key0 = key1 - 1;
+    float span = times[key1] - times[key0];
+    alpha = span > 0.0f ? (time - times[key0]) / span : 0.0f;
+  }
+
+  // 区间 [first, first + count) 的三分量关键帧收集到结构数组的 a/b 两端
+  void gatherVec3(const std::vector<float> &times, const std::vector<glm::vec3> &keys, uint32_t first, uint32_t count,
+                  float time, size_t c, std::vector<float> *a, std::vector<float> *b, std::vector<float> &alpha)
+  {
+    uint32_t key0, key1;
+    findKey(times, first, count, time, key0, key1, alpha[c]);
+    const glm::vec3 &v0 = keys[key0];
+    const glm::vec3 &v1 = keys[key1];
+    a[0][c] = v0.x, a[1][c] = v0.y, a[2][c] = v0.z;
+    b[0][c] = v1.x, b[1][c] = v1.y, b[2][c] = v1.z;
+  }
+
+  // out = a + (b - a) * alpha，逐分量批量计算
+  void lerpBatch(const std::vector<float> *a, const std::vector<float> *b, const std::vector<float> &alpha,
+                 std::vector<float> *out, int components, size_t n)
+  {
+    const float *t = alpha.data();
+    for (int i = 0; i < components; i++)
+    {
+      const float *pa = a[i].data();
+      const float *pb = b[i].data();
+      float *po = out[i].data();
+      for (size_t c = 0; c < n; c++)
+        po[c] = pa[c] + (pb[c] - pa[c]) * t[c];
+    }
+  }
+}
+
+void Animation::load(const aiScene *scene, const SceneGraph &graph)
+{
+  clips_.clear();
+  animated_.assign(graph.nodeCount(), 0);
+  if (!scene || scene->mNumAnimations == 0)
+    return;
+
+  std::unordered_map<std::string, uint32_t> nodes = nodesByName(graph);
+  for (unsigned int a = 0; a < scene->mNumAnimations; a++)
+  {
+    const aiAnimation *animation = scene->mAnimations[a];
+    double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+    Clip clip;
+    clip.name = animation->mName.length > 0 ? animation->mName.C_Str() : "clip " + std::to_string(a);
+    clip.duration = static_cast<float>(animation->mDuration / ticksPerSecond);
+
+    size_t skipped = 0;
+    for (unsigned int c = 0; c < animation->mNumChannels; c++)
+    {
+      const aiNodeAnim *source = animation->mChannels[c];
+      auto node = nodes.find(source->mNodeName.C_Str());
+      if (node == nodes.end())
+      {
+        skipped++;
+        continue;
+      }
+
+      Channel channel;
+      channel.node = node->second;
+      channel.positionFirst = static_cast<uint32_t>(clip.positions.size());
+      for (unsigned int k = 0; k < source->mNumPositionKeys; k++)
+      {
+        const aiVectorKey &key = source->mPositionKeys[k];
+        clip.positionTimes.push_back(static_cast<float>(key.mTime / ticksPerSecond));
+        clip.positions.push_back(glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+      }
+      if (source->mNumPositionKeys == 0)
+      {
+        clip.positionTimes.push_back(0.0f);
+        clip.positions.push_back(glm::vec3(0.0f));
+      }
+      channel.positionCount = static_cast<uint32_t>(clip.positions.size()) - channel.positionFirst;
+
+      channel.rotationFirst = static_cast<uint32_t>(clip.rotations.size());
+      for (unsigned int k = 0; k < source->mNumRotationKeys; k++)
+      {
+        const aiQuatKey &key = source->mRotationKeys[k];
+        clip.rotationTimes.push_back(static_cast<float>(key.mTime / ticksPerSecond));
+        clip.rotations.push_back(glm::vec4(key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w));
+      }
+      if (source->mNumRotationKeys == 0)
+      {
+        clip.rotationTimes.push_back(0.0f);
+        clip.rotations.push_back(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+      }
+      channel.rotationCount = static_cast<uint32_t>(clip.rotations.size()) - channel.rotationFirst;
+
+      channel.scaleFirst = static_cast<uint32_t>(clip.scales.size());
+      for (unsigned int k = 0; k < source->mNumScalingKeys; k++)
+      {
+        const aiVectorKey &key = source->mScalingKeys[k];
+        clip.scaleTimes.push_back(static_cast<float>(key.mTime / ticksPerSecond));
+        clip.scales.push_back(glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+      }
+      if (source->mNumScalingKeys == 0)
+      {
+        clip.scaleTimes.push_back(0.0f);
+        clip.scales.push_back(glm::vec3(1.0f));
+      }
+      channel.scaleCount = static_cast<uint32_t>(clip.scales.size()) - channel.scaleFirst;
+      clip.channels.push_back(channel);
+    }
+    if (skipped > 0)
+      std::cout << "动画 " << clip.name << ": " << skipped << " 条通道找不到节点" << std::endl;
+    addClip(std::move(clip), graph.nodeCount());
+  }
+}
+
+void Animation::addClip(Clip clip, size_t nodeCount)
+{
+  animated_.resize(std::max(animated_.size(), nodeCount), 0);
+  for (const Channel &channel : clip.channels)
+    animated_[channel.node] = 1;
+  clips_.push_back(std::move(clip));
+}
+
+size_t Animation::resolveSkin(Skin &skin, const SceneGraph &graph)
+{
+  std::unordered_map<std::string, uint32_t> nodes = nodesByName(graph);
+  size_t missing = 0;
+  skin.nodes.resize(skin.names.size());
+  for (size_t i = 0; i < skin.names.size(); i++)
+  {
+    auto node = nodes.find(skin.names[i]);
+    if (node == nodes.end())
+    {
+      skin.nodes[i] = 0;
+      missing++;
+      continue;
+    }
+    skin.nodes[i] = node->second;
+  }
+  return missing;
+}
+
+void Animation::evaluate(const SceneGraph &graph, size_t clipIndex, float time, std::vector<glm::mat4> &world,
+                         Scratch &scratch) const
+{
+  size_t nodeCount = graph.nodeCount();
+  scratch.local.resize(nodeCount);
+  for (uint32_t i = 0; i < nodeCount; i++)
+    scratch.local[i] = graph.local(i);
+
+  if (clipIndex < clips_.size())
+  {
+    const Clip &clip = clips_[clipIndex];
+    size_t n = clip.channels.size();
+    float t = clip.duration > 0.0f ? std::fmod(time, clip.duration) : 0.0f;
+    if (t < 0.0f)
+      t += clip.duration;
+
+    for (int i = 0; i < 10; i++)
+    {
+      scratch.a[i].resize(n);
+      scratch.b[i].resize(n);
+      scratch.out[i].resize(n);
+    }
+    for (int i = 0; i < 3; i++)
+      scratch.alpha[i].resize(n);
+
+    // 1. 逐通道查找关键帧区间，区间两端的值收集为结构数组
+    for (size_t c = 0; c < n; c++)
+    {
+      const Channel &channel = clip.channels[c];
+      gatherVec3(clip.positionTimes, clip.positions, channel.positionFirst, channel.positionCount, t, c, scratch.a,
+                 scratch.b, scratch.alpha[0]);
+      gatherVec3(clip.scaleTimes, clip.scales, channel.scaleFirst, channel.scaleCount, t, c, scratch.a + 7,
+                 scratch.b + 7, scratch.alpha[2]);
+      uint32_t key0, key1;
+      findKey(clip.rotationTimes, channel.rotationFirst, channel.rotationCount, t, key0, key1, scratch.alpha[1][c]);
+      const glm::vec4 &q0 = clip.rotations[key0];
+      const glm::vec4 &q1 = clip.rotations[key1];
+      scratch.a[3][c] = q0.x, scratch.a[4][c] = q0.y, scratch.a[5][c] = q0.z, scratch.a[6][c] = q0.w;
+      scratch.b[3][c] = q1.x, scratch.b[4][c] = q1.y, scratch.b[5][c] = q1.z, scratch.b[6][c] = q1.w;
+    }
+
+    // 2. 批量插值：平移与缩放线性插值；旋转取最短路径后归一化线性插值（nlerp）
+    lerpBatch(scratch.a, scratch.b, scratch.alpha[0], scratch.out, 3, n);
+    lerpBatch(scratch.a + 7, scratch.b + 7, scratch.alpha[2], scratch.out + 7, 3, n);
+    {
+      float *ax = scratch.a[3].data(), *ay = scratch.a[4].data(), *az = scratch.a[5].data(), *aw = scratch.a[6].data();
+      float *bx = scratch.b[3].data(), *by = scratch.b[4].data(), *bz = scratch.b[5].data(), *bw = scratch.b[6].data();
+      float *ox = scratch.out[3].data(), *oy = scratch.out[4].data(), *oz = scratch.out[5].data(), *ow = scratch.out[6].data();
+      const float *alpha = scratch.alpha[1].data();
+      for (size_t c = 0; c < n; c++)
+      {
+        float dot = ax[c] * bx[c] + ay[c] * by[c] + az[c] * bz[c] + aw[c] * bw[c];
+        float sign = dot < 0.0f ? -1.0f : 1.0f;
+        float x = ax[c] + (bx[c] * sign - ax[c]) * alpha[c];
+        float y = ay[c] + (by[c] * sign - ay[c]) * alpha[c];
+        float z = az[c] + (bz[c] * sign - az[c]) * alpha[c];
+        float w = aw[c] + (bw[c] * sign - aw[c]) * alpha[c];
+        float inverse = 1.0f / std::sqrt(std::max(x * x + y * y + z * z + w * w, 1e-12f));
+        ox[c] = x * inverse, oy[c] = y * inverse, oz[c] = z * inverse, ow[c] = w * inverse;
+      }
+    }
+
+    // 3. 组合为局部矩阵 T * R * S
+    for (size_t c = 0; c < n; c++)
+    {
+      float x = scratch.out[3][c], y = scratch.out[4][c], z = scratch.out[5][c], w = scratch.out[6][c];
+      float sx = scratch.out[7][c], sy = scratch.out[8][c], sz = scratch.out[9][c];
+      glm::mat4 &m = scratch.local[clip.channels[c].node];
+      m[0] = glm::vec4((1.0f - 2.0f * (y * y + z * z)) * sx, 2.0f * (x * y + w * z) * sx, 2.0f * (x * z - w * y) * sx, 0.0f);
+      m[1] = glm::vec4(2.0f * (x * y - w * z) * sy, (1.0f - 2.0f * (x * x + z * z)) * sy, 2.0f * (y * z + w * x) * sy, 0.0f);
+      m[2] = glm::vec4(2.0f * (x * z + w * y) * sz, 2.0f * (y * z - w * x) * sz, (1.0f - 2.0f * (x * x + y * y)) * sz, 0.0f);
+      m[3] = glm::vec4(scratch.out[0][c], scratch.out[1][c], scratch.out[2][c], 1.0f);
+    }
+  }
+
+  // 4. 先序存放保证父节点先于子节点求出
+  world.resize(nodeCount);
+  for (uint32_t i = 0; i < nodeCount; i++)
+  {
+    uint32_t parent = graph.parent(i);
+    world[i] = parent == SceneGraph::kNoParent ? scratch.local[i] : world[parent] * scratch.local[i];
+  }
+}
+
+void Animation::skinPalette(const Skin &skin, uint32_t meshNode, const std::vector<glm::mat4> &world, glm::mat4 *palette)
+{
+  glm::mat4 meshInverse = glm::inverse(world[meshNode]);
+  size_t bones = std::min<size_t>(skin.nodes.size(), kMaxBones);
+  for (size_t i = 0; i < bones; i++)
+    palette[i] = meshInverse * world[skin.nodes[i]] * skin.offsets[i];
+}
@@ -0,0 +1,81 @@
+#ifndef __ANIMATION_H
+#define __ANIMATION_H
+
+#include <assimp/scene.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "scene_graph.h"
+
+// 骨骼动画：从 aiAnimation 读取的动画片段与网格的骨骼（蒙皮）数据。
+// 关键帧按通道连续存放；求值时先逐通道查找关键帧区间，再以结构数组（SoA）形式批量插值
+// 平移/旋转/缩放（循环体内无分支，便于编译器向量化），最后沿场景图先序求出所有节点的矩阵
+class Animation
+{
+public:
+  static constexpr int kMaxBones = 128; // 每个网格的骨骼上限，与 vertex.glsl 中的 BonePalette 一致
+
+  // 一条动画通道：驱动一个场景图节点，平移/旋转/缩放关键帧分别为 keys 中的区间
+  struct Channel
+  {
+    uint32_t node;
+    uint32_t positionFirst, positionCount;
+    uint32_t rotationFirst, rotationCount;
+    uint32_t scaleFirst, scaleCount;
+  };
+
+  struct Clip
+  {
+    std::string name;
+    float duration = 0.0f; // 秒
+    std::vector<Channel> channels;
+    std::vector<float> positionTimes;
+    std::vector<glm::vec3> positions;
+    std::vector<float> rotationTimes;
+    std::vector<glm::vec4> rotations; // 四元数 (x, y, z, w)
+    std::vector<float> scaleTimes;
+    std::vector<glm::vec3> scales;
+  };
+
+  // 网格的骨骼：骨骼节点与偏移矩阵（网格空间 -> 绑定姿态下的骨骼空间）
+  struct Skin
+  {
+    std::vector<std::string> names; // 加载时按名称记录，处理完节点后解析为 nodes
+    std::vector<uint32_t> nodes;
+    std::vector<glm::mat4> offsets;
+  };
+
+  // 求值用的临时数组，每个线程一份，反复使用避免分配
+  struct Scratch
+  {
+    std::vector<float> alpha[3];     // 平移/旋转/缩放在关键帧区间内的插值系数
+    std::vector<float> a[10], b[10]; // 区间两端的 平移xyz、旋转xyzw、缩放xyz
+    std::vector<float> out[10];
+    std::vector<glm::mat4> local;
+  };
+
+private:
+  std::vector<Clip> clips_;
+  std::vector<uint8_t> animated_; // 场景图节点是否被某个片段驱动
+
+public:
+  // 读取场景中的全部动画片段，按名称绑定到场景图节点（找不到节点的通道忽略）
+  void load(const aiScene *scene, const SceneGraph &graph);
+  void addClip(Clip clip, size_t nodeCount); // 直接添加片段（基准测试用）
+  // 把骨骼名称解析为场景图节点，返回找不到的骨骼数（这些骨骼保持在根节点）
+  static size_t resolveSkin(Skin &skin, const SceneGraph &graph);
+
+  bool empty() const { return clips_.empty(); }
+  size_t clipCount() const { return clips_.size(); }
+  const Clip &clip(size_t index) const { return clips_[index]; }
+  bool animates(uint32_t node) const { return node < animated_.size() && animated_[node]; }
+
+  // 以场景图的局部矩阵为绑定姿态，求出片段在 time 秒（循环播放）时所有节点的世界矩阵（含根节点的标准化变换）
+  void evaluate(const SceneGraph &graph, size_t clip, float time, std::vector<glm::mat4> &world, Scratch &scratch) const;
+  // 骨骼矩阵：网格空间的绑定姿态 -> meshNode 处的动画姿态，写入 palette[0..bones)
+  static void skinPalette(const Skin &skin, uint32_t meshNode, const std::vector<glm::mat4> &world, glm::mat4 *palette);
+};
+
+#endif
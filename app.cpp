@@ -1,8 +1,11 @@
 #include "app.h"
+#include "startup.h"
 
 // 全局Core指针，用于滚轮回调函数
 static Core *g_core = nullptr;
 
+static const char *kFontPath = "fonts/AlimamaFangYuanTiVF-Thin-2.ttf"; // 资源逻辑名
+
 static void glfw_error_callback(int error, const char *descroption)
 {
   std::cout << "GLFW Error " << error << ":" << descroption << "\n"
@@ -19,7 +22,7 @@ static void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
     return; // ImGui正在使用鼠标，不处理轨迹球
   }
 
-  if (g_core)
+  if (g_core && !g_core->isReplaying())
   {
     g_core->onMouseScroll(xoffset, yoffset);
   }
@@ -27,6 +30,13 @@ static void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
 
 App::App()
 {
+  // 与窗口创建、GL加载并行：读入界面字体与着色器源码（资源包中的文件只需查找）
+  font_loader_ = std::async(std::launch::async, [this]()
+                            { return AssetArchive::get_instance().read(kFontPath, font_data_); });
+  std::future<void> shaderPreload = std::async(std::launch::async, []()
+                                               { AssetArchive::get_instance().preload(Core::shaderFiles()); });
+
+  Startup &startup = Startup::get_instance();
   glfwSetErrorCallback(glfw_error_callback);
   if (!glfwInit())
   {
@@ -51,6 +61,7 @@ App::App()
     glfwTerminate();
     exit(EXIT_FAILURE);
   }
+  startup.mark("window");
 
   glfwMakeContextCurrent(window_);
   glfwSwapInterval(1);
@@ -67,6 +78,8 @@ App::App()
   glEnable(GL_CULL_FACE); // 启用背面剔除
   glCullFace(GL_BACK);
   glFrontFace(GL_CCW);
+  startup.mark("gl");
+  shaderPreload.wait();
   init();
 }
 
@@ -96,16 +109,46 @@ void App::init()
   ImGui_ImplOpenGL3_Init("#version 330 core");
 
   style.FontSizeBase = 16.0f;
-  // io.Fonts->AddFontDefault();
-  io.Fonts->AddFontFromFileTTF("/Users/mds/my/spatial_plane_simulation/assets/AlimamaFangYuanTiVF-Thin-2.ttf");
+  // 界面字体在工作线程上读入，就绪前先用内置字体绘制首帧（见 apply_deferred_init）
+  io.Fonts->AddFontDefault();
+  Startup::get_instance().mark("imgui");
 
   core_ = new Core();
   core_->init();
+  Startup::get_instance().mark("core_init");
+
+  // 即时模式以显示器刷新率为周期初值，运行中按实测交换间隔修正
+  if (const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor()))
+  {
+    FramePacer::get_instance().setRefreshRate(mode->refreshRate);
+  }
 
   // 设置全局Core指针，供滚轮回调函数使用
   g_core = core_;
 }
 
+// 每帧开始（NewFrame 之前，主线程）：接入已完成的后台初始化
+void App::apply_deferred_init()
+{
+  if (!font_loader_.valid())
+    return;
+  // 回放依赖录制时的界面布局，等字体就绪后再开始
+  if (!core_->isReplaying() && font_loader_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return;
+  AssetArchive::Blob font = font_loader_.get();
+  if (!font)
+  {
+    std::cout << "无法读取字体: " << kFontPath << std::endl;
+    return;
+  }
+  // 字形按需光栅化，字体数据须在图集的整个生命周期内有效：映射内存或 font_data_ 一直保留，图集不负责释放
+  ImFontConfig config;
+  config.FontDataOwnedByAtlas = false;
+  ImGuiIO &io = ImGui::GetIO();
+  io.FontDefault = io.Fonts->AddFontFromMemoryTTF(const_cast<char *>(font.data), static_cast<int>(font.size), 0.0f, &config);
+  Startup::get_instance().mark("font");
+}
+
 void App::before_render()
 {
   core_->before_render();
@@ -119,41 +162,333 @@ void App::render()
   core_->imgui_render();
 }
 
+void App::after_render()
+{
+  if (core_->isReplaying())
+    replay_active_ = true;
+  core_->after_render();
+
+  // 回放结束（报告由GL线程写出之后）：恢复帧节奏模式，按需退出
+  if (replay_active_ && core_->replayDone())
+  {
+    replay_active_ = false;
+    replay_uncapped_.store(false);
+    FramePacer::get_instance().setSuspended(false);
+    if (exit_after_replay_)
+    {
+      glfwSetWindowShouldClose(window_, GLFW_TRUE);
+    }
+  }
+}
+
 void App::clean()
 {
   core_->clean();
 }
 
+void App::apply_swap_interval()
+{
+  int interval = replay_uncapped_.load() ? 0 : FramePacer::get_instance().swapInterval();
+  if (interval != applied_swap_interval_)
+  {
+    glfwSwapInterval(interval);
+    applied_swap_interval_ = interval;
+  }
+}
+
 void App::app_run()
 {
+  if (render_thread_enabled_)
+  {
+    app_run_threaded();
+    return;
+  }
+
+  FramePacer &pacer = FramePacer::get_instance();
   while (!glfwWindowShouldClose(window_))
   {
+    pacer.waitForFrame();
     glfwPollEvents();
+    double inputTime = glfwGetTime();
     if (glfwGetWindowAttrib(window_, GLFW_ICONIFIED) != 0)
     {
       ImGui_ImplGlfw_Sleep(10);
       continue;
     }
-    before_render();
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
-    render();
-    ImGui::Render();
+    core_->pace_frame();
+    apply_deferred_init();
+    Profiler &profiler = Profiler::get_instance();
+    profiler.beginFrame();
+    GlTrace &glTrace = GlTrace::get_instance();
+    glTrace.beginFrame();
+    {
+      PROFILE_SCOPE("texture_stream");
+      TextureBudget::get_instance().update();
+      TextureStreamer::get_instance().update();
+    }
+    {
+      PROFILE_GPU_SCOPE("before_render");
+      core_->run_operations();
+      before_render();
+    }
+    {
+      PROFILE_SCOPE("imgui_build");
+      ImGui_ImplOpenGL3_NewFrame();
+      ImGui_ImplGlfw_NewFrame();
+      ImGui::NewFrame();
+      render();
+      ImGui::Render();
+    }
     int display_w, display_h;
     glfwGetFramebufferSize(window_, &display_w, &display_h);
     glViewport(0, 0, display_w, display_h);
     glClearColor(clear_color_.x * clear_color_.w, clear_color_.y * clear_color_.w, clear_color_.z * clear_color_.w, clear_color_.w);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    core_->render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+      PROFILE_GPU_SCOPE("clear");
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+    // late latch：面板与清屏之后再取一次光标，轨迹球使用离提交最近的位置。
+    // 新事件留在ImGui的事件队列里，下一帧照常处理
+    if (pacer.lateLatch() && !core_->isReplaying())
+    {
+      glfwPollEvents();
+      double x, y;
+      glfwGetCursorPos(window_, &x, &y);
+      inputTime = glfwGetTime();
+      core_->latchCursor(glm::vec2(static_cast<float>(x), static_cast<float>(y)));
+    }
+    FrameView view = core_->update_camera();
+    view.sampleTime = inputTime;
+    core_->render(view);
+    {
+      PROFILE_GPU_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+      ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+    core_->finish_render();
+    glTrace.endFrame();
+    profiler.endFrame();
+    // 回放的计时与报告在本帧计时结束之后，最后一帧的耗时也能写入报告
+    core_->record_replay_frame(core_->replayFrame());
+    after_render();
+    pacer.beforeSwap(view.sampleTime);
+    apply_swap_interval();
     glfwSwapBuffers(window_);
+    pacer.afterSwap();
+    Startup::get_instance().firstFrame();
   }
 }
 
+// 主线程：事件、轨迹球与ImGui。不等待渲染线程的帧，只在构建面板时短暂持有场景锁
+void App::app_run_threaded()
+{
+  // GL上下文交给渲染线程
+  glfwMakeContextCurrent(nullptr);
+  rendering_.store(true);
+  render_thread_ = std::thread(&App::render_loop, this);
+
+  std::mutex &sceneMutex = core_->sceneMutex();
+  uint64_t frame = 0;
+  while (!glfwWindowShouldClose(window_))
+  {
+    glfwWaitEventsTimeout(kInputInterval);
+    double inputTime = glfwGetTime();
+    if (glfwGetWindowAttrib(window_, GLFW_ICONIFIED) != 0)
+    {
+      ImGui_ImplGlfw_Sleep(10);
+      continue;
+    }
+    core_->pace_frame();
+    {
+      // 回放注入的面板事件可能排队加载模型
+      std::unique_lock<std::mutex> lock(sceneMutex, std::defer_lock);
+      if (core_->isReplaying())
+        lock.lock();
+      before_render();
+    }
+    apply_deferred_init();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    // 相机先于面板发布：面板等待场景锁时渲染线程已能使用本次输入的结果
+    views_.writeBuffer() = core_->update_camera();
+    views_.writeBuffer().sampleTime = inputTime;
+    views_.publish();
+
+    {
+      std::lock_guard<std::mutex> lock(sceneMutex);
+      render();
+    }
+    ImGui::Render();
+
+    UiSnapshot &snapshot = ui_snapshots_.writeBuffer();
+    snapshot.frame = ++frame;
+    glfwGetFramebufferSize(window_, &snapshot.framebufferWidth, &snapshot.framebufferHeight);
+    snapshot.capture(ImGui::GetDrawData());
+    snapshot.replayFrame = core_->replayFrame();
+    bool waitTextures = snapshot.textureSync && snapshot.framebufferWidth > 0 && snapshot.framebufferHeight > 0;
+    ui_snapshots_.publish();
+    after_render();
+
+    // ImGui纹理（字体图集）需要上传时，等渲染线程提交完这份快照再开始下一帧，
+    // 避免主线程在上传过程中修改纹理像素或状态。只在启动和新字形出现时发生
+    while (waitTextures && ui_presented_.load(std::memory_order_acquire) < frame)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  rendering_.store(false);
+  render_thread_.join();
+  glfwMakeContextCurrent(window_);
+}
+
+// 渲染线程：取最新的相机状态与界面快照提交GL命令。没有新快照时沿用上一份，
+// 帧节奏由 FramePacer 与交换缓冲决定。一帧分三段：更新阶段与帧末发布持有场景锁，
+// GL提交与交换缓冲不持有，主线程构建面板不必等待提交（工作线程在提交期间持锁准备下一帧）。
+// 即时模式下渲染线程睡到消隐前才取相机，主线程以 kInputInterval 持续发布，取到的输入足够新
+void App::render_loop()
+{
+  glfwMakeContextCurrent(window_);
+  std::mutex &sceneMutex = core_->sceneMutex();
+  FramePacer &pacer = FramePacer::get_instance();
+  Profiler &profiler = Profiler::get_instance();
+  GlTrace &glTrace = GlTrace::get_instance();
+  bool hasView = false;
+  bool hasUi = false;
+  while (rendering_.load(std::memory_order_acquire))
+  {
+    pacer.waitForFrame();
+    hasView = views_.acquire() || hasView;
+    bool newUi = ui_snapshots_.acquire();
+    hasUi = newUi || hasUi;
+    UiSnapshot &ui = ui_snapshots_.readBuffer();
+    if (!hasView || !hasUi || ui.framebufferWidth <= 0 || ui.framebufferHeight <= 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(sceneMutex);
+      profiler.beginFrame();
+      glTrace.beginFrame();
+      {
+        PROFILE_SCOPE("texture_stream");
+        TextureBudget::get_instance().update();
+        TextureStreamer::get_instance().update();
+      }
+      {
+        PROFILE_GPU_SCOPE("before_render");
+        core_->run_operations();
+      }
+      core_->update_scene(views_.readBuffer());
+    }
+
+    glViewport(0, 0, ui.framebufferWidth, ui.framebufferHeight);
+    glClearColor(clear_color_.x * clear_color_.w, clear_color_.y * clear_color_.w, clear_color_.z * clear_color_.w, clear_color_.w);
+    {
+      PROFILE_GPU_SCOPE("clear");
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+    core_->submit_scene();
+    {
+      PROFILE_GPU_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+      ImGui_ImplOpenGL3_NewFrame();
+      ImGui_ImplOpenGL3_RenderDrawData(&ui.drawData);
+    }
+    // 纹理只在主线程等待的那一帧更新，沿用该快照时不再访问ImGui的纹理列表
+    ui.drawData.Textures = nullptr;
+    core_->wait_prepare();
+
+    {
+      std::lock_guard<std::mutex> lock(sceneMutex);
+      core_->finish_render();
+      glTrace.endFrame();
+      profiler.endFrame();
+      // 回放计时与报告在本帧计时结束之后；沿用旧快照的帧没有呈现新的回放帧
+      if (newUi)
+        core_->record_replay_frame(ui.replayFrame);
+    }
+    ui_presented_.store(ui.frame, std::memory_order_release);
+    pacer.beforeSwap(views_.readBuffer().sampleTime);
+    apply_swap_interval();
+    glfwSwapBuffers(window_);
+    pacer.afterSwap();
+    Startup::get_instance().firstFrame();
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
+UiSnapshot::~UiSnapshot()
+{
+  for (ImDrawList *list : lists)
+    IM_DELETE(list);
+}
+
+void UiSnapshot::capture(const ImDrawData *source)
+{
+  while (lists.size() < static_cast<size_t>(source->CmdLists.Size))
+    lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+  drawData.Clear();
+  drawData.Valid = true;
+  for (int i = 0; i < source->CmdLists.Size; i++)
+  {
+    const ImDrawList *from = source->CmdLists[i];
+    ImDrawList *to = lists[i];
+    to->CmdBuffer = from->CmdBuffer;
+    to->IdxBuffer = from->IdxBuffer;
+    to->VtxBuffer = from->VtxBuffer;
+    to->Flags = from->Flags;
+    drawData.CmdLists.push_back(to);
+  }
+  drawData.CmdListsCount = drawData.CmdLists.Size;
+  drawData.TotalIdxCount = source->TotalIdxCount;
+  drawData.TotalVtxCount = source->TotalVtxCount;
+  drawData.DisplayPos = source->DisplayPos;
+  drawData.DisplaySize = source->DisplaySize;
+  drawData.FramebufferScale = source->FramebufferScale;
+
+  textureSync = false;
+  if (source->Textures)
+  {
+    for (ImTextureData *texture : *source->Textures)
+    {
+      if (texture->Status != ImTextureStatus_OK)
+        textureSync = true;
+    }
+  }
+  drawData.Textures = textureSync ? source->Textures : nullptr;
+}
+
+void App::start_recording(const std::string &path)
+{
+  core_->startRecording(path);
+}
+
+void App::start_replay(const std::string &path, bool fast, bool exitAfterReplay)
+{
+  if (!core_->startReplay(path, fast))
+  {
+    return;
+  }
+  exit_after_replay_ = exitAfterReplay;
+
+  // 全速回放时关闭垂直同步并暂停节奏等待，帧耗时不受刷新率限制
+  replay_uncapped_.store(fast);
+  FramePacer::get_instance().setSuspended(fast);
+}
+
+void App::load_model(const std::string &path)
+{
+  core_->applyAction(SessionAction::LoadModel, path);
+}
+
 void App::app_exit()
 {
   clean();
+  TextureStreamer::get_instance().release();
+  FramePacer::get_instance().release();
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
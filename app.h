@@ -9,21 +9,72 @@
 #include <imgui_impl_opengl3.h>
 
 #include "core.h"
+#include "profiler.h"
+#include "gl_trace.h"
+#include "texture_streamer.h"
+#include "texture_budget.h"
+#include "triple_buffer.h"
+#include "frame_pacer.h"
+#include "asset_archive.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
 constexpr int width = 1280;
 constexpr int height = 800;
 constexpr const char *title = "TrackBall";
 
+// 主线程一帧的界面快照：ImGui绘制列表的副本，交给渲染线程提交
+struct UiSnapshot
+{
+  uint64_t frame = 0;
+  int framebufferWidth = 0;
+  int framebufferHeight = 0;
+  bool textureSync = false; // ImGui纹理需要创建/更新/销毁，主线程等待渲染线程提交完该快照
+  int64_t replayFrame = -1; // 该次输入对应的回放帧（不在回放时为 -1），渲染线程呈现后记录计时
+  ImDrawData drawData;
+  std::vector<ImDrawList *> lists; // 复用的绘制列表，只复制缓冲内容
+
+  UiSnapshot() = default;
+  ~UiSnapshot();
+  UiSnapshot(const UiSnapshot &) = delete;
+  UiSnapshot &operator=(const UiSnapshot &) = delete;
+
+  void capture(const ImDrawData *source);
+};
+
 class App
 {
 private:
   float main_scale_ = 1.0f;
   bool show_demo_window_ = false;
+  bool exit_after_replay_ = false;
+  bool replay_active_ = false; // 回放已开始而报告尚未写出（主线程）
   ImVec4 clear_color_ = ImColor(23, 20, 25).Value;
 
+  // 启动时在工作线程上读入的界面字体（包外文件读入 font_data_，图集引用这块内存）
+  std::future<AssetArchive::Blob> font_loader_;
+  std::vector<char> font_data_;
+
   GLFWwindow *window_;
   Core *core_;
 
+  // 交换间隔由帧节奏模式决定（全速回放时为0），由持有GL上下文的线程在交换缓冲前应用
+  std::atomic<bool> replay_uncapped_{false};
+  int applied_swap_interval_ = 1;
+
+  // 渲染线程模式（命令行 --render-thread）：GL上下文归渲染线程所有，
+  // 主线程只处理事件、轨迹球与ImGui，经无锁三缓冲发布相机状态与界面快照
+  static constexpr double kInputInterval = 1.0 / 240.0; // 主线程无事件时的最长等待（秒）
+  bool render_thread_enabled_ = false;
+  std::thread render_thread_;
+  std::atomic<bool> rendering_{false};
+  std::atomic<uint64_t> ui_presented_{0}; // 渲染线程最近提交的界面快照帧号
+  TripleBuffer<FrameView> views_;
+  TripleBuffer<UiSnapshot> ui_snapshots_;
+
 private:
   App();
   App(const App &) = delete;
@@ -37,10 +88,22 @@ public:
     return instance;
   }
   void init();
+  void apply_deferred_init();
   void before_render();
   void render();
+  void after_render();
   void clean();
   void app_run();
+  void app_run_threaded(); // 主线程循环（渲染线程模式）
+  void render_loop();      // 渲染线程循环
+  void apply_swap_interval();
   void app_exit();
+
+  void set_render_thread(bool enabled) { render_thread_enabled_ = enabled; }
+
+  // 会话录制/回放（命令行 --record / --replay）
+  void start_recording(const std::string &path);
+  void start_replay(const std::string &path, bool fast, bool exitAfterReplay);
+  void load_model(const std::string &path); // 命令行指定的模型或压力场景
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "asset_archive.h"
+#include "asset_format.h"
+#include "imgui.h"
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/IOStream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 由 CMake 设为源码目录（glsl/、backpack/ 所在位置）
+#ifndef GL_TRACKBALL_ASSET_ROOT
+#define GL_TRACKBALL_ASSET_ROOT "."
+#endif
+
+namespace
+{
+  // 只读的内存流：数据指向资源包的映射内存
+  class BlobIOStream : public Assimp::IOStream
+  {
+  private:
+    AssetArchive::Blob blob_;
+    size_t position_ = 0;
+
+  public:
+    explicit BlobIOStream(AssetArchive::Blob blob) : blob_(blob) {}
+
+    size_t Read(void *buffer, size_t size, size_t count) override
+    {
+      if (size == 0 || count == 0)
+        return 0;
+      size_t items = std::min(count, (blob_.size - position_) / size);
+      std::memcpy(buffer, blob_.data + position_, items * size);
+      position_ += items * size;
+      return items;
+    }
+    size_t Write(const void *, size_t, size_t) override { return 0; }
+    aiReturn Seek(size_t offset, aiOrigin origin) override
+    {
+      size_t target = offset;
+      if (origin == aiOrigin_CUR)
+        target = position_ + offset;
+      else if (origin == aiOrigin_END)
+        target = blob_.size - offset;
+      if (target > blob_.size)
+        return aiReturn_FAILURE;
+      position_ = target;
+      return aiReturn_SUCCESS;
+    }
+    size_t Tell() const override { return position_; }
+    size_t FileSize() const override { return blob_.size; }
+    void Flush() override {}
+  };
+}
+
+AssetArchive::AssetArchive() : root_(GL_TRACKBALL_ASSET_ROOT)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+  unmap();
+}
+
+std::string AssetArchive::resolve(const std::string &path) const
+{
+  std::filesystem::path file(path);
+  if (file.is_absolute())
+    return path;
+  return (std::filesystem::path(root_) / file).lexically_normal().generic_string();
+}
+
+bool AssetArchive::map_file(const std::string &path)
+{
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // 映射建立后即可关闭文件描述符
+  if (mapping == MAP_FAILED)
+    return false;
+  mapping_ = mapping;
+  mapped_bytes_ = static_cast<size_t>(info.st_size);
+  return true;
+#else
+  std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file)
+    return false;
+  fallback_.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(fallback_.data(), static_cast<std::streamsize>(fallback_.size())))
+    return false;
+  mapping_ = fallback_.data();
+  mapped_bytes_ = fallback_.size();
+  return true;
+#endif
+}
+
+void AssetArchive::unmap()
+{
+#ifndef _WIN32
+  if (mapping_ && fallback_.empty())
+    munmap(mapping_, mapped_bytes_);
+#endif
+  std::vector<char>().swap(fallback_);
+  mapping_ = nullptr;
+  mapped_bytes_ = 0;
+  entries_.clear();
+}
+
+bool AssetArchive::open(const std::string &path)
+{
+  auto start = std::chrono::steady_clock::now();
+  unmap();
+  if (!map_file(path))
+  {
+    std::cout << "无法打开资源包: " << path << std::endl;
+    return false;
+  }
+
+  const char *base = static_cast<const char *>(mapping_);
+  assetpack::Header header;
+  bool valid = mapped_bytes_ >= sizeof(header);
+  if (valid)
+  {
+    std::memcpy(&header, base, sizeof(header));
+    uint64_t tableEnd = sizeof(header) + uint64_t(header.entryCount) * sizeof(assetpack::Entry);
+    valid = std::memcmp(header.magic, assetpack::kMagic, sizeof(header.magic)) == 0 && tableEnd <= mapped_bytes_ &&
+            header.namesOffset + header.namesBytes <= mapped_bytes_;
+  }
+  if (valid)
+  {
+    const char *names = base + header.namesOffset;
+    entries_.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++)
+    {
+      assetpack::Entry entry;
+      std::memcpy(&entry, base + sizeof(header) + i * sizeof(entry), sizeof(entry));
+      if (entry.offset + entry.size > mapped_bytes_ || uint64_t(entry.nameOffset) + entry.nameLength > header.namesBytes)
+      {
+        valid = false;
+        break;
+      }
+      entries_[std::string(names + entry.nameOffset, entry.nameLength)] = Blob{base + entry.offset, static_cast<size_t>(entry.size)};
+    }
+  }
+  if (!valid)
+  {
+    std::cout << "资源包格式无效: " << path << std::endl;
+    unmap();
+    return false;
+  }
+
+  path_ = path;
+  open_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return true;
+}
+
+AssetArchive::Blob AssetArchive::find(const std::string &path) const
+{
+  if (entries_.empty())
+    return Blob();
+  auto it = entries_.find(assetpack::logicalName(resolve(path), root_));
+  if (it == entries_.end())
+  {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return Blob();
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return it->second;
+}
+
+AssetArchive::Blob AssetArchive::read(const std::string &path, std::vector<char> &storage) const
+{
+  if (Blob blob = find(path))
+    return blob;
+  std::string file_path = resolve(path);
+  {
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    auto it = preloaded_.find(file_path);
+    if (it != preloaded_.end())
+      return Blob{it->second.data(), it->second.size()};
+  }
+
+  std::ifstream file(file_path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file)
+    return Blob();
+  storage.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(storage.data(), static_cast<std::streamsize>(storage.size())))
+    return Blob();
+  file_bytes_.fetch_add(storage.size(), std::memory_order_relaxed);
+  return Blob{storage.data(), storage.size()};
+}
+
+void AssetArchive::preload(const std::vector<std::string> &paths)
+{
+  for (const std::string &path : paths)
+  {
+    std::vector<char> data;
+    if (find(path) || !read(path, data))
+      continue;
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    preloaded_.emplace(resolve(path), std::move(data));
+  }
+}
+
+void AssetArchive::render_panel()
+{
+  if (!ImGui::CollapsingHeader("资源包"))
+    return;
+
+  if (!isOpen())
+  {
+    ImGui::TextDisabled("未使用资源包（命令行 --pack <文件>），资源从文件系统读取");
+    ImGui::TextWrapped("资源根目录: %s", root_.c_str());
+  }
+  else
+  {
+    ImGui::TextWrapped("%s", path_.c_str());
+    ImGui::TextWrapped("资源根目录（包外文件）: %s", root_.c_str());
+    ImGui::Text("%zu 个文件, 映射 %.2f MB, 打开耗时 %.2f ms", entries_.size(), mapped_bytes_ / (1024.0 * 1024.0), open_ms_);
+  }
+  ImGui::Text("包内命中 %llu, 未命中 %llu, 从文件系统读取 %.2f MB", static_cast<unsigned long long>(hits_.load()),
+              static_cast<unsigned long long>(misses_.load()), file_bytes_.load() / (1024.0 * 1024.0));
+}
+
+ArchiveIOSystem::ArchiveIOSystem() : fallback_(new Assimp::DefaultIOSystem())
+{
+}
+
+ArchiveIOSystem::~ArchiveIOSystem()
+{
+  delete fallback_;
+}
+
+bool ArchiveIOSystem::Exists(const char *file) const
+{
+  return static_cast<bool>(AssetArchive::get_instance().find(file)) || fallback_->Exists(file);
+}
+
+char ArchiveIOSystem::getOsSeparator() const
+{
+  return '/';
+}
+
+Assimp::IOStream *ArchiveIOSystem::Open(const char *file, const char *mode)
+{
+  // 资源包只读，写入（导出）交给默认实现
+  if (std::strchr(mode, 'w') == nullptr && std::strchr(mode, 'a') == nullptr)
+  {
+    if (AssetArchive::Blob blob = AssetArchive::get_instance().find(file))
+      return new BlobIOStream(blob);
+  }
+  return fallback_->Open(file, mode);
+}
+
+void ArchiveIOSystem::Close(Assimp::IOStream *file)
+{
+  if (dynamic_cast<BlobIOStream *>(file))
+  {
+    delete file;
+    return;
+  }
+  fallback_->Close(file);
+}
@@ -0,0 +1,93 @@
+#ifndef __ASSET_ARCHIVE_H
+#define __ASSET_ARCHIVE_H
+
+#include <assimp/IOSystem.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 资源层：着色器、字体、模型及其贴图先在资源包（命令行 --pack）中查找，找不到时回退到文件系统。
+// 程序以相对于资源根目录的逻辑名（如 glsl/vertex.glsl）引用资源，资源包也以逻辑名为键；文件系统回退时
+// 逻辑名拼接到资源根目录（命令行 --assets，默认为源码目录）。绝对路径照常可用，位于根目录下时同样能在包中找到。
+// 资源包启动时以 mmap 只读映射一次，查找结果直接指向映射内存，不经过 ifstream/stringstream 复制；
+// 打开后只读，可在任意线程查找
+class AssetArchive
+{
+public:
+  struct Blob
+  {
+    const char *data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+  };
+
+private:
+  std::string path_;
+  std::string root_;
+  void *mapping_ = nullptr;
+  size_t mapped_bytes_ = 0;
+  std::vector<char> fallback_; // 不支持 mmap 的平台上整个读入
+  std::unordered_map<std::string, Blob> entries_;
+  double open_ms_ = 0.0;
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+  mutable std::atomic<uint64_t> file_bytes_{0}; // 回退到文件系统读取的字节数
+  // 启动时由工作线程预读的包外文件（只增不删，Blob 一直有效）
+  mutable std::mutex preload_mutex_;
+  std::unordered_map<std::string, std::vector<char>> preloaded_;
+
+  AssetArchive();
+  ~AssetArchive();
+  AssetArchive(const AssetArchive &) = delete;
+  AssetArchive &operator=(const AssetArchive &) = delete;
+
+  bool map_file(const std::string &path);
+  void unmap();
+
+public:
+  static AssetArchive &get_instance()
+  {
+    static AssetArchive instance;
+    return instance;
+  }
+
+  bool open(const std::string &path); // 在加载任何资源之前调用（主线程）
+  bool isOpen() const { return !entries_.empty(); }
+
+  void setRoot(const std::string &root) { root_ = root; } // 在加载任何资源之前调用（主线程）
+  const std::string &root() const { return root_; }
+  // 逻辑名或相对路径 -> 资源根目录下的文件系统路径；绝对路径原样返回
+  std::string resolve(const std::string &path) const;
+
+  // 资源包中的文件（逻辑名或路径）；没有打开资源包或不在包中时返回空
+  Blob find(const std::string &path) const;
+  // 优先返回资源包中的映射内存，否则把文件读入 storage 并返回指向它的 Blob（读取失败时为空）
+  Blob read(const std::string &path, std::vector<char> &storage) const;
+  // 预读不在资源包中的文件，之后的 read 直接返回内存中的内容（可在工作线程上调用）
+  void preload(const std::vector<std::string> &paths);
+
+  void render_panel();
+};
+
+// Assimp 的文件系统接口：模型及其引用的文件（.mtl、贴图等）从资源包的映射内存读取，其余交给默认实现
+class ArchiveIOSystem : public Assimp::IOSystem
+{
+public:
+  ArchiveIOSystem();
+  ~ArchiveIOSystem() override;
+
+  bool Exists(const char *file) const override;
+  char getOsSeparator() const override;
+  Assimp::IOStream *Open(const char *file, const char *mode = "rb") override;
+  void Close(Assimp::IOStream *file) override;
+
+private:
+  Assimp::IOSystem *fallback_;
+};
+
+#endif
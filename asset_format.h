@@ -0,0 +1,58 @@
+#ifndef __ASSET_FORMAT_H
+#define __ASSET_FORMAT_H
+
+// 资源包文件（.pack）的格式定义，供打包工具 gl_trackball_pack 与运行时的 AssetArchive 共用（不依赖GL与Assimp）
+//
+// 布局：Header | Entry[entryCount] | 名称表 | 各文件数据
+// 名称为相对于资源根目录的逻辑名（如 glsl/vertex.glsl、fonts/xxx.ttf，以 / 分隔），与打包和运行的机器、目录无关。
+// 文件数据按 kDataAlignment 对齐，映射后可直接作为着色器源码、字体或模型数据使用
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace assetpack
+{
+  constexpr char kMagic[8] = {'G', 'L', 'P', 'A', 'C', 'K', '0', '1'};
+  constexpr uint64_t kDataAlignment = 16;
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t entryCount = 0;
+    uint32_t namesBytes = 0;
+    uint64_t namesOffset = 0; // 名称表在文件中的偏移
+  };
+
+  struct Entry
+  {
+    uint64_t offset; // 文件数据在资源包中的偏移
+    uint64_t size;
+    uint32_t nameOffset; // 名称在名称表中的偏移
+    uint32_t nameLength;
+  };
+
+  inline uint64_t alignData(uint64_t offset) { return (offset + kDataAlignment - 1) / kDataAlignment * kDataAlignment; }
+
+  // 绝对路径、去掉 . 与 ..、以 / 分隔
+  inline std::string normalizePath(const std::string &path)
+  {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(std::filesystem::path(path), error);
+    if (error)
+      absolute = std::filesystem::path(path);
+    return absolute.lexically_normal().generic_string();
+  }
+
+  // 打包与查找使用同一种名称：资源根目录下的文件为相对于根目录的路径，根目录之外的文件为规范化的绝对路径
+  inline std::string logicalName(const std::string &path, const std::string &root)
+  {
+    std::filesystem::path file(normalizePath(path));
+    std::filesystem::path relative = file.lexically_relative(std::filesystem::path(normalizePath(root)));
+    if (relative.empty() || relative == "." || *relative.begin() == "..")
+      return file.generic_string();
+    return relative.generic_string();
+  }
+}
+
+#endif
@@ -0,0 +1,168 @@
+// gl_trackball_pack：把着色器、字体、模型及其贴图打成一个资源包（.pack），应用以 --pack 打开后以 mmap 读取
+//
+//   gl_trackball_pack [--root <资源根目录>] <输出.pack> <文件或目录 | 逻辑名=文件或目录>...
+//
+// 目录递归加入其中的全部文件。每个文件以相对于资源根目录（默认为当前目录）的逻辑名为名称，
+// 如 glsl/vertex.glsl，运行时与 --assets 指定的根目录无关地按逻辑名查找。根目录之外的文件
+// 需以 逻辑名=路径 的形式指定名称（如 fonts/xxx.ttf=/path/to/xxx.ttf），目录则作为该名称下的子树
+#include "asset_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace
+{
+  // files: 逻辑名 -> 文件路径；name 为空时按资源根目录取逻辑名
+  bool collect(const std::filesystem::path &path, const std::string &name, const std::string &root,
+               std::map<std::string, std::string> &files)
+  {
+    auto add = [&](const std::filesystem::path &file, const std::string &logical)
+    {
+      if (logical.empty() || logical.front() == '/')
+      {
+        std::cerr << "不在资源根目录下，需以 逻辑名=路径 指定: " << file.string() << std::endl;
+        return false;
+      }
+      files[logical] = file.string();
+      return true;
+    };
+
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error))
+    {
+      bool ok = true;
+      for (const auto &item : std::filesystem::recursive_directory_iterator(path, error))
+      {
+        if (!item.is_regular_file())
+          continue;
+        std::string logical = name.empty() ? assetpack::logicalName(item.path().string(), root)
+                                           : name + "/" + item.path().lexically_relative(path).generic_string();
+        ok &= add(item.path(), logical);
+      }
+      return ok;
+    }
+    if (std::filesystem::is_regular_file(path, error))
+      return add(path, name.empty() ? assetpack::logicalName(path.string(), root) : name);
+    std::cerr << "跳过不存在的路径: " << path.string() << std::endl;
+    return true;
+  }
+
+  void pad(std::ofstream &out, uint64_t &offset, uint64_t target)
+  {
+    static const char zeros[assetpack::kDataAlignment] = {};
+    out.write(zeros, static_cast<std::streamsize>(target - offset));
+    offset = target;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string root = ".";
+  int first = 1;
+  if (argc > 2 && std::strcmp(argv[1], "--root") == 0)
+  {
+    root = argv[2];
+    first = 3;
+  }
+  if (argc - first < 2)
+  {
+    std::cerr << "用法: gl_trackball_pack [--root <资源根目录>] <输出.pack> <文件或目录 | 逻辑名=文件或目录>..." << std::endl;
+    return 1;
+  }
+  auto start = std::chrono::steady_clock::now();
+  const char *output = argv[first];
+
+  std::map<std::string, std::string> files;
+  for (int i = first + 1; i < argc; i++)
+  {
+    std::string argument = argv[i];
+    size_t equals = argument.find('=');
+    std::string name = equals == std::string::npos ? std::string() : argument.substr(0, equals);
+    std::string path = equals == std::string::npos ? argument : argument.substr(equals + 1);
+    if (!collect(path, name, root, files))
+      return 1;
+  }
+  // 不把输出文件自身打进去
+  for (auto it = files.begin(); it != files.end();)
+  {
+    if (assetpack::normalizePath(it->second) == assetpack::normalizePath(output))
+      it = files.erase(it);
+    else
+      ++it;
+  }
+  if (files.empty())
+  {
+    std::cerr << "没有可打包的文件" << std::endl;
+    return 1;
+  }
+
+  std::string names;
+  std::vector<assetpack::Entry> entries;
+  entries.reserve(files.size());
+  for (const auto &file : files)
+  {
+    assetpack::Entry entry = {};
+    entry.nameOffset = static_cast<uint32_t>(names.size());
+    entry.nameLength = static_cast<uint32_t>(file.first.size());
+    std::error_code error;
+    entry.size = std::filesystem::file_size(file.second, error);
+    names += file.first;
+    entries.push_back(entry);
+  }
+
+  assetpack::Header header;
+  std::memcpy(header.magic, assetpack::kMagic, sizeof(header.magic));
+  header.entryCount = static_cast<uint32_t>(entries.size());
+  header.namesOffset = sizeof(header) + entries.size() * sizeof(assetpack::Entry);
+  header.namesBytes = static_cast<uint32_t>(names.size());
+  uint64_t offset = assetpack::alignData(header.namesOffset + header.namesBytes);
+  for (assetpack::Entry &entry : entries)
+  {
+    entry.offset = offset;
+    offset = assetpack::alignData(offset + entry.size);
+  }
+
+  std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::cerr << "无法写入 " << output << std::endl;
+    return 1;
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(assetpack::Entry)));
+  out.write(names.data(), static_cast<std::streamsize>(names.size()));
+  uint64_t written = header.namesOffset + header.namesBytes;
+
+  std::vector<char> buffer;
+  size_t index = 0;
+  for (const auto &file : files)
+  {
+    const assetpack::Entry &entry = entries[index++];
+    pad(out, written, entry.offset);
+    std::ifstream in(file.second, std::ios::in | std::ios::binary);
+    buffer.resize(static_cast<size_t>(entry.size));
+    if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+    {
+      std::cerr << "读取失败: " << file.second << std::endl;
+      return 1;
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    written += entry.size;
+    std::cout << file.first << " <- " << file.second << " (" << entry.size << " 字节)" << std::endl;
+  }
+  if (!out)
+  {
+    std::cerr << "写入失败: " << output << std::endl;
+    return 1;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "打包 " << entries.size() << " 个文件, " << written << " 字节, 用时 " << seconds << " 秒" << std::endl;
+  return 0;
+}
@@ -0,0 +1,646 @@
+// gl_trackball_bench：热点CPU路径的微基准测试
+// 每个基准输出一行JSON（JSON Lines），便于脚本比较不同版本的结果
+//
+//   gl_trackball_bench [--filter <子串>] [--repeats <次数>] [--out <文件>]
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core.h"
+#include "model.h"
+#include "shader.h"
+#include "profiler.h"
+#include "stress_scene.h"
+#include "triple_buffer.h"
+#include "gl_task_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef BENCH_SOURCE_DIR
+#define BENCH_SOURCE_DIR "."
+#endif
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace
+{
+  constexpr uint32_t kSeed = 20250817; // 固定种子，保证每次运行的输入一致
+
+  // 防止编译器优化掉被测代码的结果
+  volatile float g_sink = 0.0f;
+  void consume(float value) { g_sink = g_sink + value; }
+
+  struct BenchOptions
+  {
+    std::string filter;
+    int repeats = 7;
+    std::string outPath;
+  };
+
+  class BenchRunner
+  {
+  private:
+    BenchOptions options_;
+    std::ofstream out_;
+
+    void emit(const std::string &line)
+    {
+      std::cout << line << std::endl;
+      if (out_.is_open())
+        out_ << line << "\n";
+    }
+
+  public:
+    explicit BenchRunner(const BenchOptions &options) : options_(options)
+    {
+      if (!options_.outPath.empty())
+        out_.open(options_.outPath, std::ios::out | std::ios::trunc);
+    }
+
+    bool selected(const char *name) const
+    {
+      return options_.filter.empty() || std::strstr(name, options_.filter.c_str()) != nullptr;
+    }
+
+    void meta()
+    {
+      std::ostringstream line;
+      line << "{\"bench\": \"meta\", \"build_type\": \"" << BENCH_BUILD_TYPE << "\", \"seed\": " << kSeed
+           << ", \"repeats\": " << options_.repeats << ", \"gl_renderer\": \""
+           << reinterpret_cast<const char *>(glGetString(GL_RENDERER)) << "\", \"gl_version\": \""
+           << reinterpret_cast<const char *>(glGetString(GL_VERSION)) << "\"}";
+      emit(line.str());
+    }
+
+    // 运行 repeats 轮，每轮调用 fn(iterations)，记录每次迭代的纳秒数
+    // itemsPerIteration 用于换算吞吐量（如每次迭代处理的顶点数）
+    void run(const char *name, uint64_t iterations, const std::function<void(uint64_t)> &fn,
+             double itemsPerIteration = 1.0, const char *itemName = "items")
+    {
+      if (!selected(name))
+        return;
+
+      fn(std::max<uint64_t>(1, iterations / 10)); // 预热
+
+      std::vector<double> samples;
+      samples.reserve(options_.repeats);
+      for (int r = 0; r < options_.repeats; r++)
+      {
+        auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / iterations);
+      }
+      std::sort(samples.begin(), samples.end());
+
+      double mean = 0.0;
+      for (double s : samples)
+        mean += s;
+      mean /= samples.size();
+      double median = samples[samples.size() / 2];
+
+      std::ostringstream line;
+      line.setf(std::ios::fixed);
+      line.precision(2);
+      line << "{\"bench\": \"" << name << "\", \"iterations\": " << iterations << ", \"repeats\": " << samples.size()
+           << ", \"median_ns\": " << median << ", \"min_ns\": " << samples.front() << ", \"max_ns\": " << samples.back()
+           << ", \"mean_ns\": " << mean << ", \"" << itemName << "_per_second\": " << itemsPerIteration * 1.0e9 / median
+           << "}";
+      emit(line.str());
+    }
+
+    // 直接输出外部测得的数值（如BVH构建耗时）
+    void record(const char *name, const std::string &fields)
+    {
+      if (!selected(name))
+        return;
+      emit(std::string("{\"bench\": \"") + name + "\", " + fields + "}");
+    }
+  };
+
+  // 合成网格：带起伏的规则网格，包含法线/UV/切线，与Assimp后处理后的数据布局一致
+  aiMesh *createGridMesh(unsigned int resolution, float offset, std::mt19937 &rng)
+  {
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    const unsigned int vertexCount = resolution * resolution;
+    const unsigned int faceCount = (resolution - 1) * (resolution - 1) * 2;
+
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mMaterialIndex = 0;
+    mesh->mNumVertices = vertexCount;
+    mesh->mVertices = new aiVector3D[vertexCount];
+    mesh->mNormals = new aiVector3D[vertexCount];
+    mesh->mTangents = new aiVector3D[vertexCount];
+    mesh->mBitangents = new aiVector3D[vertexCount];
+    mesh->mTextureCoords[0] = new aiVector3D[vertexCount];
+    mesh->mNumUVComponents[0] = 2;
+
+    for (unsigned int y = 0; y < resolution; y++)
+    {
+      for (unsigned int x = 0; x < resolution; x++)
+      {
+        unsigned int i = y * resolution + x;
+        float u = x / float(resolution - 1);
+        float v = y / float(resolution - 1);
+        float h = 0.1f * std::sin(u * 12.0f) * std::cos(v * 9.0f) + jitter(rng);
+        mesh->mVertices[i] = aiVector3D(u * 2.0f - 1.0f + offset, h, v * 2.0f - 1.0f);
+        mesh->mNormals[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+        mesh->mTangents[i] = aiVector3D(1.0f, 0.0f, 0.0f);
+        mesh->mBitangents[i] = aiVector3D(0.0f, 0.0f, 1.0f);
+        mesh->mTextureCoords[0][i] = aiVector3D(u, v, 0.0f);
+      }
+    }
+
+    mesh->mNumFaces = faceCount;
+    mesh->mFaces = new aiFace[faceCount];
+    unsigned int f = 0;
+    for (unsigned int y = 0; y + 1 < resolution; y++)
+    {
+      for (unsigned int x = 0; x + 1 < resolution; x++)
+      {
+        unsigned int i0 = y * resolution + x;
+        unsigned int i1 = i0 + 1;
+        unsigned int i2 = i0 + resolution;
+        unsigned int i3 = i2 + 1;
+        unsigned int quad[2][3] = {{i0, i2, i1}, {i1, i2, i3}};
+        for (auto &tri : quad)
+        {
+          aiFace &face = mesh->mFaces[f++];
+          face.mNumIndices = 3;
+          face.mIndices = new unsigned int[3]{tri[0], tri[1], tri[2]};
+        }
+      }
+    }
+    return mesh;
+  }
+
+  aiScene *createGridScene(unsigned int meshCount, unsigned int resolution)
+  {
+    std::mt19937 rng(kSeed);
+    aiScene *scene = new aiScene();
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial *[1]{new aiMaterial()};
+    scene->mNumMeshes = meshCount;
+    scene->mMeshes = new aiMesh *[meshCount];
+    scene->mRootNode = new aiNode();
+    scene->mRootNode->mNumMeshes = meshCount;
+    scene->mRootNode->mMeshes = new unsigned int[meshCount];
+    for (unsigned int i = 0; i < meshCount; i++)
+    {
+      scene->mMeshes[i] = createGridMesh(resolution, 2.5f * i, rng);
+      scene->mRootNode->mMeshes[i] = i;
+    }
+    return scene;
+  }
+}
+
+// 访问 Model 的私有加载步骤
+struct ModelBench
+{
+  static void run(BenchRunner &runner)
+  {
+    std::unique_ptr<aiScene> scene(createGridScene(8, 256));
+    uint64_t sceneVertices = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+      sceneVertices += scene->mMeshes[i]->mNumVertices;
+
+    Model model;
+    runner.run("model_calculate_model_bounds", 20, [&](uint64_t n)
+               {
+                 for (uint64_t i = 0; i < n; i++)
+                 {
+                   model.calculate_model_bounds(scene.get());
+                   consume(model.model_scale_factor);
+                 } },
+               double(sceneVertices), "vertices");
+
+    // process_mesh 包含GL缓冲上传；另外单独统计其中的顶点转换耗时
+    aiMesh *mesh = scene->mMeshes[0];
+    std::vector<double> convertMs;
+    runner.run("model_process_mesh", 10, [&](uint64_t n)
+               {
+                 for (uint64_t i = 0; i < n; i++)
+                 {
+                   model.load_report_.meshes.clear();
+                   Mesh result = model.process_mesh(mesh, scene.get());
+                   convertMs.push_back(model.load_report_.meshes.back().convertMs);
+                   consume(static_cast<float>(result.vertices.size()));
+                   result.releaseGL();
+                 } },
+               double(mesh->mNumVertices), "vertices");
+    if (!convertMs.empty())
+    {
+      std::sort(convertMs.begin(), convertMs.end());
+      std::ostringstream fields;
+      fields.setf(std::ios::fixed);
+      fields.precision(2);
+      double median = convertMs[convertMs.size() / 2];
+      fields << "\"samples\": " << convertMs.size() << ", \"median_ns\": " << median * 1.0e6
+             << ", \"vertices_per_second\": " << mesh->mNumVertices / (median / 1000.0);
+      runner.record("model_process_mesh_convert", fields.str());
+    }
+
+    runner.run("model_create_bidirectional_axis", 200, [&](uint64_t n)
+               {
+                 for (uint64_t i = 0; i < n; i++)
+                 {
+                   Mesh axis = model.createBidirectionalAxis(glm::vec3(1.0f, 0.0f, 0.0f), 2.5f, 0.01f, 0.03f,
+                                                             glm::vec3(1.0f, 0.0f, 0.0f));
+                   consume(static_cast<float>(axis.vertices.size()));
+                   axis.releaseGL();
+                 } });
+
+    // BVH：构建耗时与单线程射线吞吐
+    if (runner.selected("bvh"))
+    {
+      std::vector<glm::vec3> positions;
+      std::vector<uint32_t> indices;
+      for (unsigned int m = 0; m < scene->mNumMeshes; m++)
+      {
+        aiMesh *src = scene->mMeshes[m];
+        uint32_t base = static_cast<uint32_t>(positions.size());
+        for (unsigned int i = 0; i < src->mNumVertices; i++)
+          positions.emplace_back(src->mVertices[i].x, src->mVertices[i].y, src->mVertices[i].z);
+        for (unsigned int i = 0; i < src->mNumFaces; i++)
+          for (unsigned int j = 0; j < 3; j++)
+            indices.push_back(base + src->mFaces[i].mIndices[j]);
+      }
+
+      Bvh bvh;
+      bvh.build(positions, indices);
+      std::ostringstream fields;
+      fields.setf(std::ios::fixed);
+      fields.precision(2);
+      fields << "\"triangles\": " << bvh.triangleCount() << ", \"nodes\": " << bvh.nodeCount()
+             << ", \"memory_bytes\": " << bvh.memoryBytes() << ", \"build_ms\": " << bvh.buildMs();
+      runner.record("bvh_build", fields.str());
+
+      fields.str("");
+      fields << "\"rays\": 100000, \"rays_per_second\": " << bvh.benchmarkRays(100000, kSeed);
+      runner.record("bvh_rays", fields.str());
+    }
+  }
+};
+
+static void benchTrackball(BenchRunner &runner)
+{
+  std::mt19937 rng(kSeed);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::vector<glm::vec2> coords(4096);
+  for (glm::vec2 &c : coords)
+    c = glm::vec2(unit(rng), unit(rng));
+
+  Core core;
+  runner.run("trackball_map_to_sphere", 1000000, [&](uint64_t n)
+             {
+               float sum = 0.0f;
+               for (uint64_t i = 0; i < n; i++)
+                 sum += core.mapToSphere(coords[i & 4095], 0.8f).z;
+               consume(sum); });
+
+  // 一次按下后连续拖拽：每次迭代为一帧鼠标输入
+  const glm::vec2 displaySize(1280.0f, 800.0f);
+  std::vector<MouseSample> drag(4096);
+  glm::vec2 pos = displaySize * 0.5f;
+  std::normal_distribution<float> step(0.0f, 6.0f);
+  for (MouseSample &sample : drag)
+  {
+    pos = glm::clamp(pos + glm::vec2(step(rng), step(rng)), glm::vec2(0.0f), displaySize);
+    sample.position = pos;
+    sample.displaySize = displaySize;
+    sample.dragging = true;
+  }
+  drag[0].clicked = true;
+  drag[0].dragging = false;
+
+  runner.run("trackball_drag_update", 200000, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+                 core.applyMouseInput(drag[i & 4095]); });
+
+  // 主线程发布相机状态（渲染线程模式）：另一线程持续取最新值时，发布不应等待
+  TripleBuffer<FrameView> views;
+  std::atomic<bool> consuming{true};
+  std::thread consumer([&]
+                       {
+                         float sum = 0.0f;
+                         while (consuming.load(std::memory_order_relaxed))
+                         {
+                           if (views.acquire())
+                             sum += views.readBuffer().position.x;
+                         }
+                         consume(sum); });
+  runner.run("camera_handoff_publish", 1000000, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 FrameView &view = views.writeBuffer();
+                 view.position = glm::vec3(static_cast<float>(i), 0.0f, 3.0f);
+                 view.view = glm::lookAt(view.position, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+                 views.publish();
+               } });
+  consuming.store(false);
+  consumer.join();
+}
+
+static void benchShaderUniforms(BenchRunner &runner)
+{
+  Shader shader(BENCH_SOURCE_DIR "/glsl/vertex.glsl", BENCH_SOURCE_DIR "/glsl/fragment.glsl");
+  shader.use();
+
+  glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1280.0f / 800.0f, 0.1f, 100.0f);
+  glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  glm::mat4 model(1.0f);
+
+  // 与 Core::render 每帧设置的 uniform 相同
+  runner.run("shader_frame_uniforms", 20000, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 shader.setMat4("projection", projection);
+                 shader.setMat4("view", view);
+                 shader.setMat4("model", model);
+                 shader.setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
+                 shader.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+                 shader.setVec3("lightPos", glm::vec3(1.2f, 1.0f, 2.0f));
+                 shader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 3.0f));
+               }
+               glFinish(); },
+             7.0, "uniforms");
+
+  glDeleteProgram(shader.ID);
+}
+
+// 骨骼动画求值：64个节点的骨骼链，每个节点一条30个关键帧的通道，逐副本求姿态与骨骼矩阵
+static void benchAnimation(BenchRunner &runner)
+{
+  constexpr uint32_t kBones = 64;
+  constexpr uint32_t kKeys = 30;
+  constexpr uint32_t kCopies = 32;
+  std::mt19937 rng(kSeed);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  SceneGraph graph;
+  uint32_t parent = SceneGraph::kNoParent;
+  for (uint32_t i = 0; i < kBones; i++)
+    parent = graph.addNode(parent, "bone" + std::to_string(i), glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.1f, 0.0f)));
+  graph.update();
+
+  Animation::Clip clip;
+  clip.name = "bench";
+  clip.duration = 1.0f;
+  Animation::Skin skin;
+  for (uint32_t i = 0; i < kBones; i++)
+  {
+    Animation::Channel channel;
+    channel.node = i;
+    channel.positionFirst = channel.rotationFirst = channel.scaleFirst = i * kKeys;
+    channel.positionCount = channel.rotationCount = channel.scaleCount = kKeys;
+    for (uint32_t k = 0; k < kKeys; k++)
+    {
+      float time = k / float(kKeys - 1);
+      clip.positionTimes.push_back(time);
+      clip.positions.push_back(glm::vec3(0.0f, 0.1f, 0.0f) + 0.01f * glm::vec3(unit(rng), unit(rng), unit(rng)));
+      clip.rotationTimes.push_back(time);
+      clip.rotations.push_back(glm::normalize(glm::vec4(unit(rng), unit(rng), unit(rng), 4.0f)));
+      clip.scaleTimes.push_back(time);
+      clip.scales.push_back(glm::vec3(1.0f));
+    }
+    clip.channels.push_back(channel);
+    skin.nodes.push_back(i);
+    skin.offsets.push_back(glm::inverse(graph.world(i)));
+  }
+  Animation animation;
+  animation.addClip(std::move(clip), graph.nodeCount());
+
+  Animation::Scratch scratch;
+  std::vector<glm::mat4> world;
+  std::vector<glm::mat4> palette(kBones);
+  runner.run("animation_evaluate_crowd", 2000, [&](uint64_t n)
+             {
+               float sum = 0.0f;
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 for (uint32_t c = 0; c < kCopies; c++)
+                 {
+                   animation.evaluate(graph, 0, (i * kCopies + c) * 0.0137f, world, scratch);
+                   Animation::skinPalette(skin, 0, world, palette.data());
+                   sum += palette[kBones - 1][3].x;
+                 }
+               }
+               consume(sum); },
+             double(kCopies) * kBones, "bones");
+}
+
+// 帧准备与提交：串行执行与双缓冲流水线（工作线程准备下一帧）的每帧耗时
+static void benchFramePipeline(BenchRunner &runner)
+{
+  if (!runner.selected("frame_"))
+    return;
+
+  StressSceneParams params;
+  params.meshCount = 4096;
+  params.trianglesPerMesh = 200;
+  params.textureSize = 0;
+  std::unique_ptr<aiScene> scene = createStressScene(params);
+  ModelLoadOptions options;
+  options.retention = MeshRetention::None;
+  Model model(scene.get(), params.toString(), false, false, false, options);
+
+  Shader shader(BENCH_SOURCE_DIR "/glsl/vertex.glsl", BENCH_SOURCE_DIR "/glsl/fragment.glsl");
+  shader.use();
+  FramePacket packets[2];
+  for (FramePacket &packet : packets)
+  {
+    packet.cull = true;
+    packet.projection = glm::perspective(glm::radians(45.0f), 1280.0f / 800.0f, 0.1f, 100.0f);
+    packet.view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+  // 每帧移动一个节点，使帧准备包含场景图更新
+  uint32_t node = static_cast<uint32_t>(model.sceneGraph().nodeCount() - 1);
+  auto touchNode = [&](uint64_t frame)
+  {
+    model.setNodeTransform(node, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.001f * (frame & 63), 0.0f)));
+  };
+
+  runner.run("frame_serial", 200, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 touchNode(i);
+                 model.prepareFrame(packets[0]);
+                 model.submitFrame(packets[0], &shader);
+               }
+               glFinish(); },
+             1.0, "frames");
+
+  FramePipeline pipeline;
+  runner.run("frame_pipelined", 200, [&](uint64_t n)
+             {
+               int current = 0;
+               model.prepareFrame(packets[current]);
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 touchNode(i);
+                 FramePacket &next = packets[1 - current];
+                 pipeline.kick([&model, &next]
+                               { model.prepareFrame(next); });
+                 model.submitFrame(packets[current], &shader);
+                 pipeline.wait();
+                 current = 1 - current;
+               }
+               glFinish(); },
+             1.0, "frames");
+
+  std::ostringstream fields;
+  fields.setf(std::ios::fixed);
+  fields.precision(3);
+  fields << "\"instances\": " << model.instances().size() << ", \"prepare_ms\": " << packets[0].prepareMs
+         << ", \"culled\": " << packets[0].culled;
+  runner.record("frame_prepare", fields.str());
+  glDeleteProgram(shader.ID);
+}
+
+// GL任务队列：多个工作线程投递小任务、一个线程执行，对比加锁的 std::list<std::function>
+static void benchTaskQueue(BenchRunner &runner)
+{
+  if (!runner.selected("task_queue"))
+    return;
+
+  constexpr int kProducers = 4;
+  constexpr uint64_t kTasksPerProducer = 4096;
+  constexpr uint64_t kTasks = kProducers * kTasksPerProducer;
+
+  GlTaskQueue &queue = GlTaskQueue::get_instance();
+  float budget = queue.budgetMs();
+  queue.setBudgetMs(1000.0f);
+  runner.run("task_queue_mpsc", 20, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 uint64_t executed = 0;
+                 std::vector<std::thread> producers;
+                 for (int p = 0; p < kProducers; p++)
+                   producers.emplace_back([&queue, &executed]
+                                          {
+                                            for (uint64_t t = 0; t < kTasksPerProducer; t++)
+                                              queue.post([&executed]
+                                                         { executed++; });
+                                          });
+                 while (executed < kTasks)
+                   queue.run();
+                 for (std::thread &producer : producers)
+                   producer.join();
+               }
+               consume(static_cast<float>(queue.stats().totalExecuted)); },
+             double(kTasks), "tasks");
+  queue.setBudgetMs(budget);
+
+  runner.run("task_queue_mutex_list", 20, [&](uint64_t n)
+             {
+               for (uint64_t i = 0; i < n; i++)
+               {
+                 uint64_t executed = 0;
+                 std::mutex mutex;
+                 std::list<std::function<void()>> tasks;
+                 std::vector<std::thread> producers;
+                 for (int p = 0; p < kProducers; p++)
+                   producers.emplace_back([&tasks, &mutex, &executed]
+                                          {
+                                            for (uint64_t t = 0; t < kTasksPerProducer; t++)
+                                            {
+                                              std::lock_guard<std::mutex> lock(mutex);
+                                              tasks.emplace_back([&executed]
+                                                                 { executed++; });
+                                            }
+                                          });
+                 while (executed < kTasks)
+                 {
+                   std::list<std::function<void()>> batch;
+                   {
+                     std::lock_guard<std::mutex> lock(mutex);
+                     batch.swap(tasks);
+                   }
+                   for (auto &task : batch)
+                     task();
+                 }
+                 for (std::thread &producer : producers)
+                   producer.join();
+               } },
+             double(kTasks), "tasks");
+}
+
+int main(int argc, char **argv)
+{
+  BenchOptions options;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+      options.filter = argv[++i];
+    else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+      options.repeats = std::max(1, std::atoi(argv[++i]));
+    else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+      options.outPath = argv[++i];
+    else
+      std::cerr << "未知参数: " << argv[i] << std::endl;
+  }
+
+  // 隐藏窗口作为离屏GL上下文
+  if (!glfwInit())
+  {
+    std::cerr << "Fail initalize GLFW" << std::endl;
+    return 1;
+  }
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  GLFWwindow *window = glfwCreateWindow(64, 64, "gl_trackball_bench", nullptr, nullptr);
+  if (!window)
+  {
+    std::cerr << "Fail create GLFW window" << std::endl;
+    glfwTerminate();
+    return 1;
+  }
+  glfwMakeContextCurrent(window);
+  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+  {
+    std::cerr << "Fail initalize GLAD" << std::endl;
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 1;
+  }
+
+  // 基准中不需要分析器的作用域记录
+  Profiler::get_instance().setEnabled(false);
+
+  BenchRunner runner(options);
+  runner.meta();
+  benchTrackball(runner);
+  ModelBench::run(runner);
+  benchShaderUniforms(runner);
+  benchFramePipeline(runner);
+  benchAnimation(runner);
+  benchTaskQueue(runner);
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+  return 0;
+}
@@ -0,0 +1,431 @@
+#include "bvh.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <future>
+#include <random>
+#include <thread>
+
+namespace
+{
+  constexpr int kBinCount = 16;            // SAH分箱数量
+  constexpr uint32_t kMaxLeafSize = 8;     // 叶子最多三角形数
+  constexpr uint32_t kParallelMin = 32768; // 子树三角形数超过该值时并行构建
+
+  struct Bounds
+  {
+    glm::vec3 min = glm::vec3(FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    void grow(const glm::vec3 &p)
+    {
+      min = glm::min(min, p);
+      max = glm::max(max, p);
+    }
+    void grow(const Bounds &b)
+    {
+      min = glm::min(min, b.min);
+      max = glm::max(max, b.max);
+    }
+    float area() const
+    {
+      glm::vec3 e = max - min;
+      if (e.x < 0.0f)
+        return 0.0f;
+      return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+  };
+
+  struct Bin
+  {
+    Bounds bounds;
+    uint32_t count = 0;
+  };
+
+  // 构建期间的共享状态
+  struct BuildContext
+  {
+    std::vector<Bvh::Node> *nodes;
+    std::vector<Bounds> triBounds;
+    std::vector<glm::vec3> centroids;
+    std::vector<uint32_t> triIndex;
+    std::atomic<uint32_t> nodeCount{0};
+    std::atomic<int> maxDepth{0}; // 最深叶子的深度（根为0），决定遍历栈的大小
+    int parallelDepth = 0;
+  };
+
+  template <typename Fn>
+  void parallelFor(size_t count, unsigned threads, Fn fn)
+  {
+    if (threads <= 1 || count < kParallelMin)
+    {
+      fn(size_t(0), count);
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++)
+    {
+      size_t begin = t * chunk;
+      size_t end = std::min(count, begin + chunk);
+      if (begin >= end)
+        break;
+      workers.emplace_back(fn, begin, end);
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  void subdivide(BuildContext &ctx, uint32_t nodeIndex, uint32_t first, uint32_t count, int depth)
+  {
+    Bounds nodeBounds, centroidBounds;
+    for (uint32_t i = first; i < first + count; i++)
+    {
+      uint32_t tri = ctx.triIndex[i];
+      nodeBounds.grow(ctx.triBounds[tri]);
+      centroidBounds.grow(ctx.centroids[tri]);
+    }
+
+    int deepest = ctx.maxDepth.load(std::memory_order_relaxed);
+    while (depth > deepest && !ctx.maxDepth.compare_exchange_weak(deepest, depth, std::memory_order_relaxed))
+    {
+    }
+
+    Bvh::Node &node = (*ctx.nodes)[nodeIndex];
+    node.boundsMin = nodeBounds.min;
+    node.boundsMax = nodeBounds.max;
+    node.first = first;
+    node.count = count;
+    if (count <= 2)
+      return;
+
+    // 三个轴同时分箱
+    Bin bins[3][kBinCount];
+    glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    glm::vec3 scale;
+    for (int axis = 0; axis < 3; axis++)
+      scale[axis] = extent[axis] > 1e-12f ? kBinCount / extent[axis] : 0.0f;
+
+    for (uint32_t i = first; i < first + count; i++)
+    {
+      uint32_t tri = ctx.triIndex[i];
+      glm::vec3 c = ctx.centroids[tri];
+      for (int axis = 0; axis < 3; axis++)
+      {
+        int b = std::min(kBinCount - 1, int((c[axis] - centroidBounds.min[axis]) * scale[axis]));
+        bins[axis][b].count++;
+        bins[axis][b].bounds.grow(ctx.triBounds[tri]);
+      }
+    }
+
+    // 扫描所有分割平面，求SAH代价最小的分割
+    float bestCost = FLT_MAX;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      if (scale[axis] == 0.0f)
+        continue;
+
+      float leftArea[kBinCount - 1];
+      uint32_t leftCount[kBinCount - 1];
+      Bounds left;
+      uint32_t sum = 0;
+      for (int i = 0; i < kBinCount - 1; i++)
+      {
+        left.grow(bins[axis][i].bounds);
+        sum += bins[axis][i].count;
+        leftArea[i] = left.area();
+        leftCount[i] = sum;
+      }
+
+      Bounds right;
+      sum = 0;
+      for (int i = kBinCount - 1; i > 0; i--)
+      {
+        right.grow(bins[axis][i].bounds);
+        sum += bins[axis][i].count;
+        if (leftCount[i - 1] == 0 || sum == 0)
+          continue;
+        float cost = leftCount[i - 1] * leftArea[i - 1] + sum * right.area();
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = axis;
+          bestSplit = i;
+        }
+      }
+    }
+
+    float leafCost = count * nodeBounds.area();
+    if (bestAxis < 0 || (bestCost >= leafCost && count <= kMaxLeafSize))
+      return;
+
+    // 按分箱结果原地划分三角形
+    float splitMin = centroidBounds.min[bestAxis];
+    float splitScale = scale[bestAxis];
+    auto middle = std::partition(ctx.triIndex.begin() + first, ctx.triIndex.begin() + first + count,
+                                 [&](uint32_t tri)
+                                 {
+                                   int b = std::min(kBinCount - 1, int((ctx.centroids[tri][bestAxis] - splitMin) * splitScale));
+                                   return b < bestSplit;
+                                 });
+    uint32_t leftCount = static_cast<uint32_t>(middle - ctx.triIndex.begin()) - first;
+    if (leftCount == 0 || leftCount == count)
+      return;
+
+    uint32_t leftChild = ctx.nodeCount.fetch_add(2);
+    node.first = leftChild;
+    node.count = 0;
+
+    // 顶层的大子树交给其他线程并行构建
+    if (depth < ctx.parallelDepth && count > kParallelMin)
+    {
+      auto future = std::async(std::launch::async, subdivide, std::ref(ctx), leftChild, first, leftCount, depth + 1);
+      subdivide(ctx, leftChild + 1, first + leftCount, count - leftCount, depth + 1);
+      future.get();
+    }
+    else
+    {
+      subdivide(ctx, leftChild, first, leftCount, depth + 1);
+      subdivide(ctx, leftChild + 1, first + leftCount, count - leftCount, depth + 1);
+    }
+  }
+
+  // 射线与包围盒求交，返回进入距离，未命中返回 FLT_MAX
+  inline float intersectBounds(const glm::vec3 &origin, const glm::vec3 &invDir, const glm::vec3 &bmin, const glm::vec3 &bmax, float tMax)
+  {
+    float tx1 = (bmin.x - origin.x) * invDir.x, tx2 = (bmax.x - origin.x) * invDir.x;
+    float tmin = std::min(tx1, tx2), tmax = std::max(tx1, tx2);
+    float ty1 = (bmin.y - origin.y) * invDir.y, ty2 = (bmax.y - origin.y) * invDir.y;
+    tmin = std::max(tmin, std::min(ty1, ty2)), tmax = std::min(tmax, std::max(ty1, ty2));
+    float tz1 = (bmin.z - origin.z) * invDir.z, tz2 = (bmax.z - origin.z) * invDir.z;
+    tmin = std::max(tmin, std::min(tz1, tz2)), tmax = std::min(tmax, std::max(tz1, tz2));
+    if (tmax >= tmin && tmin < tMax && tmax > 0.0f)
+      return tmin;
+    return FLT_MAX;
+  }
+}
+
+void Bvh::build(std::vector<glm::vec3> positions, std::vector<uint32_t> indices, unsigned threads)
+{
+  auto start = std::chrono::steady_clock::now();
+  clear();
+
+  positions_ = std::move(positions);
+  uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+  if (triCount == 0)
+    return;
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  BuildContext ctx;
+  ctx.nodes = &nodes_;
+  ctx.triBounds.resize(triCount);
+  ctx.centroids.resize(triCount);
+  ctx.triIndex.resize(triCount);
+  nodes_.resize(size_t(triCount) * 2);
+
+  // 并行计算三角形包围盒与中心
+  parallelFor(triCount, threads, [&](size_t begin, size_t end)
+              {
+                for (size_t i = begin; i < end; i++)
+                {
+                  Bounds b;
+                  b.grow(positions_[indices[i * 3 + 0]]);
+                  b.grow(positions_[indices[i * 3 + 1]]);
+                  b.grow(positions_[indices[i * 3 + 2]]);
+                  ctx.triBounds[i] = b;
+                  ctx.centroids[i] = (b.min + b.max) * 0.5f;
+                  ctx.triIndex[i] = static_cast<uint32_t>(i);
+                } });
+
+  // 并行深度：让顶层子树数量覆盖所有线程
+  while ((1u << ctx.parallelDepth) < threads)
+    ctx.parallelDepth++;
+  ctx.parallelDepth++;
+
+  ctx.nodeCount = 1;
+  subdivide(ctx, 0, 0, triCount, 0);
+  nodeCount_ = ctx.nodeCount.load();
+  depth_ = ctx.maxDepth.load();
+  nodes_.resize(nodeCount_);
+  nodes_.shrink_to_fit();
+
+  // 按叶子顺序重排三角形索引，遍历时直接按区间访问
+  indices_.resize(indices.size());
+  parallelFor(triCount, threads, [&](size_t begin, size_t end)
+              {
+                for (size_t i = begin; i < end; i++)
+                {
+                  uint32_t tri = ctx.triIndex[i];
+                  indices_[i * 3 + 0] = indices[tri * 3 + 0];
+                  indices_[i * 3 + 1] = indices[tri * 3 + 1];
+                  indices_[i * 3 + 2] = indices[tri * 3 + 2];
+                } });
+
+  buildMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Bvh::clear()
+{
+  nodes_.clear();
+  positions_.clear();
+  indices_.clear();
+  nodeCount_ = 0;
+  depth_ = 0;
+  buildMs_ = 0.0;
+}
+
+size_t Bvh::memoryBytes() const
+{
+  return nodes_.capacity() * sizeof(Node) +
+         positions_.capacity() * sizeof(glm::vec3) +
+         indices_.capacity() * sizeof(uint32_t);
+}
+
+bool Bvh::intersect(const Ray &ray, RayHit &hit) const
+{
+  if (nodeCount_ == 0)
+    return false;
+
+  glm::vec3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+  float closest = FLT_MAX;
+  bool found = false;
+
+  // 每层最多留下一个待访问的兄弟节点，栈深不超过树深+1；退化的深树改用堆上的栈，不丢弃子树
+  constexpr int kLocalStack = 64;
+  uint32_t localStack[kLocalStack];
+  std::vector<uint32_t> heapStack;
+  uint32_t *stack = localStack;
+  if (depth_ + 2 > kLocalStack)
+  {
+    heapStack.resize(static_cast<size_t>(depth_) + 2);
+    stack = heapStack.data();
+  }
+  int stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while (stackSize > 0)
+  {
+    const Node &node = nodes_[stack[--stackSize]];
+    if (intersectBounds(ray.origin, invDir, node.boundsMin, node.boundsMax, closest) == FLT_MAX)
+      continue;
+
+    if (node.count > 0)
+    {
+      // Möller–Trumbore 三角形求交（双面）
+      for (uint32_t i = node.first; i < node.first + node.count; i++)
+      {
+        const glm::vec3 &v0 = positions_[indices_[i * 3 + 0]];
+        glm::vec3 e1 = positions_[indices_[i * 3 + 1]] - v0;
+        glm::vec3 e2 = positions_[indices_[i * 3 + 2]] - v0;
+        glm::vec3 p = glm::cross(ray.direction, e2);
+        float det = glm::dot(e1, p);
+        if (std::abs(det) < 1e-12f)
+          continue;
+        float invDet = 1.0f / det;
+        glm::vec3 s = ray.origin - v0;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f)
+          continue;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(ray.direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f)
+          continue;
+        float t = glm::dot(e2, q) * invDet;
+        if (t > 0.0f && t < closest)
+        {
+          closest = t;
+          hit.triangle = i;
+          found = true;
+        }
+      }
+      continue;
+    }
+
+    // 先访问较近的孩子
+    const Node &left = nodes_[node.first];
+    const Node &right = nodes_[node.first + 1];
+    float tLeft = intersectBounds(ray.origin, invDir, left.boundsMin, left.boundsMax, closest);
+    float tRight = intersectBounds(ray.origin, invDir, right.boundsMin, right.boundsMax, closest);
+    uint32_t near = node.first, far = node.first + 1;
+    if (tRight < tLeft)
+    {
+      std::swap(tLeft, tRight);
+      std::swap(near, far);
+    }
+    if (tRight != FLT_MAX)
+      stack[stackSize++] = far;
+    if (tLeft != FLT_MAX)
+      stack[stackSize++] = near;
+  }
+
+  if (found)
+  {
+    hit.t = closest;
+    hit.position = ray.origin + ray.direction * closest;
+  }
+  return found;
+}
+
+double Bvh::benchmarkRays(size_t rayCount, uint32_t seed) const
+{
+  if (nodeCount_ == 0 || rayCount == 0)
+    return 0.0;
+
+  const Node &root = nodes_[0];
+  glm::vec3 center = (root.boundsMin + root.boundsMax) * 0.5f;
+  glm::vec3 halfExtent = (root.boundsMax - root.boundsMin) * 0.5f;
+  float radius = glm::length(halfExtent) * 2.0f;
+
+  // 预先生成射线，计时只包含求交
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<Ray> rays(rayCount);
+  for (Ray &ray : rays)
+  {
+    glm::vec3 dir;
+    do
+    {
+      dir = glm::vec3(dist(rng), dist(rng), dist(rng));
+    } while (glm::length(dir) < 0.01f);
+    glm::vec3 origin = center + glm::normalize(dir) * radius;
+    glm::vec3 target = center + glm::vec3(dist(rng), dist(rng), dist(rng)) * halfExtent;
+    ray.origin = origin;
+    ray.direction = glm::normalize(target - origin);
+  }
+
+  size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const Ray &ray : rays)
+  {
+    RayHit hit;
+    if (intersect(ray, hit))
+      hits++;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  (void)hits;
+  return seconds > 0.0 ? rayCount / seconds : 0.0;
+}
+
+bool boxInFrustum(const glm::mat4 &m, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+{
+  glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+  glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+  glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+  glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+  const glm::vec4 planes[6] = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2};
+  for (const glm::vec4 &plane : planes)
+  {
+    // 取包围盒在平面法线方向上最远的顶点
+    glm::vec3 p(plane.x >= 0.0f ? boundsMax.x : boundsMin.x, plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
+                plane.z >= 0.0f ? boundsMax.z : boundsMin.z);
+    if (plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 0.0f)
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,62 @@
+#ifndef __BVH_H
+#define __BVH_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct Ray
+{
+  glm::vec3 origin;
+  glm::vec3 direction; // 单位向量
+};
+
+// 包围盒是否与视锥相交：由矩阵提取六个裁剪平面（Gribb-Hartmann），clip 把包围盒所在坐标系变换到裁剪空间
+bool boxInFrustum(const glm::mat4 &clip, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax);
+
+struct RayHit
+{
+  float t = 0.0f;         // 沿射线的距离
+  uint32_t triangle = 0;  // 命中的三角形序号（BVH排序后的顺序）
+  glm::vec3 position;     // 命中点
+};
+
+// 三角形包围体层次结构（分箱SAH构建，顶层子树并行构建）
+class Bvh
+{
+public:
+  // 32字节节点：count > 0 为叶子，first 指向三角形；否则 first 为左孩子，右孩子紧随其后
+  struct Node
+  {
+    glm::vec3 boundsMin;
+    uint32_t first;
+    glm::vec3 boundsMax;
+    uint32_t count;
+  };
+
+private:
+  std::vector<Node> nodes_;
+  std::vector<glm::vec3> positions_; // 顶点位置
+  std::vector<uint32_t> indices_;    // 三角形索引，按叶子顺序重排
+  uint32_t nodeCount_ = 0;
+  int depth_ = 0; // 树深（根为0）
+  double buildMs_ = 0.0;
+
+public:
+  // 由顶点位置和三角形索引构建；threads 为 0 时使用硬件线程数
+  void build(std::vector<glm::vec3> positions, std::vector<uint32_t> indices, unsigned threads = 0);
+  void clear();
+
+  bool empty() const { return nodeCount_ == 0; }
+  bool intersect(const Ray &ray, RayHit &hit) const;
+
+  size_t triangleCount() const { return indices_.size() / 3; }
+  size_t nodeCount() const { return nodeCount_; }
+  size_t memoryBytes() const;
+  double buildMs() const { return buildMs_; }
+
+  // 从包围球外随机向模型内发射射线，返回每秒射线数
+  double benchmarkRays(size_t rayCount, uint32_t seed = 1) const;
+};
+
+#endif
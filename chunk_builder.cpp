@@ -0,0 +1,302 @@
+// gl_trackball_chunk：把大模型离线划分为空间块，写入分页的 .chunks 文件，供应用以 out-of-core 方式流式加载
+//
+//   gl_trackball_chunk <模型文件> <输出.chunks> [--triangles <每块目标三角形数>] [--proxy <代理网格分辨率>]
+//
+// 节点变换预先烘焙到顶点中；三角形按重心落入的网格格子分块，每块内部重新建立局部索引。
+// 代理网格由顶点聚类生成（模型包围盒按代理分辨率划分，同一格子的顶点合并为一个），
+// 其三角形与细节三角形归入同一个块。
+// 离线步骤需要一次性载入整个场景（Assimp的限制），应在内存足够的机器上运行；运行时只需块表与代理网格常驻
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <glm/glm.hpp>
+#include "chunk_format.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <unordered_map>
+
+namespace
+{
+  struct Cell
+  {
+    std::vector<chunkfile::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::unordered_map<uint32_t, uint32_t> remap; // 当前网格的源顶点 -> 块内顶点
+    std::set<std::array<uint32_t, 3>> proxyTriangles;
+    glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+    glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+  };
+
+  // 顶点聚类：每个格子累加位置与法线，最后取平均
+  struct Cluster
+  {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+    float texCoords[2] = {0.0f, 0.0f};
+    uint32_t count = 0;
+  };
+
+  class ChunkBuilder
+  {
+  private:
+    glm::vec3 boundsMin_ = glm::vec3(FLT_MAX), boundsMax_ = glm::vec3(-FLT_MAX);
+    std::array<uint32_t, 3> grid_ = {1, 1, 1};
+    uint32_t proxyResolution_ = 128;
+    std::unordered_map<uint32_t, Cell> cells_;
+    std::unordered_map<uint64_t, uint32_t> clusterIndex_;
+    std::vector<Cluster> clusters_;
+    uint64_t triangles_ = 0;
+
+    std::array<uint32_t, 3> gridCell(const glm::vec3 &p, const std::array<uint32_t, 3> &size) const
+    {
+      std::array<uint32_t, 3> cell;
+      for (int i = 0; i < 3; i++)
+      {
+        float t = (p[i] - boundsMin_[i]) / std::max(boundsMax_[i] - boundsMin_[i], 1e-6f) * size[i];
+        cell[i] = std::min(static_cast<uint32_t>(std::max(t, 0.0f)), size[i] - 1);
+      }
+      return cell;
+    }
+
+    uint32_t cluster(const aiMesh *mesh, uint32_t vertex)
+    {
+      glm::vec3 p(mesh->mVertices[vertex].x, mesh->mVertices[vertex].y, mesh->mVertices[vertex].z);
+      std::array<uint32_t, 3> c = gridCell(p, {proxyResolution_, proxyResolution_, proxyResolution_});
+      uint64_t key = (uint64_t(c[2]) * proxyResolution_ + c[1]) * proxyResolution_ + c[0];
+      auto inserted = clusterIndex_.emplace(key, static_cast<uint32_t>(clusters_.size()));
+      if (inserted.second)
+        clusters_.emplace_back();
+      Cluster &cluster = clusters_[inserted.first->second];
+      cluster.position += p;
+      if (mesh->HasNormals())
+        cluster.normal += glm::vec3(mesh->mNormals[vertex].x, mesh->mNormals[vertex].y, mesh->mNormals[vertex].z);
+      if (mesh->mTextureCoords[0])
+      {
+        cluster.texCoords[0] += mesh->mTextureCoords[0][vertex].x;
+        cluster.texCoords[1] += mesh->mTextureCoords[0][vertex].y;
+      }
+      cluster.count++;
+      return inserted.first->second;
+    }
+
+    static chunkfile::Vertex convert(const aiMesh *mesh, uint32_t vertex)
+    {
+      chunkfile::Vertex out = {};
+      out.position[0] = mesh->mVertices[vertex].x;
+      out.position[1] = mesh->mVertices[vertex].y;
+      out.position[2] = mesh->mVertices[vertex].z;
+      if (mesh->HasNormals())
+      {
+        out.normal[0] = mesh->mNormals[vertex].x;
+        out.normal[1] = mesh->mNormals[vertex].y;
+        out.normal[2] = mesh->mNormals[vertex].z;
+      }
+      if (mesh->mTextureCoords[0])
+      {
+        out.texCoords[0] = mesh->mTextureCoords[0][vertex].x;
+        out.texCoords[1] = mesh->mTextureCoords[0][vertex].y;
+      }
+      return out;
+    }
+
+  public:
+    explicit ChunkBuilder(uint32_t proxyResolution) : proxyResolution_(std::max(2u, proxyResolution)) {}
+
+    // 按包围盒与目标块大小确定网格划分：格子尽量接近立方体
+    void plan(const aiScene *scene, uint64_t trianglesPerChunk)
+    {
+      uint64_t triangles = 0;
+      for (unsigned int m = 0; m < scene->mNumMeshes; m++)
+      {
+        const aiMesh *mesh = scene->mMeshes[m];
+        for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+        {
+          glm::vec3 p(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+          boundsMin_ = glm::min(boundsMin_, p);
+          boundsMax_ = glm::max(boundsMax_, p);
+        }
+        triangles += mesh->mNumFaces;
+      }
+      glm::vec3 extent = glm::max(boundsMax_ - boundsMin_, glm::vec3(1e-6f));
+      double cellCount = std::max(1.0, double(triangles) / double(std::max<uint64_t>(1, trianglesPerChunk)));
+      double cellSize = std::cbrt(double(extent.x) * extent.y * extent.z / cellCount);
+      for (int i = 0; i < 3; i++)
+        grid_[i] = static_cast<uint32_t>(std::clamp(std::ceil(extent[i] / cellSize), 1.0, 1024.0));
+    }
+
+    void add(const aiMesh *mesh)
+    {
+      std::vector<uint32_t> vertexClusters(mesh->mNumVertices);
+      for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+        vertexClusters[v] = cluster(mesh, v);
+
+      for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+      {
+        const aiFace &face = mesh->mFaces[f];
+        if (face.mNumIndices != 3)
+          continue;
+        glm::vec3 centroid(0.0f);
+        for (int k = 0; k < 3; k++)
+        {
+          const aiVector3D &p = mesh->mVertices[face.mIndices[k]];
+          centroid += glm::vec3(p.x, p.y, p.z) / 3.0f;
+        }
+        std::array<uint32_t, 3> c = gridCell(centroid, grid_);
+        Cell &cell = cells_[(c[2] * grid_[1] + c[1]) * grid_[0] + c[0]];
+        for (int k = 0; k < 3; k++)
+        {
+          uint32_t source = face.mIndices[k];
+          auto inserted = cell.remap.emplace(source, static_cast<uint32_t>(cell.vertices.size()));
+          if (inserted.second)
+          {
+            cell.vertices.push_back(convert(mesh, source));
+            const float *p = cell.vertices.back().position;
+            cell.boundsMin = glm::min(cell.boundsMin, glm::vec3(p[0], p[1], p[2]));
+            cell.boundsMax = glm::max(cell.boundsMax, glm::vec3(p[0], p[1], p[2]));
+          }
+          cell.indices.push_back(inserted.first->second);
+        }
+        triangles_++;
+
+        // 三个顶点落入不同聚类的三角形保留在代理网格中（顶点按升序保存以去重，绕序另行记录）
+        uint32_t a = vertexClusters[face.mIndices[0]], b = vertexClusters[face.mIndices[1]],
+                 d = vertexClusters[face.mIndices[2]];
+        if (a != b && b != d && a != d)
+        {
+          // 旋转使最小下标在前，保持绕序
+          while (a > b || a > d)
+          {
+            uint32_t t = a;
+            a = b;
+            b = d;
+            d = t;
+          }
+          cell.proxyTriangles.insert({a, b, d});
+        }
+      }
+      for (auto &item : cells_)
+        item.second.remap.clear();
+    }
+
+    void finish(chunkfile::Index &index, std::vector<std::vector<uint8_t>> &chunkData)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        index.header.gridSize[i] = grid_[i];
+        index.header.boundsMin[i] = boundsMin_[i];
+        index.header.boundsMax[i] = boundsMax_[i];
+      }
+      index.header.triangleCount = triangles_;
+
+      for (const Cluster &cluster : clusters_)
+      {
+        chunkfile::Vertex vertex = {};
+        float inv = 1.0f / std::max(1u, cluster.count);
+        glm::vec3 normal = glm::length(cluster.normal) > 0.0f ? glm::normalize(cluster.normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+        for (int i = 0; i < 3; i++)
+        {
+          vertex.position[i] = cluster.position[i] * inv;
+          vertex.normal[i] = normal[i];
+        }
+        vertex.texCoords[0] = cluster.texCoords[0] * inv;
+        vertex.texCoords[1] = cluster.texCoords[1] * inv;
+        index.proxyVertices.push_back(vertex);
+      }
+
+      // 按格子顺序输出，相邻的块在文件中也相邻
+      std::vector<uint32_t> keys;
+      for (const auto &item : cells_)
+        keys.push_back(item.first);
+      std::sort(keys.begin(), keys.end());
+      for (uint32_t key : keys)
+      {
+        Cell &cell = cells_[key];
+        chunkfile::ChunkEntry entry = {};
+        for (int i = 0; i < 3; i++)
+        {
+          entry.boundsMin[i] = cell.boundsMin[i];
+          entry.boundsMax[i] = cell.boundsMax[i];
+        }
+        entry.vertexCount = static_cast<uint32_t>(cell.vertices.size());
+        entry.indexCount = static_cast<uint32_t>(cell.indices.size());
+        entry.proxyFirstIndex = static_cast<uint32_t>(index.proxyIndices.size());
+        for (const std::array<uint32_t, 3> &triangle : cell.proxyTriangles)
+          index.proxyIndices.insert(index.proxyIndices.end(), triangle.begin(), triangle.end());
+        entry.proxyIndexCount = static_cast<uint32_t>(index.proxyIndices.size()) - entry.proxyFirstIndex;
+
+        std::vector<uint8_t> data(entry.dataBytes());
+        std::memcpy(data.data(), cell.vertices.data(), cell.vertices.size() * sizeof(chunkfile::Vertex));
+        std::memcpy(data.data() + cell.vertices.size() * sizeof(chunkfile::Vertex), cell.indices.data(),
+                    cell.indices.size() * sizeof(uint32_t));
+        index.chunks.push_back(entry);
+        chunkData.push_back(std::move(data));
+        cell = Cell(); // 写入副本后立即释放
+      }
+    }
+
+    const std::array<uint32_t, 3> &grid() const { return grid_; }
+  };
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    std::cerr << "用法: " << argv[0] << " <模型文件> <输出.chunks> [--triangles <每块目标三角形数>] [--proxy <代理网格分辨率>]"
+              << std::endl;
+    return 1;
+  }
+  const char *inputPath = argv[1];
+  const char *outputPath = argv[2];
+  uint64_t trianglesPerChunk = 65536;
+  uint32_t proxyResolution = 128;
+  for (int i = 3; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--triangles") == 0 && i + 1 < argc)
+      trianglesPerChunk = std::strtoull(argv[++i], nullptr, 10);
+    else if (std::strcmp(argv[i], "--proxy") == 0 && i + 1 < argc)
+      proxyResolution = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    else
+      std::cerr << "未知参数: " << argv[i] << std::endl;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  Assimp::Importer importer;
+  const aiScene *scene = importer.ReadFile(inputPath, aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                                                          aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices |
+                                                          aiProcess_PreTransformVertices);
+  if (!scene || !scene->mRootNode)
+  {
+    std::cerr << "无法读取模型: " << importer.GetErrorString() << std::endl;
+    return 1;
+  }
+
+  ChunkBuilder builder(proxyResolution);
+  builder.plan(scene, trianglesPerChunk);
+  for (unsigned int m = 0; m < scene->mNumMeshes; m++)
+    builder.add(scene->mMeshes[m]);
+  importer.FreeScene();
+
+  chunkfile::Index index;
+  std::vector<std::vector<uint8_t>> chunkData;
+  builder.finish(index, chunkData);
+  if (!chunkfile::writeFile(outputPath, index, chunkData))
+  {
+    std::cerr << "无法写入: " << outputPath << std::endl;
+    return 1;
+  }
+
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  const std::array<uint32_t, 3> &grid = builder.grid();
+  std::cout << "{\"chunks\": " << index.chunks.size() << ", \"grid\": [" << grid[0] << ", " << grid[1] << ", " << grid[2]
+            << "], \"triangles\": " << index.header.triangleCount
+            << ", \"proxy_triangles\": " << index.proxyIndices.size() / 3 << ", \"ms\": " << ms << "}" << std::endl;
+  return 0;
+}
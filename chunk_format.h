@@ -0,0 +1,181 @@
+#ifndef __CHUNK_FORMAT_H
+#define __CHUNK_FORMAT_H
+
+// 分块模型文件（.chunks）的格式定义，供离线分块工具与运行时的 ChunkedModel 共用（不依赖GL与Assimp）
+//
+// 布局：Header | ChunkEntry[chunkCount] | 代理网格顶点 | 代理网格索引 | 各块数据
+// 每块数据从页对齐的偏移开始，为 Vertex[vertexCount] 后接 uint32_t[indexCount]（块内局部索引）。
+// 代理网格是整个模型的低精度版本，按块分段存放索引，细节块未驻留时绘制对应的分段
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace chunkfile
+{
+  constexpr char kMagic[8] = {'G', 'L', 'C', 'H', 'U', 'N', 'K', '1'};
+  constexpr uint64_t kPageSize = 4096;
+
+  struct Vertex
+  {
+    float position[3];
+    float normal[3];
+    float texCoords[2];
+  };
+  static_assert(sizeof(Vertex) == 32, "chunk vertex must be tightly packed");
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t chunkCount = 0;
+    uint32_t proxyVertexCount = 0;
+    uint32_t proxyIndexCount = 0;
+    uint32_t gridSize[3] = {0, 0, 0}; // 空间网格的划分数（空的格子不生成块）
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    uint64_t triangleCount = 0; // 所有块的三角形总数
+  };
+
+  struct ChunkEntry
+  {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t offset; // 块数据在文件中的偏移（页对齐）
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t proxyFirstIndex; // 该块在代理网格索引中的分段
+    uint32_t proxyIndexCount;
+
+    uint64_t dataBytes() const { return uint64_t(vertexCount) * sizeof(Vertex) + uint64_t(indexCount) * sizeof(uint32_t); }
+  };
+
+  inline uint64_t alignToPage(uint64_t offset) { return (offset + kPageSize - 1) / kPageSize * kPageSize; }
+
+  // 文件中常驻内存的部分：头部、块表与代理网格
+  struct Index
+  {
+    Header header;
+    std::vector<ChunkEntry> chunks;
+    std::vector<Vertex> proxyVertices;
+    std::vector<uint32_t> proxyIndices;
+  };
+
+  // 读取头部、块表与代理网格。计数、偏移与索引都先对照文件长度和顶点数检查，
+  // 截断或损坏的文件打印原因后返回 false，不会按错误的计数分配内存
+  inline bool readIndex(const std::string &path, Index &index)
+  {
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+      return false;
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(&index.header), sizeof(Header));
+    if (!file || std::memcmp(index.header.magic, kMagic, sizeof(kMagic)) != 0)
+    {
+      std::cout << "分块模型文件头无效: " << path << std::endl;
+      return false;
+    }
+
+    const Header &header = index.header;
+    uint64_t tableBytes = sizeof(Header) + uint64_t(header.chunkCount) * sizeof(ChunkEntry) +
+                          uint64_t(header.proxyVertexCount) * sizeof(Vertex) +
+                          uint64_t(header.proxyIndexCount) * sizeof(uint32_t);
+    if (tableBytes > fileSize)
+    {
+      std::cout << "分块模型文件被截断（块表与代理网格需要 " << tableBytes << " 字节，文件只有 " << fileSize
+                << " 字节）: " << path << std::endl;
+      return false;
+    }
+    index.chunks.resize(header.chunkCount);
+    index.proxyVertices.resize(header.proxyVertexCount);
+    index.proxyIndices.resize(header.proxyIndexCount);
+    file.read(reinterpret_cast<char *>(index.chunks.data()), index.chunks.size() * sizeof(ChunkEntry));
+    file.read(reinterpret_cast<char *>(index.proxyVertices.data()), index.proxyVertices.size() * sizeof(Vertex));
+    file.read(reinterpret_cast<char *>(index.proxyIndices.data()), index.proxyIndices.size() * sizeof(uint32_t));
+    if (!file)
+    {
+      std::cout << "无法读取分块模型的块表: " << path << std::endl;
+      return false;
+    }
+
+    for (size_t i = 0; i < index.chunks.size(); i++)
+    {
+      const ChunkEntry &chunk = index.chunks[i];
+      if (chunk.offset < tableBytes || chunk.offset > fileSize || chunk.dataBytes() > fileSize - chunk.offset)
+      {
+        std::cout << "分块模型的块 " << i << " 超出文件范围: " << path << std::endl;
+        return false;
+      }
+      if (uint64_t(chunk.proxyFirstIndex) + chunk.proxyIndexCount > header.proxyIndexCount)
+      {
+        std::cout << "分块模型的块 " << i << " 的代理网格分段越界: " << path << std::endl;
+        return false;
+      }
+    }
+    for (uint32_t vertex : index.proxyIndices)
+    {
+      if (vertex >= header.proxyVertexCount)
+      {
+        std::cout << "分块模型的代理网格索引越界: " << path << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // 检查一块数据（Vertex[vertexCount] 后接局部索引）的索引都落在本块的顶点范围内
+  inline bool validChunkData(const ChunkEntry &chunk, const std::vector<uint8_t> &data)
+  {
+    if (data.size() != chunk.dataBytes())
+      return false;
+    const uint8_t *indices = data.data() + uint64_t(chunk.vertexCount) * sizeof(Vertex);
+    for (uint32_t i = 0; i < chunk.indexCount; i++)
+    {
+      uint32_t vertex;
+      std::memcpy(&vertex, indices + uint64_t(i) * sizeof(uint32_t), sizeof(vertex));
+      if (vertex >= chunk.vertexCount)
+        return false;
+    }
+    return true;
+  }
+
+  inline bool writeFile(const std::string &path, Index &index, const std::vector<std::vector<uint8_t>> &chunkData)
+  {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      return false;
+
+    Header &header = index.header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.chunkCount = static_cast<uint32_t>(index.chunks.size());
+    header.proxyVertexCount = static_cast<uint32_t>(index.proxyVertices.size());
+    header.proxyIndexCount = static_cast<uint32_t>(index.proxyIndices.size());
+
+    uint64_t offset = sizeof(Header) + index.chunks.size() * sizeof(ChunkEntry) +
+                      index.proxyVertices.size() * sizeof(Vertex) + index.proxyIndices.size() * sizeof(uint32_t);
+    for (ChunkEntry &chunk : index.chunks)
+    {
+      offset = alignToPage(offset);
+      chunk.offset = offset;
+      offset += chunk.dataBytes();
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(index.chunks.data()), index.chunks.size() * sizeof(ChunkEntry));
+    file.write(reinterpret_cast<const char *>(index.proxyVertices.data()), index.proxyVertices.size() * sizeof(Vertex));
+    file.write(reinterpret_cast<const char *>(index.proxyIndices.data()), index.proxyIndices.size() * sizeof(uint32_t));
+    static const char padding[kPageSize] = {};
+    for (size_t i = 0; i < index.chunks.size(); i++)
+    {
+      uint64_t position = static_cast<uint64_t>(file.tellp());
+      file.write(padding, index.chunks[i].offset - position);
+      file.write(reinterpret_cast<const char *>(chunkData[i].data()), chunkData[i].size());
+    }
+    return static_cast<bool>(file);
+  }
+} // namespace chunkfile
+
+#endif
@@ -0,0 +1,393 @@
+#include "chunked_model.h"
+#include "bvh.h"
+#include "imgui.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+  // 与 Mesh 相同的顶点属性布局（位置0~2）
+  void setupVertexLayout()
+  {
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(chunkfile::Vertex), (void *)offsetof(chunkfile::Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(chunkfile::Vertex), (void *)offsetof(chunkfile::Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(chunkfile::Vertex), (void *)offsetof(chunkfile::Vertex, texCoords));
+  }
+} // namespace
+
+ChunkedModel::~ChunkedModel()
+{
+  release();
+}
+
+bool ChunkedModel::open(const std::string &path)
+{
+  release();
+  if (!chunkfile::readIndex(path, index_))
+  {
+    std::cout << "无法读取分块模型: " << path << std::endl;
+    return false;
+  }
+  path_ = path;
+
+  glm::vec3 boundsMin(index_.header.boundsMin[0], index_.header.boundsMin[1], index_.header.boundsMin[2]);
+  glm::vec3 boundsMax(index_.header.boundsMax[0], index_.header.boundsMax[1], index_.header.boundsMax[2]);
+  glm::vec3 size = boundsMax - boundsMin;
+  scale_ = 2.0f / std::max(1e-6f, std::max(size.x, std::max(size.y, size.z)));
+  normalize_ = glm::scale(glm::mat4(1.0f), glm::vec3(scale_)) * glm::translate(glm::mat4(1.0f), -(boundsMin + boundsMax) * 0.5f);
+
+  chunks_.resize(index_.chunks.size());
+  for (size_t i = 0; i < chunks_.size(); i++)
+    chunks_[i].entry = index_.chunks[i];
+
+  // 代理网格常驻显存，之后只需按块分段绘制
+  glGenVertexArrays(1, &proxy_vao_);
+  glGenBuffers(1, &proxy_vbo_);
+  glGenBuffers(1, &proxy_ebo_);
+  glBindVertexArray(proxy_vao_);
+  glBindBuffer(GL_ARRAY_BUFFER, proxy_vbo_);
+  glBufferData(GL_ARRAY_BUFFER, index_.proxyVertices.size() * sizeof(chunkfile::Vertex), index_.proxyVertices.data(),
+               GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, proxy_ebo_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_.proxyIndices.size() * sizeof(uint32_t), index_.proxyIndices.data(),
+               GL_STATIC_DRAW);
+  setupVertexLayout();
+  glBindVertexArray(0);
+  std::vector<chunkfile::Vertex>().swap(index_.proxyVertices);
+  std::vector<uint32_t>().swap(index_.proxyIndices);
+
+  stop_ = false;
+  worker_ = std::thread(&ChunkedModel::io_loop, this);
+  return true;
+}
+
+void ChunkedModel::release()
+{
+  if (worker_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+  requests_.clear();
+  completed_.clear();
+
+  for (Chunk &chunk : chunks_)
+  {
+    if (chunk.vao)
+    {
+      glDeleteVertexArrays(1, &chunk.vao);
+      glDeleteBuffers(1, &chunk.vbo);
+      glDeleteBuffers(1, &chunk.ebo);
+    }
+  }
+  chunks_.clear();
+  if (proxy_vao_)
+  {
+    glDeleteVertexArrays(1, &proxy_vao_);
+    glDeleteBuffers(1, &proxy_vbo_);
+    glDeleteBuffers(1, &proxy_ebo_);
+    proxy_vao_ = proxy_vbo_ = proxy_ebo_ = 0;
+  }
+  committed_bytes_ = resident_bytes_ = 0;
+  stats_ = Stats();
+}
+
+// I/O线程：按请求顺序读取块数据，读入的结果由主线程在 update 中取走
+void ChunkedModel::io_loop()
+{
+  std::ifstream file(path_, std::ios::in | std::ios::binary);
+  while (true)
+  {
+    uint32_t index = 0;
+    chunkfile::ChunkEntry entry;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]
+               { return stop_ || !requests_.empty(); });
+      if (stop_)
+        return;
+      index = requests_.front();
+      requests_.pop_front();
+      entry = chunks_[index].entry;
+    }
+
+    std::vector<uint8_t> data(entry.dataBytes());
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(entry.offset));
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file || !chunkfile::validChunkData(entry, data))
+      data.clear(); // 读取失败或索引越界：主线程把该块标记为失败
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.emplace_back(index, std::move(data));
+  }
+}
+
+void ChunkedModel::request(uint32_t index)
+{
+  Chunk &chunk = chunks_[index];
+  chunk.state = ChunkState::Loading;
+  committed_bytes_ += chunk.entry.dataBytes();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(index);
+  }
+  cv_.notify_one();
+}
+
+void ChunkedModel::upload(Chunk &chunk)
+{
+  const chunkfile::ChunkEntry &entry = chunk.entry;
+  size_t vertexBytes = size_t(entry.vertexCount) * sizeof(chunkfile::Vertex);
+  glGenVertexArrays(1, &chunk.vao);
+  glGenBuffers(1, &chunk.vbo);
+  glGenBuffers(1, &chunk.ebo);
+  glBindVertexArray(chunk.vao);
+  glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+  glBufferData(GL_ARRAY_BUFFER, vertexBytes, chunk.data.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.ebo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_t(entry.indexCount) * sizeof(uint32_t), chunk.data.data() + vertexBytes,
+               GL_STATIC_DRAW);
+  setupVertexLayout();
+  glBindVertexArray(0);
+  std::vector<uint8_t>().swap(chunk.data);
+  chunk.state = ChunkState::Resident;
+  resident_bytes_ += entry.dataBytes();
+}
+
+void ChunkedModel::evict(Chunk &chunk)
+{
+  if (chunk.state == ChunkState::Resident)
+  {
+    glDeleteVertexArrays(1, &chunk.vao);
+    glDeleteBuffers(1, &chunk.vbo);
+    glDeleteBuffers(1, &chunk.ebo);
+    chunk.vao = chunk.vbo = chunk.ebo = 0;
+    resident_bytes_ -= chunk.entry.dataBytes();
+  }
+  std::vector<uint8_t>().swap(chunk.data);
+  committed_bytes_ -= chunk.entry.dataBytes();
+  chunk.state = ChunkState::Unloaded;
+  stats_.evictions++;
+}
+
+// 为距离为 distance 的新块腾出 bytes：先淘汰最久不需要的块，再淘汰比它更远的需要的块
+bool ChunkedModel::make_room(uint64_t bytes, float distance)
+{
+  while (committed_bytes_ + bytes > memory_ceiling_)
+  {
+    Chunk *victim = nullptr;
+    for (Chunk &chunk : chunks_)
+    {
+      if (chunk.state != ChunkState::Loaded && chunk.state != ChunkState::Resident)
+        continue;
+      if (chunk.wanted)
+      {
+        if (chunk.distance <= distance)
+          continue;
+        if (!victim || (victim->wanted && chunk.distance > victim->distance))
+          victim = &chunk;
+      }
+      else if (!victim || victim->wanted || chunk.lastWanted < victim->lastWanted)
+      {
+        victim = &chunk;
+      }
+    }
+    if (!victim)
+      return false;
+    evict(*victim);
+  }
+  return true;
+}
+
+void ChunkedModel::update(const glm::mat4 &viewProjection, const glm::mat4 &transform, const glm::vec3 &cameraPosition)
+{
+  if (chunks_.empty())
+    return;
+  frame_++;
+
+  // 取走I/O线程读完的块；读取期间已不再需要的块也先保留，由淘汰策略决定去留
+  std::vector<std::pair<uint32_t, std::vector<uint8_t>>> completed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed.swap(completed_);
+  }
+  for (auto &item : completed)
+  {
+    Chunk &chunk = chunks_[item.first];
+    if (item.second.empty())
+    {
+      // 文件损坏或被截断时重试也不会成功，标记后不再请求，避免每帧重复读取
+      committed_bytes_ -= chunk.entry.dataBytes();
+      chunk.state = ChunkState::Failed;
+      stats_.failures++;
+      std::cout << "分块模型的块 " << item.first << " 读取失败或数据损坏，改为只绘制代理网格: " << path_ << std::endl;
+      continue;
+    }
+    chunk.data = std::move(item.second);
+    chunk.state = ChunkState::Loaded;
+    stats_.loads++;
+  }
+
+  // 视锥与距离判断在文件坐标系中进行，相机位置变换到该坐标系，距离再换算回标准化空间
+  glm::mat4 toWorld = transform * normalize_;
+  glm::mat4 clip = viewProjection * toWorld;
+  glm::vec3 camera = glm::vec3(glm::inverse(toWorld) * glm::vec4(cameraPosition, 1.0f));
+  std::vector<uint32_t> wanted;
+  stats_.visible = 0;
+  stats_.oversized = 0;
+  for (uint32_t i = 0; i < chunks_.size(); i++)
+  {
+    Chunk &chunk = chunks_[i];
+    const chunkfile::ChunkEntry &entry = chunk.entry;
+    glm::vec3 boundsMin(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]);
+    glm::vec3 boundsMax(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+    chunk.distance = glm::length(glm::max(glm::max(boundsMin - camera, camera - boundsMax), glm::vec3(0.0f))) * scale_;
+    chunk.visible = boxInFrustum(clip, boundsMin, boundsMax);
+    chunk.wanted = chunk.visible && chunk.distance <= detail_distance_;
+    if (chunk.visible)
+      stats_.visible++;
+    if (chunk.wanted)
+    {
+      chunk.lastWanted = frame_;
+      if (chunk.state == ChunkState::Unloaded)
+        wanted.push_back(i);
+    }
+  }
+
+  // 由近到远发起读取，受在途数量与内存上限限制
+  std::sort(wanted.begin(), wanted.end(), [this](uint32_t a, uint32_t b)
+            { return chunks_[a].distance < chunks_[b].distance; });
+  uint32_t inFlight = 0;
+  for (const Chunk &chunk : chunks_)
+  {
+    if (chunk.state == ChunkState::Loading)
+      inFlight++;
+  }
+  for (uint32_t index : wanted)
+  {
+    if (inFlight >= kMaxInFlight)
+      break;
+    Chunk &chunk = chunks_[index];
+    if (chunk.entry.dataBytes() > memory_ceiling_)
+    {
+      // 单块超过内存上限时腾多少空间都放不下；跳过它而不是挡住更远的块，上限调大后再读取
+      if (!chunk.oversized)
+        std::cout << "分块模型的块 " << index << " (" << (chunk.entry.dataBytes() >> 20) << " MB) 超过内存上限，只绘制代理网格"
+                  << std::endl;
+      chunk.oversized = true;
+      stats_.oversized++;
+      continue;
+    }
+    if (!make_room(chunk.entry.dataBytes(), chunk.distance))
+      break;
+    request(index);
+    inFlight++;
+  }
+
+  // 在每帧预算内由近到远上传已读入的块（至少上传一个）
+  std::vector<Chunk *> loaded;
+  for (Chunk &chunk : chunks_)
+  {
+    if (chunk.state == ChunkState::Loaded)
+      loaded.push_back(&chunk);
+  }
+  std::sort(loaded.begin(), loaded.end(), [](const Chunk *a, const Chunk *b)
+            { return a->distance < b->distance; });
+  stats_.uploadedBytes = 0;
+  for (Chunk *chunk : loaded)
+  {
+    if (stats_.uploadedBytes > 0 && stats_.uploadedBytes + chunk->entry.dataBytes() > upload_budget_)
+      break;
+    upload(*chunk);
+    stats_.uploadedBytes += chunk->entry.dataBytes();
+  }
+
+  // 绘制统计在这里按 draw 的规则算好，draw 本身不写统计
+  stats_.detailDraws = stats_.proxyDraws = 0;
+  stats_.triangles = 0;
+  for (const Chunk &chunk : chunks_)
+  {
+    if (!chunk.visible)
+      continue;
+    if (chunk.state == ChunkState::Resident)
+    {
+      stats_.detailDraws++;
+      stats_.triangles += chunk.entry.indexCount / 3;
+    }
+    else if (chunk.entry.proxyIndexCount > 0)
+    {
+      stats_.proxyDraws++;
+      stats_.triangles += chunk.entry.proxyIndexCount / 3;
+    }
+  }
+}
+
+void ChunkedModel::draw(Shader *shader, const glm::mat4 &transform)
+{
+  if (chunks_.empty())
+    return;
+
+  glm::mat4 model = transform * normalize_;
+  shader->setMat4("model", model);
+  shader->setMat3("normalMatrix", glm::mat3(glm::transpose(glm::inverse(model))));
+  shader->setBool("instanced", false);
+  shader->setBool("skinned", false);
+  shader->setInt("diffuseLayer", -1);
+  // 分块文件不含材质，使用 objectColor 着色
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  shader->setInt("texture_diffuse1", 0);
+
+  for (const Chunk &chunk : chunks_)
+  {
+    if (!chunk.visible)
+      continue;
+    if (chunk.state == ChunkState::Resident)
+    {
+      glBindVertexArray(chunk.vao);
+      glDrawElements(GL_TRIANGLES, chunk.entry.indexCount, GL_UNSIGNED_INT, 0);
+    }
+    else if (chunk.entry.proxyIndexCount > 0)
+    {
+      glBindVertexArray(proxy_vao_);
+      glDrawElements(GL_TRIANGLES, chunk.entry.proxyIndexCount, GL_UNSIGNED_INT,
+                     (void *)(uintptr_t(chunk.entry.proxyFirstIndex) * sizeof(uint32_t)));
+    }
+  }
+  glBindVertexArray(0);
+}
+
+void ChunkedModel::render_panel()
+{
+  if (!ImGui::CollapsingHeader("分块模型 (out-of-core)"))
+    return;
+
+  const double MB = 1024.0 * 1024.0;
+  ImGui::Text("文件: %s", path_.c_str());
+  ImGui::Text("块: %zu, 三角形: %llu", chunks_.size(), (unsigned long long)index_.header.triangleCount);
+  ImGui::Text("可见块: %u, 细节绘制 %u, 代理绘制 %u, 三角形 %llu", stats_.visible, stats_.detailDraws,
+              stats_.proxyDraws, (unsigned long long)stats_.triangles);
+  ImGui::Text("占用: %.1f / %.1f MB (显存 %.1f MB), 上一帧上传 %.2f MB", committed_bytes_ / MB,
+              memory_ceiling_ / MB, resident_bytes_ / MB, stats_.uploadedBytes / MB);
+  ImGui::Text("累计读取 %llu 块, 淘汰 %llu 块, 读取失败 %llu 块", (unsigned long long)stats_.loads,
+              (unsigned long long)stats_.evictions, (unsigned long long)stats_.failures);
+  if (stats_.oversized > 0)
+    ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%u 个需要的块超过内存上限，只绘制代理网格", stats_.oversized);
+
+  int ceilingMB = static_cast<int>(memory_ceiling_ >> 20);
+  if (ImGui::SliderInt("内存上限 (MB)", &ceilingMB, 32, 16384))
+    memory_ceiling_ = uint64_t(ceilingMB) << 20;
+  int uploadMB = static_cast<int>(upload_budget_ >> 20);
+  if (ImGui::SliderInt("每帧上传预算 (MB)##chunk", &uploadMB, 1, 256))
+    upload_budget_ = uint64_t(uploadMB) << 20;
+  ImGui::SliderFloat("细节距离", &detail_distance_, 0.1f, 10.0f);
+}
@@ -0,0 +1,109 @@
+#ifndef __CHUNKED_MODEL_H
+#define __CHUNKED_MODEL_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "chunk_format.h"
+#include "shader.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// 超出内存的大模型：由 gl_trackball_chunk 离线分块生成 .chunks 文件，运行时只常驻块表与低精度代理网格。
+// I/O线程按需读取细节块，主线程每帧在字节预算内上传；驻留总量（在途 + 已读入 + 显存）不超过内存上限，
+// 超出时先淘汰不需要的块、再淘汰比新请求更远的块。细节块未驻留时绘制代理网格中对应的分段
+class ChunkedModel
+{
+public:
+  enum class ChunkState
+  {
+    Unloaded,
+    Loading,  // 已交给I/O线程
+    Loaded,   // 数据已读入内存，等待上传
+    Resident, // 已上传到显存
+    Failed    // 读取失败，不再请求（只绘制代理网格）
+  };
+
+  struct Stats
+  {
+    uint32_t visible = 0;
+    uint32_t detailDraws = 0; // 上一帧绘制的细节块
+    uint32_t proxyDraws = 0;  // 上一帧以代理网格代替的块
+    uint64_t triangles = 0;   // 上一帧绘制的三角形
+    uint64_t uploadedBytes = 0;
+    uint64_t loads = 0;     // 累计读取的块
+    uint64_t evictions = 0; // 累计淘汰的块
+    uint64_t failures = 0;  // 读取失败的块
+    uint32_t oversized = 0; // 上一帧需要但单块超过内存上限的块
+  };
+
+private:
+  static constexpr uint32_t kMaxInFlight = 8; // 同时交给I/O线程的块数上限
+
+  struct Chunk
+  {
+    chunkfile::ChunkEntry entry;
+    ChunkState state = ChunkState::Unloaded;
+    std::vector<uint8_t> data; // Loaded 状态下的块数据
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    float distance = 0.0f; // 到相机的距离（标准化空间）
+    bool visible = false;
+    bool wanted = false;
+    bool oversized = false;  // 已报告过超过内存上限
+    uint64_t lastWanted = 0; // 最近一次需要细节的帧
+  };
+
+  std::string path_;
+  chunkfile::Index index_;
+  std::vector<Chunk> chunks_;
+  glm::mat4 normalize_ = glm::mat4(1.0f); // 与 Model 相同：缩放到最大边长2.0并居中
+  float scale_ = 1.0f;
+  GLuint proxy_vao_ = 0, proxy_vbo_ = 0, proxy_ebo_ = 0;
+
+  uint64_t memory_ceiling_ = 512ull << 20;
+  uint64_t upload_budget_ = 32ull << 20; // 每帧上传字节预算
+  float detail_distance_ = 1.5f;         // 距离相机不超过该值（标准化空间）的可见块加载细节
+  uint64_t committed_bytes_ = 0;         // 在途 + 已读入 + 已驻留的块数据
+  uint64_t resident_bytes_ = 0;          // 其中已上传到显存的部分
+  uint64_t frame_ = 0;
+  Stats stats_;
+
+  // I/O线程
+  std::thread worker_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<uint32_t> requests_;
+  std::vector<std::pair<uint32_t, std::vector<uint8_t>>> completed_;
+  bool stop_ = false;
+
+  void io_loop();
+  void request(uint32_t chunk);
+  void upload(Chunk &chunk);
+  void evict(Chunk &chunk);
+  bool make_room(uint64_t bytes, float distance);
+  void release();
+
+public:
+  ChunkedModel() = default;
+  ~ChunkedModel();
+  ChunkedModel(const ChunkedModel &) = delete;
+  ChunkedModel &operator=(const ChunkedModel &) = delete;
+
+  bool open(const std::string &path); // 读取块表与代理网格，启动I/O线程
+  bool isOpen() const { return !chunks_.empty(); }
+
+  // 视锥剔除、按距离决定需要的细节块并发起读取/淘汰，最后上传已读入的块并统计本帧的绘制。
+  // update 读取面板设置并写统计，须在场景锁内调用；draw 只读 update 的结果
+  void update(const glm::mat4 &viewProjection, const glm::mat4 &transform, const glm::vec3 &cameraPosition);
+  void draw(Shader *shader, const glm::mat4 &transform);
+
+  const Stats &stats() const { return stats_; }
+  size_t chunkCount() const { return chunks_.size(); }
+  uint64_t triangleCount() const { return index_.header.triangleCount; }
+  float getModelScaleFactor() const { return scale_; }
+
+  void render_panel();
+};
+
+#endif
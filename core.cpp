@@ -1,13 +1,46 @@
 #include "core.h"
+#include "profiler.h"
+#include "gl_trace.h"
+#include "texture_streamer.h"
+#include "texture_budget.h"
+#include "frame_pacer.h"
+#include "gl_task_queue.h"
+#include "asset_archive.h"
+#include "startup.h"
 #include "imgui.h"
 #include "imgui_stdlib.h"
 #include "GLFW/glfw3.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+// 资源逻辑名，经 AssetArchive 在资源包或资源根目录中查找
+static const char *kVertexShader = "glsl/vertex.glsl";
+static const char *kFragmentShader = "glsl/fragment.glsl";
+static const char *kPointVertexShader = "glsl/point_vertex.glsl";
+static const char *kPointFragmentShader = "glsl/point_fragment.glsl";
+static const char *kDepthVertexShader = "glsl/depth_vertex.glsl";
+static const char *kDepthFragmentShader = "glsl/depth_fragment.glsl";
+
+std::vector<std::string> Core::shaderFiles()
+{
+  return {kVertexShader, kFragmentShader, kPointVertexShader, kPointFragmentShader, kDepthVertexShader, kDepthFragmentShader};
+}
 
 void Core::init()
 {
-  shader_ = std::make_unique<Shader>("/Users/mds/my/gl_Trackball/glsl/vertex.glsl",
-                                     "/Users/mds/my/gl_Trackball/glsl/fragment.glsl");
+  shader_ = std::make_unique<Shader>(kVertexShader, kFragmentShader);
+  point_shader_ = std::make_unique<Shader>(kPointVertexShader, kPointFragmentShader);
+  depth_prepass_.init(kDepthVertexShader, kDepthFragmentShader);
+  shadow_map_.init(kDepthVertexShader, kDepthFragmentShader);
+  // 不同类型的采样器不能指向同一纹理单元，数组页与骨骼矩阵使用固定单元
+  shader_->use();
+  shader_->setInt("texture_diffuse_array", Mesh::kDiffuseArrayUnit);
+  shader_->setInt("bonePalette", Mesh::kBonePaletteUnit);
+  shader_->setInt("shadowMap", Mesh::kShadowMapUnit);
 
   // 初始化轨迹球相关变量
   cameraDistance = glm::length(camera.Position - camTarget);
@@ -17,72 +50,372 @@ void Core::init()
 void Core::imgui_render()
 {
   render_tool_panel();
+
+  // 启动预取的模型导入完成前，在场景中央显示占位提示
+  if (!deferred_model_.empty())
+  {
+    ImGuiIO &io = ImGui::GetIO();
+    std::string text = "Loading " + deferred_model_.substr(deferred_model_.find_last_of('/') + 1) + " ...";
+    ImVec2 size = ImGui::CalcTextSize(text.c_str());
+    ImGui::GetForegroundDrawList()->AddText(ImVec2((io.DisplaySize.x - size.x) * 0.5f, (io.DisplaySize.y - size.y) * 0.5f),
+                                            IM_COL32(220, 220, 220, 255), text.c_str());
+  }
 }
 
-void Core::render()
+FrameView Core::update_camera()
 {
   // 处理鼠标输入
-  handleMouseInput();
+  {
+    PROFILE_SCOPE("handleMouseInput");
+    handleMouseInput();
+  }
 
   float currentFrame = static_cast<float>(glfwGetTime());
   deltaTime = currentFrame - lastFrame;
   lastFrame = currentFrame;
 
-  shader_->use();
-
   // view/projection transformations
-  glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)1280 / (float)800, 0.1f, 100.0f);
-  glm::mat4 view = camera.GetViewMatrix();
-  shader_->setMat4("projection", projection);
-  shader_->setMat4("view", view);
+  FrameView frame;
+  frame.projection = glm::perspective(glm::radians(camera.Zoom), (float)1280 / (float)800, 0.1f, 100.0f);
+  frame.view = camera.GetViewMatrix();
+  frame.position = camera.Position;
+  frame.fovY = glm::radians(camera.Zoom);
+  frame.viewportHeight = 800.0f;
+  projection_ = frame.projection;
+  view_ = frame.view;
+  return frame;
+}
 
-  if (model_)
+void Core::render(const FrameView &frame)
+{
+  update_scene(frame);
+  submit_scene();
+}
+
+// 更新阶段（渲染线程模式下持有场景锁）：读取面板设置、推进流式加载与动画、发起本帧的帧准备，
+// 并把提交阶段要用的状态复制下来。提交阶段不持有场景锁，只读这里留下的结果
+void Core::update_scene(const FrameView &frame)
+{
+  PROFILE_SCOPE("Core::update_scene");
+
+  shadow_map_.latch();
+  draw_frame_ = frame;
+  if (!model_ && !chunked_model_ && !point_cloud_)
+    return;
+
+  // render the loaded model
+  glm::mat4 model = glm::mat4(1.0f);
+
+  model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f)); // translate it down so it's at the center of the scene
+
+  // 计算当前旋转角度（基于校准角度）
+  float currentRotation = (float)glfwGetTime() * 30.0f;
+  float finalRotation = isCalibrated ? (currentRotation - calibratedModelRotation) : currentRotation;
+  model = glm::rotate(model, glm::radians(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  // 不需要缩放，模型已经标准化了
+  draw_transform_ = model;
+
+  const glm::mat4 &projection = frame.projection;
+  const glm::mat4 &view = frame.view;
+  if (point_cloud_)
   {
-    // render the loaded model
-    glm::mat4 model = glm::mat4(1.0f);
+    PROFILE_SCOPE("point_cloud_lod");
+    point_cloud_->update(projection * view, model, frame.position, frame.viewportHeight, frame.fovY);
+    return;
+  }
 
-    model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f)); // translate it down so it's at the center of the scene
+  if (chunked_model_)
+  {
+    PROFILE_SCOPE("chunk_stream");
+    chunked_model_->update(projection * view, model, frame.position);
+    return;
+  }
 
-    // 计算当前旋转角度（基于校准角度）
-    float currentRotation = (float)glfwGetTime() * 30.0f;
-    float finalRotation = isCalibrated ? (currentRotation - calibratedModelRotation) : currentRotation;
-    model = glm::rotate(model, glm::radians(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    // 不需要缩放，模型已经标准化了
+  // 帧准备（场景图更新、视锥剔除、命令包构建）：流水线模式下交给工作线程为本帧准备，
+  // 同时提交上一帧准备好的命令包，在 finish_render 中等待准备完成后交换
+  int slot = pipelined_ ? 1 - submit_packet_ : submit_packet_;
+  FramePacket &next = packets_[slot];
+  next.frame = Profiler::get_instance().frameIndex();
+  next.cull = frustum_cull_;
+  next.view = view;
+  next.projection = projection;
+  next.transform = model;
+  next.cameraPosition = frame.position;
+  double now = glfwGetTime();
+  if (animation_playing_ && last_render_time_ > 0.0)
+    animation_time_ += (now - last_render_time_) * animation_speed_;
+  last_render_time_ = now;
+  next.animationClip = model_->animation().empty() ? -1 : animation_clip_;
+  next.animationTime = static_cast<float>(animation_time_);
+  next.crowd = static_cast<uint32_t>(crowd_size_);
+  FramePacket *shadow = schedule_shadow_map(slot);
+  if (pipelined_ && packets_[submit_packet_].owner == model_.get())
+  {
+    Model *target = model_.get();
+    frame_pipeline_.kick([this, target, &next, shadow]
+                         {
+                           // 准备期间持有场景锁：渲染线程模式下提交阶段不持锁，面板与拾取只能在准备完成后
+                           // 访问场景图与BVH。调用方在等待准备完成之前须先释放场景锁
+                           std::lock_guard<std::mutex> lock(scene_mutex_);
+                           // 光源命令包先准备：它与 next 带着同一版本的实例矩阵，在同一帧先于 next 上传
+                           if (shadow)
+                             target->prepareFrame(*shadow);
+                           target->prepareFrame(next); });
+    prepare_pending_ = true;
+  }
+  else
+  {
+    // 非流水线模式，或刚加载模型/刚切换到流水线模式而没有上一帧的命令包：就地准备并提交本帧
+    PROFILE_SCOPE("frame_prepare");
+    if (shadow)
+      model_->prepareFrame(*shadow);
+    model_->prepareFrame(next);
+    submit_packet_ = slot;
+  }
+  depth_prepass_.beginFrame();
+}
 
-    shader_->setMat4("model", model);
+// 提交阶段：按更新阶段留下的状态发出GL命令。渲染线程模式下不持有场景锁，面板可同时构建
+void Core::submit_scene()
+{
+  PROFILE_SCOPE("Core::submit_scene");
+  if (!model_ && !chunked_model_ && !point_cloud_)
+    return;
 
-    glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-    shader_->setMat3("normalMatrix", normalMatrix);
+  const FrameView &frame = draw_frame_;
+  shader_->use();
+  shader_->setMat4("projection", frame.projection);
+  shader_->setMat4("view", frame.view);
+  shader_->setMat4("model", draw_transform_);
+  glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(draw_transform_)));
+  shader_->setMat3("normalMatrix", normalMatrix);
+
+  shader_->setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
+  shader_->setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+  shadow_map_.apply(shader_.get(), false);
+  shader_->setVec3("viewPos", frame.position);
+
+  if (point_cloud_)
+  {
+    PROFILE_GPU_SCOPE("model_draw");
+    point_shader_->use();
+    point_shader_->setMat4("projection", frame.projection);
+    point_shader_->setMat4("view", frame.view);
+    point_cloud_->draw(point_shader_.get(), draw_transform_);
+    return;
+  }
 
-    shader_->setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
-    shader_->setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-    shader_->setVec3("lightPos", glm::vec3(1.2f, 1.0f, 2.0f));
-    shader_->setVec3("viewPos", camera.Position);
+  if (chunked_model_)
+  {
+    PROFILE_GPU_SCOPE("model_draw");
+    chunked_model_->draw(shader_.get(), draw_transform_);
+    return;
+  }
 
-    model_->draw(shader_.get());
+  // 流水线模式下提交上一帧准备好的命令包（工作线程此时正在准备下一份）
+  draw_shadow_map(submit_packet_);
+  submit_packet(packets_[submit_packet_]);
 
-    // 单独绘制世界坐标轴（使用单位矩阵，不受模型变换影响）
-    glm::mat4 worldAxisModel = glm::mat4(1.0f); // 单位矩阵
-    shader_->setMat4("model", worldAxisModel);
-    glm::mat3 worldAxisNormalMatrix = glm::mat3(1.0f);
-    shader_->setMat3("normalMatrix", worldAxisNormalMatrix);
+  // 单独绘制世界坐标轴（使用单位矩阵，不受模型变换影响）
+  glm::mat4 worldAxisModel = glm::mat4(1.0f); // 单位矩阵
+  shader_->setMat4("model", worldAxisModel);
+  glm::mat3 worldAxisNormalMatrix = glm::mat3(1.0f);
+  shader_->setMat3("normalMatrix", worldAxisNormalMatrix);
+  {
+    PROFILE_GPU_SCOPE("axis_draw");
     model_->drawWorldAxis(shader_.get());
   }
 }
 
+// 阴影贴图只在光源、模型、整体/节点变换或动画姿态变化时重绘。光源命令包与同一槽位的命令包一起
+// 在帧准备中生成（流水线模式下在工作线程上），GL线程在提交该槽位时绘制，阴影与模型的姿态属于同一帧。
+// 不做视锥剔除时命令包本身就包含全部物体，直接用它绘制阴影，不再单独准备
+FramePacket *Core::schedule_shadow_map(int slot)
+{
+  const FramePacket &next = packets_[slot];
+  ShadowMap::SceneKey key;
+  key.model = model_.get();
+  key.geometryVersion = model_->geometryVersion();
+  key.transform = next.transform;
+  key.animationClip = next.animationClip;
+  key.animationTime = next.animationClip >= 0 ? next.animationTime : 0.0f;
+  key.crowd = next.animationClip >= 0 ? next.crowd : 1;
+  // 切换流水线模式时该槽位可能还有未绘制的重绘，needsUpdate 已登记过它的状态，不能丢掉
+  bool update = shadow_map_.needsUpdate(key);
+  shadow_pending_[slot] = shadow_pending_[slot] || update;
+  if (!shadow_pending_[slot] || !next.cull)
+    return nullptr;
+
+  FramePacket &packet = shadow_packets_[slot];
+  packet.reset();
+  packet.frame = next.frame;
+  packet.cull = false;
+  packet.transform = next.transform;
+  packet.animationClip = next.animationClip;
+  packet.animationTime = next.animationTime;
+  packet.crowd = next.crowd;
+  return &packet;
+}
+
+void Core::draw_shadow_map(int slot)
+{
+  if (shadow_pending_[slot] && packets_[slot].owner == model_.get())
+  {
+    PROFILE_GPU_SCOPE("shadow_map");
+    const FramePacket &packet = packets_[slot].cull ? shadow_packets_[slot] : packets_[slot];
+    model_->uploadFrame(packet);
+    glm::vec3 boundsMin, boundsMax;
+    model_->packetBounds(packet, boundsMin, boundsMax);
+    model_->submitDepth(packet, shadow_map_.begin(boundsMin, boundsMax), false);
+    shadow_map_.end();
+    shadow_pending_[slot] = false;
+  }
+  shader_->use();
+  shadow_map_.apply(shader_.get(), true);
+}
+
+void Core::submit_packet(const FramePacket &packet)
+{
+  model_->uploadFrame(packet);
+  // 用 update_scene 在场景锁内确定的开关：提交阶段不持锁，面板可能同时修改 enabled
+  if (depth_prepass_.active())
+  {
+    PROFILE_GPU_SCOPE("depth_prepass");
+    model_->submitDepth(packet, depth_prepass_.beginDepth(packet.projection, packet.view));
+    depth_prepass_.endDepth();
+    shader_->use();
+  }
+
+  PROFILE_GPU_SCOPE("model_draw");
+  shader_->setMat4("projection", packet.projection);
+  shader_->setMat4("view", packet.view);
+  shader_->setVec3("viewPos", packet.cameraPosition);
+  depth_prepass_.beginColour();
+  model_->submitFrame(packet, shader_.get(), false);
+  depth_prepass_.endColour();
+}
+
 void Core::clean()
 {
+  frame_pipeline_.wait();
+  stopRecording();
   model_.reset();
+  chunked_model_.reset();
+  point_cloud_.reset();
+  player_.reset();
+  depth_prepass_.release();
+  shadow_map_.release();
+}
+
+void Core::latchCursor(const glm::vec2 &position)
+{
+  latched_cursor_ = position;
+  cursor_latched_ = true;
+}
+
+// 帧开始前的节奏控制：按录制速度回放时等待
+void Core::pace_frame()
+{
+  if (isReplaying())
+  {
+    player_->waitForFrame();
+  }
+}
+
+// 执行排队的操作（加载模型等需要GL上下文），超出每帧预算的留到下一帧
+void Core::run_operations()
+{
+  GlTaskQueue::get_instance().run();
+
+  // 启动时预取的模型导入完成后再创建，此前各帧显示空场景与占位提示
+  if (!deferred_model_.empty() && !Startup::get_instance().prefetching(deferred_model_))
+  {
+    std::string path;
+    path.swap(deferred_model_);
+    loadModel(path);
+  }
 }
 
 // 渲染前处理事件
 void Core::before_render()
 {
-  while (!operation_list_.empty())
+  // 回放：注入当前帧录制的滚轮和面板事件
+  if (isReplaying())
   {
-    auto &callback = operation_list_.front();
-    callback();
-    operation_list_.pop_front();
+    player_->beginFrame();
+    std::vector<SessionEvent> events;
+    player_->takeFrameEvents(events);
+    for (const SessionEvent &event : events)
+    {
+      if (event.type == SessionEvent::Scroll)
+        onMouseScroll(event.scrollX, event.scrollY);
+      else if (event.type == SessionEvent::Action)
+        applyAction(event.action, event.arg);
+    }
+  }
+}
+
+// 等待工作线程完成帧准备。准备期间工作线程持有场景锁，调用方不能持有它
+void Core::wait_prepare()
+{
+  if (prepare_pending_)
+  {
+    PROFILE_SCOPE("frame_prepare_wait");
+    frame_pipeline_.wait();
+    prepare_pending_ = false;
+    prepare_ready_ = true;
+  }
+}
+
+// 帧末（渲染线程模式下持有场景锁）：交换命令包，并发布面板读取的绘制统计。
+// 下一帧的面板与事件可能修改场景图，此后工作线程上不再有帧准备
+void Core::finish_render()
+{
+  wait_prepare();
+  if (prepare_ready_)
+  {
+    prepare_ready_ = false;
+    submit_packet_ = 1 - submit_packet_;
+  }
+  if (model_)
+  {
+    draw_stats_ = model_->drawStats();
+    draw_bindings_ = model_->drawBindings();
+  }
+  prepare_wait_ms_ = frame_pipeline_.waitMs();
+}
+
+// 渲染后处理（处理输入的线程）：推进录制/回放的输入帧
+void Core::after_render()
+{
+  if (isRecording())
+  {
+    recorder_->nextFrame();
+  }
+
+  if (isReplaying())
+  {
+    player_->endFrame();
+  }
+}
+
+int64_t Core::replayFrame() const
+{
+  return isReplaying() ? static_cast<int64_t>(player_->frame()) : -1;
+}
+
+// 回放计时与报告（持有GL上下文的线程，在 Profiler::endFrame 之后；渲染线程模式下持有场景锁）。
+// frame 为本帧呈现的回放帧，没有新的回放帧时为 -1。渲染线程模式下最后一帧的快照可能被之后的快照覆盖，
+// 因此注入结束后的任意一帧都可以写出报告
+void Core::record_replay_frame(int64_t frame)
+{
+  if (!player_ || player_->isReported())
+    return;
+  if (frame >= 0)
+    player_->recordFrame(static_cast<uint64_t>(frame));
+  if (frame + 1 >= static_cast<int64_t>(player_->frameCount()) || (frame < 0 && player_->isFinished()))
+  {
+    player_->writeReport(session_path_ + ".report.csv");
   }
 }
 
@@ -93,23 +426,220 @@ void Core::render_tool_panel()
   ImGui::Begin("Debugger", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoScrollbar);
   ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
               1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
-  static std::string model_path = "/Users/mds/my/gl_Trackball/backpack/backpack.obj";
-  ImGui::InputText("模型路径", &model_path);
+  Profiler::get_instance().render_panel();
+  Startup::get_instance().render_panel();
+  FramePacer::get_instance().render_panel();
+  GlTaskQueue::get_instance().render_panel();
+  AssetArchive::get_instance().render_panel();
+  GlTrace::get_instance().render_panel();
+  TextureStreamer::get_instance().render_panel();
+  TextureBudget::get_instance().render_panel();
+  if (chunked_model_)
+    chunked_model_->render_panel();
+  if (point_cloud_)
+    point_cloud_->render_panel();
+  ImGui::InputText("模型路径", &model_path_);
   ImGui::SameLine();
   if (ImGui::Button("加载模型"))
   {
-    operation_list_.emplace_back([this]()
-                                 {
-                                   this->model_.reset();
-                              
-                                   model_ = std::make_unique<Model>(model_path.c_str(), false, true, false); });
+    applyAction(SessionAction::LoadModel, model_path_);
+  }
+
+  // 程序生成的压力测试场景（等价于加载路径 "stress:..."）
+  if (ImGui::CollapsingHeader("压力测试场景"))
+  {
+    ImGui::InputScalar("网格数", ImGuiDataType_U32, &stress_params_.meshCount);
+    ImGui::InputScalar("每网格三角形", ImGuiDataType_U32, &stress_params_.trianglesPerMesh);
+    ImGui::InputScalar("材质数", ImGuiDataType_U32, &stress_params_.materialCount);
+    ImGui::InputScalar("纹理边长", ImGuiDataType_U32, &stress_params_.textureSize);
+    ImGui::InputScalar("随机种子", ImGuiDataType_U32, &stress_params_.seed);
+    stress_params_.meshCount = std::max(1u, stress_params_.meshCount);
+    stress_params_.trianglesPerMesh = std::max(1u, stress_params_.trianglesPerMesh);
+    stress_params_.materialCount = std::max(1u, stress_params_.materialCount);
+    ImGui::Text("总三角形数: %.3f M", stress_params_.meshCount * stress_params_.actualTrianglesPerMesh() / 1.0e6);
+    if (ImGui::Button("生成压力场景"))
+    {
+      applyAction(SessionAction::LoadModel, stress_params_.toString());
+    }
+  }
+
+  const char *retentionNames[] = {"保留全部", "仅保留拾取数据", "全部释放"};
+  int retention = static_cast<int>(load_options_.retention);
+  if (ImGui::Combo("网格CPU副本", &retention, retentionNames, IM_ARRAYSIZE(retentionNames)))
+  {
+    load_options_.retention = static_cast<MeshRetention>(retention);
+  }
+  ImGui::Checkbox("纹理块压缩 (BC1/BC3/BC5)", &load_options_.compressTextures);
+  ImGui::Checkbox("纹理流式上传", &load_options_.streamTextures);
+  const char *maxSizeNames[] = {"不限", "4096", "2048", "1024", "512"};
+  const uint32_t maxSizes[] = {0, 4096, 2048, 1024, 512};
+  int maxSizeIndex = 0;
+  for (int i = 0; i < IM_ARRAYSIZE(maxSizes); i++)
+  {
+    if (maxSizes[i] == load_options_.maxTextureSize)
+      maxSizeIndex = i;
+  }
+  ImGui::Checkbox("网格实例化", &load_options_.instancing);
+  bool textureArrays = load_options_.textureArrayMaxSize > 0;
+  if (ImGui::Checkbox("小纹理合并为纹理数组", &textureArrays))
+  {
+    load_options_.textureArrayMaxSize = textureArrays ? 1024 : 0;
+  }
+  if (ImGui::Combo("纹理最大分辨率", &maxSizeIndex, maxSizeNames, IM_ARRAYSIZE(maxSizeNames)))
+  {
+    load_options_.maxTextureSize = maxSizes[maxSizeIndex];
+  }
+
+  // 会话录制/回放
+  ImGui::InputText("会话文件", &session_path_);
+  if (isRecording())
+  {
+    if (ImGui::Button("停止录制"))
+    {
+      stopRecording();
+    }
+    ImGui::SameLine();
+    ImGui::Text("录制中: %llu 帧", (unsigned long long)recorder_->frame());
+  }
+  else if (player_ && !replayDone())
+  {
+    ImGui::Text("回放中: %llu / %llu 帧", (unsigned long long)player_->frame(), (unsigned long long)player_->frameCount());
+  }
+  else
+  {
+    if (ImGui::Button("开始录制"))
+    {
+      startRecording(session_path_);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("回放"))
+    {
+      startReplay(session_path_, replay_fast_);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("全速回放", &replay_fast_);
+    if (replayDone() && !player_->timings().empty())
+    {
+      ImGui::Text("上次回放: %zu 帧，报告 %s.report.csv", player_->timings().size(), session_path_.c_str());
+    }
   }
 
-  ImGui::Text("模型状态: %s", model_ ? "已加载" : "未加载");
+  ImGui::Text("模型状态: %s", model_ ? "已加载" : chunked_model_ ? "分块流式加载" : point_cloud_ ? "点云" : "未加载");
   if (model_)
   {
     ImGui::Text("网格数量: %zu", model_->meshes.size());
     ImGui::Text("模型缩放: %.4f", model_->getModelScaleFactor());
+    model_->loadReport().render_panel();
+
+    // 内存占用
+    ModelMemoryStats memory = model_->memoryStats();
+    const double MB = 1024.0 * 1024.0;
+    ImGui::Text("CPU内存: %.1f MB (顶点 %.1f, 索引 %.1f, BVH %.1f, 待上传纹理 %.1f, 纹理解码峰值 %.1f)",
+                memory.cpuTotal() / MB, memory.cpuVertexBytes / MB, memory.cpuIndexBytes / MB,
+                memory.cpuBvhBytes / MB, memory.textureStreamBytes / MB, memory.textureStagingPeak / MB);
+    ImGui::Text("GPU内存: %.1f MB (缓冲 %.1f, 纹理 %.1f)", memory.gpuTotal() / MB, memory.gpuBufferBytes / MB,
+                memory.gpuTextureBytes / MB);
+    const Model::DrawStats &drawStats = draw_stats_;
+    const LoadReport::Stage *instancing = model_->loadReport().findStage("mesh_instancing");
+    ImGui::Text("绘制调用: %llu (实例化 %llu, 共 %llu 个实例), 共享网格省去 %.1f MB 顶点/索引",
+                (unsigned long long)drawStats.drawCalls, (unsigned long long)drawStats.instancedDraws,
+                (unsigned long long)drawStats.instances, instancing ? instancing->bytes / MB : 0.0);
+    ImGui::Checkbox("多线程帧准备（延迟一帧）", &pipelined_);
+    ImGui::SameLine();
+    ImGui::Checkbox("视锥剔除", &frustum_cull_);
+    const FramePacket &packet = packets_[submit_packet_];
+    ImGui::Text("帧准备 %.3f ms%s, 等待工作线程 %.3f ms, 剔除 %llu 个实例", packet.prepareMs,
+                pipelined_ ? " (工作线程)" : "", pipelined_ ? prepare_wait_ms_ : 0.0,
+                (unsigned long long)drawStats.culled);
+    depth_prepass_.render_panel();
+    shadow_map_.render_panel();
+    if (!model_->animation().empty() && ImGui::CollapsingHeader("骨骼动画"))
+    {
+      const Animation &animation = model_->animation();
+      animation_clip_ = std::min(animation_clip_, static_cast<int>(animation.clipCount()) - 1);
+      if (ImGui::BeginCombo("动画片段", animation.clip(animation_clip_).name.c_str()))
+      {
+        for (int i = 0; i < static_cast<int>(animation.clipCount()); i++)
+        {
+          if (ImGui::Selectable(animation.clip(i).name.c_str(), i == animation_clip_))
+            animation_clip_ = i;
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::Checkbox("播放", &animation_playing_);
+      ImGui::SameLine();
+      ImGui::SliderFloat("速度", &animation_speed_, 0.0f, 4.0f);
+      ImGui::SliderInt("角色副本数", &crowd_size_, 1, 256);
+      const Animation::Clip &clip = animation.clip(animation_clip_);
+      ImGui::Text("%.2f / %.2f 秒, %zu 条通道, %zu 个蒙皮网格", std::fmod(animation_time_, std::max(1e-3f, clip.duration)),
+                  clip.duration, clip.channels.size(), model_->skinCount());
+      ImGui::Text("动画求值 %.3f ms, 蒙皮绘制 %llu, 骨骼矩阵 %.1f KB", packet.animateMs,
+                  (unsigned long long)drawStats.skinnedDraws, drawStats.paletteBytes / 1024.0);
+      ImGui::TextDisabled("拾取与剔除使用绑定姿态");
+    }
+    const TextureBindings &bindings = draw_bindings_;
+    ImGui::Text("纹理数组页: %zu, 上一帧纹理绑定 %llu 次 (省略 %llu 次)", model_->textureArrayPages(),
+                (unsigned long long)bindings.binds, (unsigned long long)bindings.skipped);
+
+    // 拾取（双击设置旋转中心）
+    const Bvh &bvh = model_->bvh();
+    ImGui::Text("BVH: %zu 三角形, %zu 节点, 构建 %.1f ms, %.1f MB", bvh.triangleCount(), bvh.nodeCount(),
+                bvh.buildMs(), bvh.memoryBytes() / (1024.0 * 1024.0));
+    if (model_->bvhStale() && model_->bvhRebuildable())
+    {
+      ImGui::TextDisabled("节点已移动，下次拾取时重建BVH");
+    }
+    else if (model_->bvhStale())
+    {
+      ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "节点已移动，拾取仍使用加载时的变换（网格CPU副本已释放）");
+    }
+    ImGui::Text("旋转中心: (%.3f, %.3f, %.3f)", camTarget.x, camTarget.y, camTarget.z);
+    if (hasPickHit_)
+    {
+      ImGui::Text("上次拾取: (%.3f, %.3f, %.3f), %.3f ms", lastPickPoint_.x, lastPickPoint_.y, lastPickPoint_.z, lastPickMs_);
+    }
+    if (ImGui::Button("拾取基准测试"))
+    {
+      pickRaysPerSecond_ = bvh.benchmarkRays(100000);
+    }
+    if (pickRaysPerSecond_ > 0.0)
+    {
+      ImGui::SameLine();
+      ImGui::Text("%.2f M 射线/秒", pickRaysPerSecond_ / 1.0e6);
+    }
+
+    // 场景图：节点列表与选中节点的平移
+    if (ImGui::CollapsingHeader("场景节点"))
+    {
+      const SceneGraph &graph = model_->sceneGraph();
+      ImGui::Text("节点 %zu, 网格实例 %zu, 上一次更新 %zu 个节点, %.2f MB", graph.nodeCount(),
+                  model_->instances().size(), graph.lastUpdated(), graph.memoryBytes() / MB);
+      if (ImGui::BeginListBox("##scene_nodes", ImVec2(-FLT_MIN, 160)))
+      {
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(graph.nodeCount()));
+        while (clipper.Step())
+        {
+          for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+          {
+            std::string label = std::string(graph.depth(i) * 2, ' ') + graph.name(i) + "##" + std::to_string(i);
+            if (ImGui::Selectable(label.c_str(), selected_node_ == static_cast<uint32_t>(i)))
+              selected_node_ = i;
+          }
+        }
+        ImGui::EndListBox();
+      }
+      if (selected_node_ < graph.nodeCount())
+      {
+        glm::mat4 local = graph.local(selected_node_);
+        glm::vec3 translation(local[3]);
+        if (ImGui::DragFloat3("节点平移", &translation.x, 0.01f))
+        {
+          local[3] = glm::vec4(translation, 1.0f);
+          model_->setNodeTransform(selected_node_, local);
+        }
+      }
+    }
 
     // 坐标轴控制
     ImGui::Separator();
@@ -160,57 +690,50 @@ void Core::render_tool_panel()
 
     if (ImGui::Button("校准当前角度"))
     {
-      calibrateCamera();
+      applyAction(SessionAction::Calibrate);
     }
     ImGui::SameLine();
     if (ImGui::Button("重置到校准角度") && isCalibrated)
     {
-      resetToCalibrated();
+      applyAction(SessionAction::ResetCalibrated);
     }
     if (ImGui::Button("重置到默认角度"))
     {
-      resetToDefault();
+      applyAction(SessionAction::ResetDefault);
     }
 
     // 轨迹球控制模式选择
     ImGui::Separator();
     ImGui::Text("轨迹球模式:");
 
-    static bool reverseControl = false;
+    bool reverseControl = reverseTrackball;
     if (ImGui::Checkbox("反向控制（物体跟随鼠标）", &reverseControl))
     {
       // 这个标志会在鼠标处理中使用
-      this->reverseTrackball = reverseControl;
+      applyAction(SessionAction::SetReverse, reverseControl ? "1" : "0");
     }
-    ImGui::Text("当前模式: %s", reverseControl ? "物体跟随鼠标" : "相机跟随鼠标");
+    ImGui::Text("当前模式: %s", reverseTrackball ? "物体跟随鼠标" : "相机跟随鼠标");
 
     // 滚转控制
     ImGui::Separator();
     ImGui::Text("滚转控制:");
     if (ImGui::Button("向左滚转"))
     {
-      // 绕前方向轴旋转（滚转）
-      glm::mat4 rollRotation = glm::rotate(glm::mat4(1.0f), glm::radians(5.0f), camera.Front);
-      glm::vec4 newRightVec4 = rollRotation * glm::vec4(camera.Right, 0.0f);
-      glm::vec4 newUpVec4 = rollRotation * glm::vec4(camera.Up, 0.0f);
-      camera.Right = glm::normalize(glm::vec3(newRightVec4));
-      camera.Up = glm::normalize(glm::vec3(newUpVec4));
+      applyAction(SessionAction::Roll, "5");
     }
     ImGui::SameLine();
     if (ImGui::Button("向右滚转"))
     {
-      // 绕前方向轴旋转（滚转）
-      glm::mat4 rollRotation = glm::rotate(glm::mat4(1.0f), glm::radians(-5.0f), camera.Front);
-      glm::vec4 newRightVec4 = rollRotation * glm::vec4(camera.Right, 0.0f);
-      glm::vec4 newUpVec4 = rollRotation * glm::vec4(camera.Up, 0.0f);
-      camera.Right = glm::normalize(glm::vec3(newRightVec4));
-      camera.Up = glm::normalize(glm::vec3(newUpVec4));
+      applyAction(SessionAction::Roll, "-5");
     }
 
     float position[3] = {pos.x, pos.y, pos.z};
     if (ImGui::SliderFloat3("相机位置", position, -10.0f, 10.0f))
     {
-      camera.Position = glm::vec3(position[0], position[1], position[2]);
+      std::ostringstream arg;
+      arg.precision(9);
+      arg << position[0] << " " << position[1] << " " << position[2];
+      applyAction(SessionAction::SetCameraPosition, arg.str());
     }
   }
   ImGui::End();
@@ -219,37 +742,73 @@ void Core::render_tool_panel()
 // 使用ImGui直接处理鼠标输入
 void Core::handleMouseInput()
 {
+  MouseSample sample;
+
+  // 回放时使用录制的鼠标采样，忽略实时输入
+  if (isReplaying())
+  {
+    cursor_latched_ = false;
+    if (player_->mouseSample(sample))
+    {
+      applyMouseInput(sample);
+    }
+    return;
+  }
+
   ImGuiIO &io = ImGui::GetIO();
+  sample.position = cursor_latched_ ? latched_cursor_ : glm::vec2(io.MousePos.x, io.MousePos.y);
+  cursor_latched_ = false;
+  sample.displaySize = glm::vec2(io.DisplaySize.x, io.DisplaySize.y);
+  sample.clicked = ImGui::IsMouseClicked(ImGuiMouseButton_Left);
+  sample.doubleClicked = ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left);
+  sample.released = ImGui::IsMouseReleased(ImGuiMouseButton_Left);
+  sample.dragging = ImGui::IsMouseDragging(ImGuiMouseButton_Left);
+  sample.captured = io.WantCaptureMouse;
+
+  if (isRecording())
+  {
+    recorder_->recordMouse(sample);
+  }
+  applyMouseInput(sample);
+}
 
+void Core::applyMouseInput(const MouseSample &sample)
+{
   // 如果ImGui正在使用鼠标，不处理轨迹球
-  if (io.WantCaptureMouse)
+  if (sample.captured)
   {
     isDragging = false;
     return;
   }
 
-  glm::vec2 currentMousePos = glm::vec2(io.MousePos.x, io.MousePos.y);
+  glm::vec2 currentMousePos = sample.position;
+
+  // 双击：把轨迹球中心移到光标下的表面点
+  if (sample.doubleClicked)
+  {
+    pickPivot(currentMousePos, sample.displaySize);
+  }
 
   // 处理鼠标按钮
-  if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+  if (sample.clicked)
   {
     isDragging = true;
 
     // 计算初始球面点
-    glm::vec2 trackballCoord = getTrackballCoord(currentMousePos);
+    glm::vec2 trackballCoord = getTrackballCoord(currentMousePos, sample.displaySize);
     lastSpherePoint = mapToSphere(trackballCoord, trackballRadius);
   }
 
-  if (ImGui::IsMouseReleased(ImGuiMouseButton_Left))
+  if (sample.released)
   {
     isDragging = false;
   }
 
   // 处理鼠标拖拽 - 真正的虚拟轨迹球算法（保留所有旋转自由度）
-  if (isDragging && ImGui::IsMouseDragging(ImGuiMouseButton_Left))
+  if (isDragging && sample.dragging)
   {
     // 获取当前鼠标位置的球面坐标
-    glm::vec2 trackballCoord = getTrackballCoord(currentMousePos);
+    glm::vec2 trackballCoord = getTrackballCoord(currentMousePos, sample.displaySize);
     currentSpherePoint = mapToSphere(trackballCoord, trackballRadius);
 
     // 计算两个球面点的差异
@@ -325,6 +884,11 @@ void Core::handleMouseInput()
 // GLFW滚轮回调处理
 void Core::onMouseScroll(double xoffset, double yoffset)
 {
+  if (isRecording())
+  {
+    recorder_->recordScroll(xoffset, yoffset);
+  }
+
   // 缩放功能
   cameraDistance -= yoffset * 0.5f;
   cameraDistance = glm::clamp(cameraDistance, 0.5f, 20.0f);
@@ -389,11 +953,267 @@ void Core::resetToDefault()
   calibratedModelRotation = 0.0f;
 }
 
-glm::vec2 Core::getTrackballCoord(const glm::vec2 &mousePos)
+// 绕前方向轴旋转（滚转）
+void Core::rollCamera(float degrees)
 {
-  ImGuiIO &io = ImGui::GetIO();
-  float windowWidth = io.DisplaySize.x;
-  float windowHeight = io.DisplaySize.y;
+  glm::mat4 rollRotation = glm::rotate(glm::mat4(1.0f), glm::radians(degrees), camera.Front);
+  glm::vec4 newRightVec4 = rollRotation * glm::vec4(camera.Right, 0.0f);
+  glm::vec4 newUpVec4 = rollRotation * glm::vec4(camera.Up, 0.0f);
+  camera.Right = glm::normalize(glm::vec3(newRightVec4));
+  camera.Up = glm::normalize(glm::vec3(newUpVec4));
+}
+
+// 执行面板动作；录制时先写入会话文件，回放时由播放器调用
+void Core::applyAction(SessionAction action, const std::string &arg)
+{
+  if (isRecording())
+  {
+    recorder_->recordAction(action, arg);
+  }
+
+  switch (action)
+  {
+  case SessionAction::Calibrate:
+    calibrateCamera();
+    break;
+  case SessionAction::ResetCalibrated:
+    resetToCalibrated();
+    break;
+  case SessionAction::ResetDefault:
+    resetToDefault();
+    break;
+  case SessionAction::LoadModel:
+    GlTaskQueue::get_instance().post([this, path = arg]()
+                                     { loadModel(path); });
+    break;
+  case SessionAction::SetReverse:
+    reverseTrackball = (arg == "1");
+    break;
+  case SessionAction::Roll:
+  {
+    // 参数来自会话文件（可能被手工编辑），格式错误时跳过该动作而不是中断回放
+    char *end = nullptr;
+    float degrees = std::strtof(arg.c_str(), &end);
+    if (end == arg.c_str() || !std::isfinite(degrees))
+    {
+      std::cout << "忽略参数无效的会话动作 " << sessionActionName(action) << ": " << arg << std::endl;
+      break;
+    }
+    rollCamera(degrees);
+    break;
+  }
+  case SessionAction::SetCameraPosition:
+  {
+    std::istringstream in(arg);
+    glm::vec3 position;
+    if (!(in >> position.x >> position.y >> position.z) || !std::isfinite(position.x) || !std::isfinite(position.y) ||
+        !std::isfinite(position.z))
+    {
+      std::cout << "忽略参数无效的会话动作 " << sessionActionName(action) << ": " << arg << std::endl;
+      break;
+    }
+    camera.Position = position;
+    break;
+  }
+  }
+}
+
+// 加载模型文件，或生成路径 "stress:..." 描述的压力测试场景
+void Core::loadModel(const std::string &path)
+{
+  deferred_model_.clear();
+  shadow_map_.invalidate("加载模型");
+  model_.reset();
+  chunked_model_.reset();
+  point_cloud_.reset();
+  packets_[0].reset();
+  packets_[1].reset();
+  shadow_pending_[0] = shadow_pending_[1] = false;
+  draw_stats_ = Model::DrawStats();
+  draw_bindings_ = TextureBindings();
+
+  // 点云与分块模型不在资源包中，相对路径按资源根目录解析后直接读取
+  std::string file = StressSceneParams::isStressPath(path) ? path : AssetArchive::get_instance().resolve(path);
+
+  // 点云（LiDAR扫描等）不经过Assimp
+  if (PointCloud::isPointCloudFile(file))
+  {
+    point_cloud_ = std::make_unique<PointCloud>();
+    if (!point_cloud_->load(file))
+    {
+      point_cloud_.reset();
+      return;
+    }
+    loaded_model_path_ = path;
+    remember_model(path);
+    return;
+  }
+
+  // 离线分块生成的大模型以流式方式加载
+  if (path.size() > 7 && path.compare(path.size() - 7, 7, ".chunks") == 0)
+  {
+    chunked_model_ = std::make_unique<ChunkedModel>();
+    if (!chunked_model_->open(file))
+    {
+      chunked_model_.reset();
+      return;
+    }
+    loaded_model_path_ = path;
+    remember_model(path);
+    return;
+  }
+
+  if (StressSceneParams::isStressPath(path))
+  {
+    StressSceneParams params;
+    if (!StressSceneParams::parse(path, params))
+    {
+      std::cout << "压力场景参数无效: " << path << std::endl;
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<aiScene> scene = createStressScene(params);
+    double generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "压力场景生成: " << params.meshCount << " 网格, "
+              << params.meshCount * params.actualTrianglesPerMesh() << " 三角形, 耗时 " << generateMs << " ms" << std::endl;
+    model_ = std::make_unique<Model>(scene.get(), path, false, true, false, load_options_);
+  }
+  else
+  {
+    Startup &startup = Startup::get_instance();
+    if (startup.prefetching(path))
+    {
+      deferred_model_ = path;
+      return;
+    }
+    if (std::unique_ptr<ImportedScene> imported = startup.takePrefetched(path))
+    {
+      // 自动打开上次的模型失败时不中断启动
+      if (!imported->scene)
+      {
+        std::cout << "模型加载失败: " << path << " " << imported->error << std::endl;
+        return;
+      }
+      model_ = std::make_unique<Model>(std::move(imported), false, true, false, load_options_);
+    }
+    else
+      model_ = std::make_unique<Model>(path.c_str(), false, true, false, load_options_);
+    remember_model(path);
+  }
+  loaded_model_path_ = path;
+}
+
+// 记录最近打开的模型文件，下次启动时预取（回放不改变该记录）
+void Core::remember_model(const std::string &path)
+{
+  if (!isReplaying())
+    Startup::rememberModel(path);
+}
+
+bool Core::startRecording(const std::string &path)
+{
+  if (isReplaying())
+  {
+    std::cout << "回放过程中不能录制" << std::endl;
+    return false;
+  }
+  recorder_ = std::make_unique<SessionRecorder>();
+  if (!recorder_->open(path))
+  {
+    recorder_.reset();
+    return false;
+  }
+  session_path_ = path;
+  std::cout << "开始录制会话: " << path << std::endl;
+
+  // 回放从默认视角开始，录制开始时同样重置并记录当前状态
+  applyAction(SessionAction::ResetDefault);
+  applyAction(SessionAction::SetReverse, reverseTrackball ? "1" : "0");
+  if (model_ || chunked_model_ || point_cloud_)
+  {
+    // 只记录当前模型，不在录制端重新加载
+    recorder_->recordAction(SessionAction::LoadModel, loaded_model_path_);
+  }
+  return true;
+}
+
+void Core::stopRecording()
+{
+  if (recorder_)
+  {
+    recorder_->close();
+    recorder_.reset();
+  }
+}
+
+bool Core::startReplay(const std::string &path, bool fast)
+{
+  stopRecording();
+  player_ = std::make_unique<SessionPlayer>();
+  if (!player_->load(path))
+  {
+    player_.reset();
+    return false;
+  }
+
+  // 回放从默认状态开始，保证与录制时的初始条件一致
+  resetToDefault();
+  reverseTrackball = false;
+  isDragging = false;
+  session_path_ = path;
+  replay_fast_ = fast;
+  Profiler::get_instance().setEnabled(true);
+  player_->start(fast);
+  return true;
+}
+
+Ray Core::screenRay(const glm::vec2 &mousePos, const glm::vec2 &displaySize) const
+{
+  // 窗口坐标 -> NDC，再用 view/projection 的逆矩阵反投影到世界空间
+  float x = (2.0f * mousePos.x) / displaySize.x - 1.0f;
+  float y = 1.0f - (2.0f * mousePos.y) / displaySize.y;
+  glm::mat4 inverseViewProjection = glm::inverse(projection_ * view_);
+  glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+  glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+  nearPoint /= nearPoint.w;
+  farPoint /= farPoint.w;
+
+  Ray ray;
+  ray.origin = glm::vec3(nearPoint);
+  ray.direction = glm::normalize(glm::vec3(farPoint) - glm::vec3(nearPoint));
+  return ray;
+}
+
+bool Core::pickPivot(const glm::vec2 &mousePos, const glm::vec2 &displaySize)
+{
+  // 渲染线程可能正在加载模型或重建BVH
+  std::lock_guard<std::mutex> lock(scene_mutex_);
+  if (!model_)
+    return false;
+
+  // 模型使用单位矩阵绘制，世界空间即模型空间
+  auto start = std::chrono::steady_clock::now();
+  RayHit hit;
+  bool found = model_->pick(screenRay(mousePos, displaySize), hit);
+  lastPickMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  if (!found)
+    return false;
+
+  hasPickHit_ = true;
+  lastPickPoint_ = hit.position;
+
+  // 保持相机朝向不变，平移相机使命中点位于视图中心
+  cameraDistance = glm::clamp(glm::length(hit.position - camera.Position), 0.5f, 20.0f);
+  camTarget = hit.position;
+  camera.Position = camTarget - camera.Front * cameraDistance;
+  updateCameraFromTrackball();
+  return true;
+}
+
+glm::vec2 Core::getTrackballCoord(const glm::vec2 &mousePos, const glm::vec2 &displaySize)
+{
+  float windowWidth = displaySize.x;
+  float windowHeight = displaySize.y;
 
   // 标准轨迹球坐标转换
   float x = (2.0f * mousePos.x - windowWidth) / windowWidth;
@@ -1,21 +1,75 @@
 #ifndef __CORE_H
 #define __CORE_H
 #include "model.h"
+#include "chunked_model.h"
+#include "point_cloud.h"
 #include "camera.h"
-#include <list>
-#include <functional>
+#include "session.h"
+#include "stress_scene.h"
+#include "depth_prepass.h"
+#include "shadow_map.h"
+#include <mutex>
 
 #include <memory>
+
+// 一帧的相机状态：主线程处理完输入后生成，渲染时只读（渲染线程模式下经三缓冲传递）
+struct FrameView
+{
+  glm::mat4 view = glm::mat4(1.0f);
+  glm::mat4 projection = glm::mat4(1.0f);
+  glm::vec3 position = glm::vec3(0.0f);
+  float fovY = 0.0f;           // 弧度
+  float viewportHeight = 0.0f; // 像素
+  double sampleTime = 0.0;     // 输入采样时刻（glfwGetTime），用于统计输入到画面的延迟
+};
+
 class Core
 {
 private:
   std::unique_ptr<Model> model_;
+  std::unique_ptr<ChunkedModel> chunked_model_; // 加载 .chunks 文件时代替 model_
+  std::unique_ptr<PointCloud> point_cloud_;     // 加载点云文件时代替 model_
   std::unique_ptr<Shader> shader_;
-  std::list<std::function<void()>> operation_list_;
+  std::unique_ptr<Shader> point_shader_;
+  DepthPrepass depth_prepass_; // 可选的深度预渲染（只作用于 model_）
+  ShadowMap shadow_map_;       // 缓存的阴影贴图（只作用于 model_）
+
+  // 帧流水线：工作线程准备下一帧的命令包时主线程提交当前帧（延迟一帧）
+  FramePipeline frame_pipeline_;
+  FramePacket packets_[2];
+  // 阴影需要重绘时随同一槽位的命令包一起准备的光源命令包（不做视锥剔除），提交该槽位前绘制
+  FramePacket shadow_packets_[2];
+  bool shadow_pending_[2] = {false, false};
+  int submit_packet_ = 0;        // 本帧提交的命令包
+  bool prepare_pending_ = false; // 工作线程上有未等待的帧准备
+  bool prepare_ready_ = false;   // 帧准备已完成，等待在场景锁内交换命令包
+  bool pipelined_ = true;
+  bool frustum_cull_ = true;
+
+  // 更新阶段留给提交阶段的状态，以及帧末发布给面板的统计（提交阶段不持有场景锁，面板不直接读模型的统计）
+  FrameView draw_frame_;
+  glm::mat4 draw_transform_ = glm::mat4(1.0f);
+  Model::DrawStats draw_stats_;
+  TextureBindings draw_bindings_;
+  double prepare_wait_ms_ = 0.0;
+
+  // 骨骼动画（渲染端推进时间）；crowd_size_ 个副本排成方阵，用于压力测试
+  int animation_clip_ = 0;
+  bool animation_playing_ = true;
+  float animation_speed_ = 1.0f;
+  double animation_time_ = 0.0;
+  double last_render_time_ = 0.0;
+  int crowd_size_ = 1;
+
+  // 场景锁：渲染线程模式下，主线程构建面板/拾取与渲染线程执行操作、更新场景、帧末发布时互斥，
+  // 工作线程准备帧时也持有它；GL提交阶段不持有
+  std::mutex scene_mutex_;
 
   Camera camera = Camera(glm::vec3(0.0f, 0.0f, 3.0f));
   float deltaTime = 0.0f;
   float lastFrame = 0.0f;
+  bool cursor_latched_ = false; // 本帧使用渲染前重新读取的光标位置（late latch）
+  glm::vec2 latched_cursor_ = glm::vec2(0.0f);
 
   // 轨迹球相关变量
   bool isDragging = false;
@@ -26,6 +80,15 @@ private:
   float trackballRadius = 0.8f;                      // 虚拟轨迹球半径
   bool reverseTrackball = false;                     // 是否反向控制（物体跟随鼠标）
 
+  // 拾取相关变量
+  glm::mat4 view_ = glm::mat4(1.0f);       // 最近一帧的观察矩阵
+  glm::mat4 projection_ = glm::mat4(1.0f); // 最近一帧的投影矩阵
+  bool hasPickHit_ = false;                // 上次拾取是否命中
+  glm::vec3 lastPickPoint_ = glm::vec3(0.0f);
+  double lastPickMs_ = 0.0;       // 上次拾取耗时
+  double pickRaysPerSecond_ = 0.0; // 拾取基准测试结果
+  uint32_t selected_node_ = 0;     // 场景节点面板中选中的节点
+
   // 校准相关变量
   glm::vec3 calibratedCameraPosition;   // 校准后的相机基础位置
   glm::vec3 calibratedFront;            // 校准后的前方向
@@ -34,30 +97,76 @@ private:
   float calibratedModelRotation = 0.0f; // 校准时的模型旋转角度
   bool isCalibrated = false;            // 是否已校准
 
+  // 会话录制/回放
+  std::unique_ptr<SessionRecorder> recorder_;
+  std::unique_ptr<SessionPlayer> player_;
+  std::string model_path_ = "backpack/backpack.obj"; // 相对路径按资源根目录解析
+  std::string loaded_model_path_;
+  std::string deferred_model_; // 等待启动预取完成后再打开的模型
+  std::string session_path_ = "session.trace";
+  bool replay_fast_ = false;
+  ModelLoadOptions load_options_; // 下次加载模型时使用
+  StressSceneParams stress_params_;
+
+  void remember_model(const std::string &path);
+  FramePacket *schedule_shadow_map(int slot); // 场景或光源变化时登记重绘，返回需要与命令包一起准备的光源命令包
+  void draw_shadow_map(int slot);             // 绘制该槽位登记的阴影并设置阴影 uniform
+
 public:
   Core() = default;
   ~Core() = default;
 
+  static std::vector<std::string> shaderFiles(); // 启动时可提前预读的着色器源码
   void init();
   void imgui_render();
-  void render();
+  FrameView update_camera();          // 处理鼠标输入并生成本帧相机状态（主线程）
+  void latchCursor(const glm::vec2 &position); // 下一次 update_camera 以该光标位置代替ImGui帧开始时的位置
+  void render(const FrameView &view); // 以给定相机绘制场景（持有GL上下文的线程）：update_scene + submit_scene
+  void update_scene(const FrameView &view); // 读取设置、推进流式加载与动画、发起帧准备（渲染线程模式下持有场景锁）
+  void submit_scene();                      // 按 update_scene 的结果提交GL命令（渲染线程模式下不持有场景锁）
   void clean();
+  void pace_frame();
+  void run_operations(); // 在时间预算内执行 GlTaskQueue 中排队的GL任务（持有GL上下文的线程）
   void before_render();
+  void wait_prepare();  // 等待工作线程的帧准备（不能持有场景锁）
+  void finish_render(); // 交换命令包并发布统计，之后面板才能修改场景（渲染线程模式下持有场景锁）
+  void after_render();
+  int64_t replayFrame() const;            // 本次输入对应的回放帧，不在回放时为 -1（处理输入的线程）
+  void record_replay_frame(int64_t frame); // 记录回放帧计时，回放结束后写出报告（GL线程，Profiler::endFrame 之后）
   void render_tool_panel();
+  void submit_packet(const FramePacket &packet); // 以命令包记录的相机提交模型绘制
 
   // 轨迹球旋转相关方法
-  void handleMouseInput();                            // 处理ImGui鼠标输入
+  void handleMouseInput();                            // 处理ImGui鼠标输入（回放时使用录制的采样）
+  void applyMouseInput(const MouseSample &sample);    // 应用一帧鼠标输入
   void onMouseScroll(double xoffset, double yoffset); // 处理GLFW滚轮回调
   void updateCameraFromTrackball();
+  void rollCamera(float degrees); // 绕前方向轴滚转
 
   // 虚拟轨迹球相关方法
-  glm::vec3 mapToSphere(const glm::vec2 &coord, float radius); // 将屏幕坐标映射到球面
-  glm::vec2 getTrackballCoord(const glm::vec2 &mousePos);      // 获取标准化的轨迹球坐标
+  glm::vec3 mapToSphere(const glm::vec2 &coord, float radius);                         // 将屏幕坐标映射到球面
+  glm::vec2 getTrackballCoord(const glm::vec2 &mousePos, const glm::vec2 &displaySize); // 获取标准化的轨迹球坐标
+
+  // 拾取相关方法
+  Ray screenRay(const glm::vec2 &mousePos, const glm::vec2 &displaySize) const; // 由屏幕坐标生成世界空间射线
+  bool pickPivot(const glm::vec2 &mousePos, const glm::vec2 &displaySize);       // 将轨迹球中心移动到光标下的表面点
 
   // 校准相关方法
   void calibrateCamera();   // 校准当前相机角度为基础角度
   void resetToCalibrated(); // 重置到校准后的基础角度
   void resetToDefault();    // 重置到默认角度
+
+  // 会话录制/回放
+  void applyAction(SessionAction action, const std::string &arg = ""); // 执行面板动作（录制时写入会话）
+  void loadModel(const std::string &path);                             // 立即加载模型（路径可为 "stress:..."）
+  bool startRecording(const std::string &path);
+  void stopRecording();
+  bool startReplay(const std::string &path, bool fast);
+  bool isRecording() const { return recorder_ && recorder_->isOpen(); }
+  bool isReplaying() const { return player_ && !player_->isFinished(); }
+  bool replayDone() const { return player_ && player_->isReported(); } // 回放结束且报告已写出
+
+  std::mutex &sceneMutex() { return scene_mutex_; }
 };
 
 #endif
\ No newline at end of file
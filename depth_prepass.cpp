@@ -0,0 +1,146 @@
+#include "depth_prepass.h"
+#include "mesh.h"
+#include "profiler.h"
+#include "imgui.h"
+#include <cstring>
+
+void DepthPrepass::init(const char *vertexPath, const char *fragmentPath)
+{
+  shader_ = std::make_unique<Shader>(vertexPath, fragmentPath);
+  shader_->use();
+  shader_->setInt("bonePalette", Mesh::kBonePaletteUnit);
+  for (QuerySlot &slot : slots_)
+  {
+    glGenQueries(1, &slot.depth);
+    glGenQueries(1, &slot.colour);
+  }
+}
+
+void DepthPrepass::release()
+{
+  for (QuerySlot &slot : slots_)
+  {
+    glDeleteQueries(1, &slot.depth);
+    glDeleteQueries(1, &slot.colour);
+    slot = QuerySlot();
+  }
+  shader_.reset();
+}
+
+void DepthPrepass::resolve(QuerySlot &slot)
+{
+  GLuint64 samples = 0;
+  glGetQueryObjectui64v(slot.colour, GL_QUERY_RESULT, &samples);
+  colour_samples_ = samples;
+  if (slot.prepass)
+  {
+    glGetQueryObjectui64v(slot.depth, GL_QUERY_RESULT, &samples);
+    depth_samples_ = samples;
+  }
+  result_prepass_ = slot.prepass;
+  slot.pending = false;
+}
+
+void DepthPrepass::beginFrame()
+{
+  slot_ = (slot_ + 1) % kFrameLatency;
+  QuerySlot &slot = slots_[slot_];
+  if (slot.pending)
+  {
+    // 颜色遍的查询最后结束，它可用时深度遍的结果也已可用
+    GLint available = 0;
+    glGetQueryObjectiv(slot.colour, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+      resolve(slot);
+  }
+  measuring_ = !slot.pending && slot.colour != 0;
+  slot.prepass = false;
+  active_ = enabled_;
+}
+
+Shader *DepthPrepass::beginDepth(const glm::mat4 &projection, const glm::mat4 &view)
+{
+  QuerySlot &slot = slots_[slot_];
+  slot.prepass = true;
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  if (measuring_)
+    glBeginQuery(GL_SAMPLES_PASSED, slot.depth);
+  shader_->use();
+  shader_->setMat4("projection", projection);
+  shader_->setMat4("view", view);
+  return shader_.get();
+}
+
+void DepthPrepass::endDepth()
+{
+  if (measuring_)
+    glEndQuery(GL_SAMPLES_PASSED);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void DepthPrepass::beginColour()
+{
+  QuerySlot &slot = slots_[slot_];
+  if (slot.prepass)
+  {
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+  }
+  if (measuring_)
+    glBeginQuery(GL_SAMPLES_PASSED, slot.colour);
+}
+
+void DepthPrepass::endColour()
+{
+  QuerySlot &slot = slots_[slot_];
+  if (measuring_)
+  {
+    glEndQuery(GL_SAMPLES_PASSED);
+    slot.pending = true;
+  }
+  if (slot.prepass)
+  {
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+  }
+}
+
+void DepthPrepass::render_panel()
+{
+  if (!ImGui::CollapsingHeader("深度预渲染"))
+    return;
+
+  ImGui::Checkbox("启用深度预渲染 (GL_EQUAL 颜色遍)", &enabled_);
+
+  // 最近一帧已返回的GPU耗时
+  const auto &history = Profiler::get_instance().history();
+  if (!history.empty())
+  {
+    double depthMs = 0.0;
+    double colourMs = 0.0;
+    for (const Profiler::ScopeRecord &scope : history.back().scopes)
+    {
+      if (scope.gpuMs < 0.0)
+        continue;
+      if (std::strcmp(scope.name, "depth_prepass") == 0)
+        depthMs += scope.gpuMs;
+      else if (std::strcmp(scope.name, "model_draw") == 0)
+        colourMs += scope.gpuMs;
+    }
+    ImGui::Text("GPU: 深度遍 %.3f ms, 颜色遍 %.3f ms, 合计 %.3f ms", depthMs, colourMs, depthMs + colourMs);
+  }
+
+  ImGui::Text("颜色遍着色片元: %llu", (unsigned long long)colour_samples_);
+  if (result_prepass_ && depth_samples_ > 0)
+  {
+    double saved = depth_samples_ > colour_samples_ ? double(depth_samples_ - colour_samples_) / depth_samples_ : 0.0;
+    double overdraw = colour_samples_ > 0 ? double(depth_samples_) / colour_samples_ : 0.0;
+    ImGui::Text("不做预渲染时约 %llu, 省去 %.1f%% 的片元着色 (深度复杂度 %.2f)", (unsigned long long)depth_samples_,
+                saved * 100.0, overdraw);
+  }
+  else
+  {
+    ImGui::TextDisabled("启用后可比较深度遍与颜色遍的通过样本数");
+  }
+  ImGui::TextDisabled("只作用于普通模型，分块模型与点云不做预渲染");
+}
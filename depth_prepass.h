@@ -0,0 +1,64 @@
+#ifndef __DEPTH_PREPASS_H
+#define __DEPTH_PREPASS_H
+
+#include "shader.h"
+#include <cstdint>
+#include <memory>
+
+// 深度预渲染：先用只读位置流的深度程序写深度（关闭颜色写入），再以 GL_EQUAL、不写深度的方式绘制颜色，
+// 每个像素只对最终可见的表面执行一次片元着色。两遍的 gl_Position 必须逐位相同，顶点着色器中均声明 invariant。
+// 用 GL_SAMPLES_PASSED 统计：深度遍通过测试的样本数即不做预渲染时颜色遍要着色的片元数（相同的提交顺序），
+// 颜色遍通过的样本数为实际着色的片元数；查询按帧三缓冲，结果在三帧后读取
+class DepthPrepass
+{
+private:
+  static constexpr int kFrameLatency = 3;
+
+  struct QuerySlot
+  {
+    GLuint depth = 0;
+    GLuint colour = 0;
+    bool pending = false;
+    bool prepass = false; // 该帧是否执行了深度遍
+  };
+
+  std::unique_ptr<Shader> shader_;
+  bool enabled_ = false;
+  bool active_ = false; // 本帧是否执行深度遍（beginFrame 时复制 enabled_，提交期间面板可能修改后者）
+  QuerySlot slots_[kFrameLatency];
+  int slot_ = 0;
+  bool measuring_ = false; // 本帧的查询槽可用（上一轮结果已读取）
+
+  // 最近一次读回的结果
+  uint64_t depth_samples_ = 0;
+  uint64_t colour_samples_ = 0;
+  bool result_prepass_ = false;
+
+  void resolve(QuerySlot &slot);
+
+public:
+  DepthPrepass() = default;
+  ~DepthPrepass() = default;
+  DepthPrepass(const DepthPrepass &) = delete;
+  DepthPrepass &operator=(const DepthPrepass &) = delete;
+
+  void init(const char *vertexPath, const char *fragmentPath);
+  void release();
+
+  bool enabled() const { return enabled_; }
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  bool active() const { return active_; } // 本帧是否执行深度遍，提交时以此代替 enabled
+
+  // 每帧提交模型前在场景锁内调用一次：读取三帧前的查询结果，并确定本帧是否执行深度遍
+  void beginFrame();
+  // 深度遍：关闭颜色写入并启用深度程序，返回该程序供绘制（只用到位置、实例与蒙皮相关的 uniform）
+  Shader *beginDepth(const glm::mat4 &projection, const glm::mat4 &view);
+  void endDepth();
+  // 颜色遍：执行过深度遍时以 GL_EQUAL 测试且不写深度，endColour 恢复默认深度状态
+  void beginColour();
+  void endColour();
+
+  void render_panel();
+};
+
+#endif
@@ -0,0 +1,261 @@
+#include "frame_pacer.h"
+#include <GLFW/glfw3.h>
+#include "imgui.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  constexpr size_t kWorkHistory = 30; // 即时模式按最近30帧的最大耗时预计下一帧
+
+  void meanStdDev(const std::deque<double> &values, double &mean, double &stddev)
+  {
+    mean = stddev = 0.0;
+    if (values.empty())
+      return;
+    for (double value : values)
+      mean += value;
+    mean /= values.size();
+    for (double value : values)
+      stddev += (value - mean) * (value - mean);
+    stddev = std::sqrt(stddev / values.size());
+  }
+
+  double percentile(const std::deque<double> &values, double p)
+  {
+    if (values.empty())
+      return 0.0;
+    std::vector<double> sorted(values.begin(), values.end());
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+  }
+}
+
+void FramePacer::setRefreshRate(double hz)
+{
+  if (hz <= 0.0)
+    return;
+  refresh_period_ = 1.0 / hz;
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  refresh_ms_ = refresh_period_ * 1000.0;
+}
+
+int FramePacer::swapInterval() const
+{
+  if (suspended_.load())
+    return 0;
+  Mode current = mode();
+  return current == Mode::VSync || current == Mode::JustInTime ? 1 : 0;
+}
+
+void FramePacer::sleep_until(double deadline)
+{
+  // 系统睡眠的精度约1ms，剩余不足2ms时改为让出时间片自旋
+  for (;;)
+  {
+    double remaining = deadline - glfwGetTime();
+    if (remaining <= 0.0)
+      return;
+    if (remaining > 0.002)
+      std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.0015));
+    else
+      std::this_thread::yield();
+  }
+}
+
+double FramePacer::estimate_work() const
+{
+  if (work_.empty())
+    return refresh_period_ * 0.5;
+  return *std::max_element(work_.begin(), work_.end());
+}
+
+void FramePacer::waitForFrame()
+{
+  double start = glfwGetTime();
+  if (!suspended_.load())
+  {
+    switch (mode())
+    {
+    case Mode::Limited:
+    {
+      double period = 1.0 / std::max(1.0f, target_fps_.load());
+      // 落后超过一帧时重新对齐，不连续追赶
+      if (next_deadline_ <= 0.0 || start - next_deadline_ > period)
+        next_deadline_ = start;
+      else
+        sleep_until(next_deadline_);
+      next_deadline_ += period;
+      break;
+    }
+    case Mode::JustInTime:
+      if (last_vblank_ > 0.0)
+        sleep_until(last_vblank_ + refresh_period_ - estimate_work() - jit_margin_ms_.load() / 1000.0);
+      break;
+    default:
+      break;
+    }
+  }
+  work_start_ = glfwGetTime();
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  last_sleep_ = work_start_ - start;
+}
+
+void FramePacer::beforeSwap(double sampleTime)
+{
+  // GPU执行到本帧最后一条命令的时刻
+  for (PendingQuery &pending : queries_)
+  {
+    if (pending.used)
+      continue;
+    if (!pending.query)
+      glGenQueries(1, &pending.query);
+    glQueryCounter(pending.query, GL_TIMESTAMP);
+    pending.sampleTime = sampleTime;
+    pending.used = true;
+    break;
+  }
+
+  if (mode() == Mode::JustInTime)
+  {
+    // 等GPU完成，得到包含GPU时间的本帧耗时
+    glFinish();
+    work_.push_back(glfwGetTime() - work_start_);
+    while (work_.size() > kWorkHistory)
+      work_.pop_front();
+  }
+  else
+  {
+    work_.clear();
+    last_vblank_ = 0.0;
+  }
+}
+
+void FramePacer::afterSwap()
+{
+  double now = glfwGetTime();
+  if (mode() == Mode::JustInTime)
+  {
+    // 交换在垂直消隐时完成；glFinish 等到那一刻，作为下一帧睡眠的基准
+    glFinish();
+    now = glfwGetTime();
+    double interval = now - last_vblank_;
+    if (last_vblank_ > 0.0 && std::abs(interval - refresh_period_) < refresh_period_ * 0.1)
+      refresh_period_ = refresh_period_ * 0.95 + interval * 0.05;
+    last_vblank_ = now;
+  }
+
+  // 定期校准GPU时间戳与CPU时钟的偏移
+  if (frame_ % 60 == 0)
+  {
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpu_offset_ = glfwGetTime() - gpuNow * 1.0e-9;
+  }
+  resolve_queries();
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  if (last_swap_ > 0.0)
+  {
+    frame_times_.push_back((now - last_swap_) * 1000.0);
+    while (frame_times_.size() > kHistory)
+      frame_times_.pop_front();
+  }
+  work_estimate_ = mode() == Mode::JustInTime ? estimate_work() * 1000.0 : 0.0;
+  refresh_ms_ = refresh_period_ * 1000.0;
+  last_swap_ = now;
+  frame_++;
+}
+
+void FramePacer::resolve_queries()
+{
+  for (PendingQuery &pending : queries_)
+  {
+    if (!pending.used)
+      continue;
+    GLint available = 0;
+    glGetQueryObjectiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+    GLuint64 timestamp = 0;
+    glGetQueryObjectui64v(pending.query, GL_QUERY_RESULT, &timestamp);
+    pending.used = false;
+    if (pending.sampleTime <= 0.0)
+      continue;
+    double latency = (timestamp * 1.0e-9 + gpu_offset_ - pending.sampleTime) * 1000.0;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    latencies_.push_back(latency);
+    while (latencies_.size() > kHistory)
+      latencies_.pop_front();
+  }
+}
+
+FramePacer::Summary FramePacer::summary() const
+{
+  Summary summary;
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  summary.frames = frame_times_.size();
+  meanStdDev(frame_times_, summary.frameMeanMs, summary.frameStdDevMs);
+  summary.frameP99Ms = percentile(frame_times_, 0.99);
+  double latencyStdDev = 0.0;
+  meanStdDev(latencies_, summary.latencyMeanMs, latencyStdDev);
+  summary.latencyP95Ms = percentile(latencies_, 0.95);
+  summary.workMs = work_estimate_;
+  summary.sleepMs = last_sleep_ * 1000.0;
+  summary.refreshMs = refresh_ms_;
+  return summary;
+}
+
+void FramePacer::release()
+{
+  for (PendingQuery &pending : queries_)
+  {
+    if (pending.query)
+      glDeleteQueries(1, &pending.query);
+    pending = PendingQuery();
+  }
+}
+
+void FramePacer::render_panel()
+{
+  if (!ImGui::CollapsingHeader("帧节奏"))
+    return;
+
+  const char *modeNames[] = {"垂直同步", "不限帧率", "限制帧率", "即时（消隐前处理输入）"};
+  int current = mode_.load();
+  if (ImGui::Combo("节奏模式", &current, modeNames, IM_ARRAYSIZE(modeNames)))
+  {
+    setMode(static_cast<Mode>(current));
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    frame_times_.clear();
+    latencies_.clear();
+  }
+  if (mode() == Mode::Limited)
+  {
+    float fps = target_fps_.load();
+    if (ImGui::SliderFloat("目标帧率", &fps, 15.0f, 360.0f, "%.0f"))
+      target_fps_.store(fps);
+  }
+  if (mode() == Mode::JustInTime)
+  {
+    float margin = jit_margin_ms_.load();
+    if (ImGui::SliderFloat("消隐前余量 (ms)", &margin, 0.2f, 8.0f, "%.1f"))
+      jit_margin_ms_.store(margin);
+  }
+  bool lateLatch = late_latch_.load();
+  if (ImGui::Checkbox("渲染前重新读取光标（late latch）", &lateLatch))
+    late_latch_.store(lateLatch);
+
+  Summary stats = summary();
+  ImGui::Text("帧时间 %.2f ms (标准差 %.2f, P99 %.2f), 节奏等待 %.2f ms", stats.frameMeanMs, stats.frameStdDevMs,
+              stats.frameP99Ms, stats.sleepMs);
+  ImGui::Text("输入->GPU完成 %.2f ms (P95 %.2f)", stats.latencyMeanMs, stats.latencyP95Ms);
+  if (mode() == Mode::JustInTime)
+    ImGui::Text("预计帧耗时 %.2f ms, 刷新周期 %.2f ms", stats.workMs, stats.refreshMs);
+  if (suspended_.load())
+    ImGui::TextDisabled("全速回放中，节奏控制暂停");
+}
@@ -0,0 +1,109 @@
+#ifndef __FRAME_PACER_H
+#define __FRAME_PACER_H
+
+#include <glad/glad.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+// 帧节奏控制与延迟统计。模式：
+//   VSync      交换间隔1，由驱动阻塞在交换缓冲上
+//   Uncapped   交换间隔0，不等待
+//   Limited    交换间隔0，按目标帧率精确睡眠（粗睡眠后自旋到截止时刻）
+//   JustInTime 交换间隔1，交换后 glFinish 得到垂直消隐时刻，下一帧睡到消隐前（预计帧耗时 + 余量）
+//              才开始处理输入和更新相机，使输入尽量晚地进入画面
+// 延迟以本帧相机的输入采样时刻到GPU执行完本帧命令（GL_TIMESTAMP 查询）计，不含扫描输出；
+// 帧时间以相邻两次交换缓冲的间隔计。所有计时使用 glfwGetTime（秒）。
+// waitForFrame/beforeSwap/afterSwap 在持有GL上下文的线程上调用，面板在主线程上读取统计
+class FramePacer
+{
+public:
+  enum class Mode
+  {
+    VSync,
+    Uncapped,
+    Limited,
+    JustInTime
+  };
+
+  struct Summary
+  {
+    size_t frames = 0;
+    double frameMeanMs = 0.0;
+    double frameStdDevMs = 0.0;
+    double frameP99Ms = 0.0;
+    double latencyMeanMs = 0.0;
+    double latencyP95Ms = 0.0;
+    double workMs = 0.0; // 即时模式的预计帧耗时
+    double sleepMs = 0.0; // 上一帧的节奏等待时间
+    double refreshMs = 0.0; // 刷新周期（即时模式下按实测消隐间隔校准）
+  };
+
+private:
+  static constexpr size_t kHistory = 240;
+  static constexpr int kQueryCount = 8;
+
+  std::atomic<int> mode_{static_cast<int>(Mode::VSync)};
+  std::atomic<float> target_fps_{120.0f};
+  std::atomic<float> jit_margin_ms_{1.5f};
+  std::atomic<bool> late_latch_{true};
+  std::atomic<bool> suspended_{false}; // 全速回放时不做节奏等待
+
+  // 以下只在GL线程上访问
+  double refresh_period_ = 1.0 / 60.0;
+  double last_vblank_ = 0.0;   // 即时模式：上一次交换完成（垂直消隐）的时刻
+  double last_swap_ = 0.0;     // 上一次交换缓冲返回的时刻
+  double next_deadline_ = 0.0; // 限帧模式的下一帧截止时刻
+  double work_start_ = 0.0;
+  std::deque<double> work_;    // 即时模式：最近各帧从开始到GPU完成的耗时
+  double gpu_offset_ = 0.0;    // glfwGetTime - GL_TIMESTAMP，秒
+  uint64_t frame_ = 0;
+  struct PendingQuery
+  {
+    GLuint query = 0;
+    double sampleTime = 0.0;
+    bool used = false;
+  };
+  PendingQuery queries_[kQueryCount];
+
+  // 统计（GL线程写，面板读）
+  mutable std::mutex stats_mutex_;
+  std::deque<double> frame_times_;
+  std::deque<double> latencies_;
+  double work_estimate_ = 0.0;
+  double last_sleep_ = 0.0;
+  double refresh_ms_ = 1000.0 / 60.0; // refresh_period_ 的副本，面板不读取GL线程的成员
+
+  FramePacer() = default;
+  FramePacer(const FramePacer &) = delete;
+  FramePacer &operator=(const FramePacer &) = delete;
+
+  static void sleep_until(double deadline); // 粗睡眠后自旋，误差在几十微秒内
+  void resolve_queries();
+  double estimate_work() const;
+
+public:
+  static FramePacer &get_instance()
+  {
+    static FramePacer instance;
+    return instance;
+  }
+
+  Mode mode() const { return static_cast<Mode>(mode_.load()); }
+  void setMode(Mode mode) { mode_.store(static_cast<int>(mode)); }
+  void setTargetFps(float fps) { target_fps_.store(fps); }
+  void setSuspended(bool suspended) { suspended_.store(suspended); }
+  void setRefreshRate(double hz); // 显示器刷新率（主线程查询后设置），即时模式以此为初值
+  int swapInterval() const;
+  bool lateLatch() const { return late_latch_.load(); }
+
+  void waitForFrame();                 // 帧开始前的节奏等待
+  void beforeSwap(double sampleTime);  // 本帧命令提交完毕：sampleTime 为相机的输入采样时刻
+  void afterSwap();                    // 交换缓冲返回后
+
+  Summary summary() const;
+  void release(); // 删除查询对象（GL上下文销毁前）
+  void render_panel();
+};
+
+#endif
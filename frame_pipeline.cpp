@@ -0,0 +1,68 @@
+#include "frame_pipeline.h"
+#include <chrono>
+
+FramePipeline::~FramePipeline()
+{
+  if (!worker_.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+void FramePipeline::worker_loop()
+{
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]
+               { return stop_ || job_; });
+      if (stop_)
+        return;
+      job = std::move(job_);
+      job_ = nullptr;
+    }
+    job();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_ = false;
+    }
+    cv_.notify_all();
+  }
+}
+
+void FramePipeline::kick(std::function<void()> job)
+{
+  if (!worker_.joinable())
+    worker_ = std::thread(&FramePipeline::worker_loop, this);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]
+             { return !busy_; });
+    job_ = std::move(job);
+    busy_ = true;
+  }
+  cv_.notify_all();
+}
+
+void FramePipeline::wait()
+{
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]
+             { return !busy_; });
+  }
+  waitMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool FramePipeline::busy()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return busy_;
+}
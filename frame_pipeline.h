@@ -0,0 +1,91 @@
+#ifndef __FRAME_PIPELINE_H
+#define __FRAME_PIPELINE_H
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 一条绘制命令：网格下标与已计算好的矩阵（实例化绘制时 model 只含整体变换）
+struct DrawCommand
+{
+  static constexpr uint32_t kNoPalette = UINT32_MAX;
+
+  uint32_t mesh;
+  bool instanced;
+  glm::mat4 model;
+  glm::mat3 normalMatrix;
+  uint32_t palette = kNoPalette; // 蒙皮网格的骨骼矩阵在 FramePacket::bonePalettes 中的起始下标
+};
+
+// 一帧的渲染命令包：由帧准备（可在工作线程上）一次写完，之后主线程只读地提交GL命令
+struct FramePacket
+{
+  const void *owner = nullptr; // 生成该命令包的模型，模型被替换后旧命令包作废
+  uint64_t frame = 0;
+  bool cull = false; // 为真时按 view/projection 做视锥剔除
+  glm::mat4 view = glm::mat4(1.0f);
+  glm::mat4 projection = glm::mat4(1.0f);
+  glm::mat4 transform = glm::mat4(1.0f);
+  glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+  // 骨骼动画：片段为负数时按静止的场景图绘制；crowd 个副本排成方阵，各副本的时间错开
+  int animationClip = -1;
+  float animationTime = 0.0f; // 秒
+  uint32_t crowd = 1;
+  float crowdSpacing = 2.5f;
+
+  std::vector<DrawCommand> commands;
+  std::vector<glm::mat4> instanceMatrices; // 节点移动后需重新上传的实例矩阵（为空表示不变）
+  uint64_t instanceVersion = 0;            // instanceMatrices 对应的节点变换版本
+  std::vector<glm::mat4> bonePalettes;     // 本帧所有蒙皮实例的骨骼矩阵
+  uint32_t culled = 0;                     // 被视锥剔除的实例数
+  double prepareMs = 0.0;
+  double animateMs = 0.0; // 其中动画求值（姿态与骨骼矩阵）的耗时
+
+  void reset()
+  {
+    owner = nullptr;
+    commands.clear();
+    instanceMatrices.clear();
+    instanceVersion = 0;
+    bonePalettes.clear();
+    culled = 0;
+    prepareMs = 0.0;
+    animateMs = 0.0;
+  }
+};
+
+// 双缓冲帧流水线：工作线程准备第N+1帧的命令包时，主线程提交第N帧。
+// kick 把准备任务交给工作线程，wait 等待其完成；两次调用之间主线程不得修改准备任务读取的数据
+class FramePipeline
+{
+private:
+  std::thread worker_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::function<void()> job_;
+  bool busy_ = false;
+  bool stop_ = false;
+
+  double waitMs_ = 0.0; // 上一次 wait 阻塞主线程的时间
+
+  void worker_loop();
+
+public:
+  FramePipeline() = default;
+  ~FramePipeline();
+  FramePipeline(const FramePipeline &) = delete;
+  FramePipeline &operator=(const FramePipeline &) = delete;
+
+  void kick(std::function<void()> job);
+  void wait();
+  bool busy();
+
+  double waitMs() const { return waitMs_; }
+};
+
+#endif
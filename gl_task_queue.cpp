@@ -0,0 +1,150 @@
+#include "gl_task_queue.h"
+#include "imgui.h"
+#include <algorithm>
+#include <chrono>
+
+GlTaskQueue::GlTaskQueue()
+    : pool_(new Node[kPoolSize]), head_(&stub_), tail_(&stub_)
+{
+  // 初始空闲链表：0 -> 1 -> ... -> kPoolSize-1
+  for (uint32_t i = 0; i < kPoolSize; i++)
+  {
+    pool_[i].pooled = true;
+    pool_[i].nextFree.store(i + 1 < kPoolSize ? i + 2 : 0, std::memory_order_relaxed);
+  }
+  free_head_.store(1, std::memory_order_release);
+}
+
+GlTaskQueue::~GlTaskQueue()
+{
+  // 退出时未执行的任务只析构，不执行（GL上下文已销毁）
+  while (Node *node = pop())
+  {
+    node->destroy(node->callable);
+    recycle_node(node);
+  }
+}
+
+int64_t GlTaskQueue::now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GlTaskQueue::Node *GlTaskQueue::acquire_node()
+{
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  for (;;)
+  {
+    uint32_t index = static_cast<uint32_t>(head);
+    if (index == 0)
+      return new Node(); // 池已用尽，由 post() 计入堆分配次数
+    // 节点可能同时被其他生产者取走，读到的 nextFree 已过期时版本号会使下面的交换失败
+    uint32_t next = pool_[index - 1].nextFree.load(std::memory_order_relaxed);
+    uint64_t desired = ((head >> 32) + 1) << 32 | next;
+    if (free_head_.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+      return &pool_[index - 1];
+  }
+}
+
+void GlTaskQueue::recycle_node(Node *node)
+{
+  if (!node->pooled)
+  {
+    delete node;
+    return;
+  }
+  uint32_t index = static_cast<uint32_t>(node - pool_.get()) + 1;
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    node->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    uint64_t desired = ((head >> 32) + 1) << 32 | index;
+    if (free_head_.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed))
+      return;
+  }
+}
+
+void GlTaskQueue::push(Node *node)
+{
+  node->postTime = now_ns();
+  node->next.store(nullptr, std::memory_order_relaxed);
+  depth_.fetch_add(1, std::memory_order_relaxed);
+  // 先交换队尾，再把前一个节点链接到本节点；两步之间消费者看到的是暂时断开的链表
+  Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+  previous->next.store(node, std::memory_order_release);
+}
+
+GlTaskQueue::Node *GlTaskQueue::pop()
+{
+  Node *tail = tail_;
+  Node *next = tail->next.load(std::memory_order_acquire);
+  if (tail == &stub_)
+  {
+    if (!next)
+      return nullptr;
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next)
+  {
+    tail_ = next;
+    return tail;
+  }
+  // tail 是最后一个已链接的节点：有生产者正在链接时留到下一次
+  if (tail != head_.load(std::memory_order_acquire))
+    return nullptr;
+  // 重新放入 stub_，使 tail 不再是队尾后才能取出
+  push(&stub_);
+  depth_.fetch_sub(1, std::memory_order_relaxed);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next)
+  {
+    tail_ = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+void GlTaskQueue::run()
+{
+  int64_t start = now_ns();
+  int64_t deadline = start + static_cast<int64_t>(budget_ms_ * 1.0e6);
+  Stats &stats = stats_;
+  stats.executed = 0;
+  stats.maxLatencyMs = 0.0;
+  double latencySum = 0.0;
+  int64_t now = start;
+  while (stats.executed == 0 || now < deadline)
+  {
+    Node *node = pop();
+    if (!node)
+      break;
+    depth_.fetch_sub(1, std::memory_order_relaxed);
+    double latency = (now - node->postTime) * 1.0e-6;
+    latencySum += std::max(0.0, latency);
+    stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+    node->invoke(node->callable);
+    node->destroy(node->callable);
+    recycle_node(node);
+    stats.executed++;
+    now = now_ns();
+  }
+  stats.drainMs = (now - start) * 1.0e-6;
+  stats.meanLatencyMs = stats.executed ? latencySum / stats.executed : 0.0;
+  stats.deferred = depth();
+  stats.totalExecuted += stats.executed;
+  stats.heapFallbacks = heap_fallbacks_.load(std::memory_order_relaxed);
+}
+
+void GlTaskQueue::render_panel()
+{
+  if (!ImGui::CollapsingHeader("GL任务队列"))
+    return;
+
+  ImGui::SliderFloat("每帧时间预算 (ms)", &budget_ms_, 0.1f, 16.0f, "%.1f");
+  ImGui::Text("排队 %u, 上一帧执行 %u (%.2f ms), 留到下一帧 %u", depth(), stats_.executed, stats_.drainMs, stats_.deferred);
+  ImGui::Text("等待时间 平均 %.2f ms, 最长 %.2f ms", stats_.meanLatencyMs, stats_.maxLatencyMs);
+  ImGui::Text("累计执行 %llu, 堆分配回退 %llu", static_cast<unsigned long long>(stats_.totalExecuted),
+              static_cast<unsigned long long>(stats_.heapFallbacks));
+}
@@ -0,0 +1,116 @@
+#ifndef __GL_TASK_QUEUE_H
+#define __GL_TASK_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 需要GL上下文的任务队列：任意线程投递（上传、删除、替换资源等），持有GL上下文的线程每帧在时间预算内执行。
+// 无锁多生产者/单消费者链表队列（生产者交换队尾指针后再链接，消费者遇到未链接完的节点时留到下一帧）。
+// 任务节点来自固定大小的节点池（带版本号的无锁空闲链表，避免ABA），可调用对象不超过 kInlineBytes 时
+// 直接构造在节点内，不为每个任务分配堆内存；池用尽或对象过大时才退回到堆分配
+class GlTaskQueue
+{
+public:
+  static constexpr size_t kInlineBytes = 64;
+  static constexpr uint32_t kPoolSize = 1024;
+
+  struct Stats
+  {
+    uint32_t executed = 0;      // 上一帧执行的任务数
+    uint32_t deferred = 0;      // 上一帧因超出预算留到下一帧的任务数
+    double drainMs = 0.0;       // 上一帧执行任务的耗时
+    double meanLatencyMs = 0.0; // 上一帧执行的任务从投递到执行的平均等待
+    double maxLatencyMs = 0.0;
+    uint64_t totalExecuted = 0;
+    uint64_t heapFallbacks = 0; // 池用尽或对象过大而使用堆分配的次数
+  };
+
+private:
+  struct Node
+  {
+    std::atomic<Node *> next{nullptr};
+    std::atomic<uint32_t> nextFree{0}; // 空闲链表中的下一个节点（下标 + 1，0 表示没有）
+    void (*invoke)(void *) = nullptr;
+    void (*destroy)(void *) = nullptr;
+    void *callable = nullptr;
+    int64_t postTime = 0; // steady_clock 纳秒
+    bool pooled = false;
+    alignas(std::max_align_t) unsigned char storage[kInlineBytes];
+  };
+
+  std::unique_ptr<Node[]> pool_;
+  std::atomic<uint64_t> free_head_{0}; // 高32位版本号，低32位节点下标 + 1
+
+  // 生产者交换 head_，消费者从 tail_ 取；stub_ 保证队列非空
+  Node stub_;
+  std::atomic<Node *> head_;
+  Node *tail_;
+
+  std::atomic<uint32_t> depth_{0};
+  std::atomic<uint64_t> heap_fallbacks_{0};
+  float budget_ms_ = 2.0f; // 每帧执行任务的时间预算
+  Stats stats_;
+
+  GlTaskQueue();
+  ~GlTaskQueue();
+  GlTaskQueue(const GlTaskQueue &) = delete;
+  GlTaskQueue &operator=(const GlTaskQueue &) = delete;
+
+  static int64_t now_ns();
+  Node *acquire_node();
+  void recycle_node(Node *node);
+  void push(Node *node);
+  Node *pop();
+
+public:
+  static GlTaskQueue &get_instance()
+  {
+    static GlTaskQueue instance;
+    return instance;
+  }
+
+  // 任意线程调用；task 以 void() 形式在GL线程上执行一次
+  template <typename F>
+  void post(F &&task)
+  {
+    using T = std::decay_t<F>;
+    Node *node = acquire_node();
+    bool heap = !node->pooled;
+    if constexpr (sizeof(T) <= kInlineBytes && alignof(T) <= alignof(std::max_align_t))
+    {
+      node->callable = new (node->storage) T(std::forward<F>(task));
+      node->destroy = [](void *callable)
+      { static_cast<T *>(callable)->~T(); };
+    }
+    else
+    {
+      heap = true;
+      node->callable = new T(std::forward<F>(task));
+      node->destroy = [](void *callable)
+      { delete static_cast<T *>(callable); };
+    }
+    node->invoke = [](void *callable)
+    { (*static_cast<T *>(callable))(); };
+    // 池用尽与对象过大可能同时发生，每个任务只计一次
+    if (heap)
+      heap_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    push(node);
+  }
+
+  // GL线程每帧调用：至少执行一个任务，之后超出预算即停止，剩余任务留到下一帧
+  void run();
+
+  uint32_t depth() const { return depth_.load(std::memory_order_relaxed); }
+  void setBudgetMs(float ms) { budget_ms_ = ms; }
+  float budgetMs() const { return budget_ms_; }
+  const Stats &stats() const { return stats_; }
+
+  void render_panel();
+};
+
+#endif
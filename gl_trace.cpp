@@ -0,0 +1,643 @@
+#include <glad/glad.h>
+#include "gl_trace.h"
+#include "gl_trace_hook.h"
+#include "gl_task_queue.h"
+#include "imgui.h"
+#include "imgui_stdlib.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// ---------------------------------------------------------------------------
+// 钩子安装
+// ---------------------------------------------------------------------------
+
+#define GL_TRACE_APP_HOOK(name) GlHook<GlTraceSource::App, GlCall::name, decltype(glad_gl##name)>
+
+static void hookGlad(bool install)
+{
+#define GL_TRACE_HOOK_GLAD(name, category, captured) \
+  if (install)                                       \
+    GL_TRACE_APP_HOOK(name)::install(&glad_gl##name); \
+  else                                               \
+    GL_TRACE_APP_HOOK(name)::uninstall();
+  GL_TRACE_CALLS(GL_TRACE_HOOK_GLAD)
+#undef GL_TRACE_HOOK_GLAD
+}
+
+void GlTrace::install()
+{
+  if (installed_)
+    return;
+  hookGlad(true);
+  glTraceHookImGui(true);
+  installed_ = true;
+}
+
+void GlTrace::uninstall()
+{
+  if (!installed_)
+    return;
+  hookGlad(false);
+  glTraceHookImGui(false);
+  installed_ = false;
+  capturing_ = false;
+  captureRequested_ = false;
+}
+
+// ---------------------------------------------------------------------------
+// 帧统计
+// ---------------------------------------------------------------------------
+
+void GlTrace::beginFrame()
+{
+  std::memset(counts_, 0, sizeof(counts_));
+  if (!installed_ || !captureRequested_)
+    return;
+
+  captureRequested_ = false;
+  capture_ = gltrace::Capture();
+  refBuffers_.clear();
+  refTextures_.clear();
+  refVaos_.clear();
+  refPrograms_.clear();
+  newBuffers_.clear();
+  newTextures_.clear();
+  newVaos_.clear();
+  captureBaseline();
+  capturing_ = true;
+}
+
+void GlTrace::endFrame()
+{
+  std::memcpy(lastCounts_, counts_, sizeof(counts_));
+  if (capturing_)
+  {
+    capturing_ = false;
+    finishCapture();
+  }
+}
+
+uint32_t GlTrace::lastCategoryCount(GlTraceSource source, GlCategory category) const
+{
+  uint32_t total = 0;
+  for (int i = 0; i < kGlCallCount; i++)
+  {
+    if (glCallCategory(static_cast<GlCall>(i)) == category)
+      total += lastCounts_[static_cast<int>(source)][i];
+  }
+  return total;
+}
+
+void GlTrace::requestCapture(const std::string &path)
+{
+  capturePath_ = path;
+  captureRequested_ = true;
+}
+
+// ---------------------------------------------------------------------------
+// 着色器源码影子状态
+// ---------------------------------------------------------------------------
+
+void GlTrace::trackProgram(GlCall call, GlArg result, const GlArg *args)
+{
+  switch (call)
+  {
+  case GlCall::CreateShader:
+    shaderTypes_[static_cast<uint32_t>(result.i)] = static_cast<int32_t>(args[0].i);
+    break;
+  case GlCall::ShaderSource:
+  {
+    uint32_t shader = static_cast<uint32_t>(args[0].i);
+    GLsizei count = static_cast<GLsizei>(args[1].i);
+    const GLchar *const *strings = static_cast<const GLchar *const *>(args[2].p);
+    const GLint *lengths = static_cast<const GLint *>(args[3].p);
+    std::string source;
+    for (GLsizei i = 0; i < count; i++)
+    {
+      if (lengths && lengths[i] >= 0)
+        source.append(strings[i], lengths[i]);
+      else
+        source.append(strings[i]);
+    }
+    shaderSources_[shader] = std::move(source);
+    break;
+  }
+  case GlCall::AttachShader:
+    attachedShaders_[static_cast<uint32_t>(args[0].i)].push_back(static_cast<uint32_t>(args[1].i));
+    break;
+  case GlCall::LinkProgram:
+  {
+    uint32_t program = static_cast<uint32_t>(args[0].i);
+    auto &sources = programSources_[program];
+    sources.clear();
+    for (uint32_t shader : attachedShaders_[program])
+    {
+      auto source = shaderSources_.find(shader);
+      auto type = shaderTypes_.find(shader);
+      if (source != shaderSources_.end() && type != shaderTypes_.end())
+        sources.emplace_back(type->second, source->second);
+    }
+    attachedShaders_.erase(program);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// 帧捕获
+// ---------------------------------------------------------------------------
+
+static size_t pixelBytes(GLenum format, GLenum type)
+{
+  size_t components = 4;
+  switch (format)
+  {
+  case GL_RED:
+  case GL_DEPTH_COMPONENT:
+    components = 1;
+    break;
+  case GL_RG:
+    components = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+    components = 3;
+    break;
+  default:
+    break;
+  }
+
+  size_t size = 1;
+  switch (type)
+  {
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    size = 2;
+    break;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    size = 4;
+    break;
+  default:
+    break;
+  }
+  return components * size;
+}
+
+void GlTrace::captureCall(GlTraceSource source, GlCall call, const GlArg *args, int argc)
+{
+  if (!glCallCaptured(call))
+    return;
+
+  gltrace::Command command;
+  command.call = call;
+  command.source = source;
+  command.args.assign(args, args + argc);
+
+  auto copyBlob = [&command](const void *data, size_t size)
+  {
+    if (data && size > 0)
+    {
+      const uint8_t *bytes = static_cast<const uint8_t *>(data);
+      command.blob.assign(bytes, bytes + size);
+    }
+  };
+  // 按当前的 GL_UNPACK_* 状态计算客户端像素数据大小；绑定了PBO时指针是偏移量，无需复制
+  auto copyPixels = [&](int width, int height, int format, int type, const GlArg &pixels)
+  {
+    if (unpackBuffer_ != 0 || !pixels.p || width <= 0 || height <= 0)
+      return;
+    size_t bpp = pixelBytes(format, type);
+    size_t rowPixels = unpackRowLength_ > 0 ? unpackRowLength_ : width;
+    size_t align = std::max(1, unpackAlignment_);
+    size_t rowBytes = (rowPixels * bpp + align - 1) / align * align;
+    copyBlob(pixels.p, rowBytes * (height - 1) + width * bpp);
+  };
+  auto addRef = [](std::set<uint32_t> &refs, const std::set<uint32_t> &created, int64_t id)
+  {
+    if (id != 0 && !created.count(static_cast<uint32_t>(id)))
+      refs.insert(static_cast<uint32_t>(id));
+  };
+
+  switch (call)
+  {
+  case GlCall::BindVertexArray:
+    addRef(refVaos_, newVaos_, args[0].i);
+    break;
+  case GlCall::BindBuffer:
+    if (args[0].i == GL_PIXEL_UNPACK_BUFFER)
+      unpackBuffer_ = static_cast<uint32_t>(args[1].i);
+    addRef(refBuffers_, newBuffers_, args[1].i);
+    break;
+  case GlCall::BindTexture:
+    // 快照只支持2D纹理，纹理数组页不读回（回放时采样结果为黑色）
+    if (args[0].i == GL_TEXTURE_2D)
+      addRef(refTextures_, newTextures_, args[1].i);
+    break;
+  case GlCall::UseProgram:
+    if (args[0].i != 0)
+      refPrograms_.insert(static_cast<uint32_t>(args[0].i));
+    break;
+  case GlCall::PixelStorei:
+    if (args[0].i == GL_UNPACK_ROW_LENGTH)
+      unpackRowLength_ = static_cast<int32_t>(args[1].i);
+    else if (args[0].i == GL_UNPACK_ALIGNMENT)
+      unpackAlignment_ = static_cast<int32_t>(args[1].i);
+    break;
+  case GlCall::BufferData:
+    copyBlob(args[2].p, static_cast<size_t>(args[1].i));
+    break;
+  case GlCall::BufferSubData:
+    copyBlob(args[3].p, static_cast<size_t>(args[2].i));
+    break;
+  case GlCall::TexImage2D:
+    copyPixels(static_cast<int>(args[3].i), static_cast<int>(args[4].i), static_cast<int>(args[6].i),
+               static_cast<int>(args[7].i), args[8]);
+    break;
+  case GlCall::TexSubImage2D:
+    copyPixels(static_cast<int>(args[4].i), static_cast<int>(args[5].i), static_cast<int>(args[6].i),
+               static_cast<int>(args[7].i), args[8]);
+    break;
+  case GlCall::TexImage3D:
+    copyPixels(static_cast<int>(args[3].i), static_cast<int>(args[4].i * args[5].i), static_cast<int>(args[7].i),
+               static_cast<int>(args[8].i), args[9]);
+    break;
+  case GlCall::TexSubImage3D:
+    copyPixels(static_cast<int>(args[5].i), static_cast<int>(args[6].i * args[7].i), static_cast<int>(args[8].i),
+               static_cast<int>(args[9].i), args[10]);
+    break;
+  case GlCall::CompressedTexImage3D:
+    if (unpackBuffer_ == 0)
+      copyBlob(args[8].p, static_cast<size_t>(args[7].i));
+    break;
+  case GlCall::CompressedTexSubImage3D:
+    if (unpackBuffer_ == 0)
+      copyBlob(args[10].p, static_cast<size_t>(args[9].i));
+    break;
+  case GlCall::CompressedTexImage2D:
+    if (unpackBuffer_ == 0)
+      copyBlob(args[7].p, static_cast<size_t>(args[6].i));
+    break;
+  case GlCall::CompressedTexSubImage2D:
+    if (unpackBuffer_ == 0)
+      copyBlob(args[8].p, static_cast<size_t>(args[7].i));
+    break;
+  case GlCall::Uniform1iv:
+  case GlCall::Uniform1fv:
+    copyBlob(args[2].p, args[1].i * 4);
+    break;
+  case GlCall::Uniform2fv:
+    copyBlob(args[2].p, args[1].i * 8);
+    break;
+  case GlCall::Uniform3fv:
+    copyBlob(args[2].p, args[1].i * 12);
+    break;
+  case GlCall::Uniform4fv:
+    copyBlob(args[2].p, args[1].i * 16);
+    break;
+  case GlCall::UniformMatrix3fv:
+    copyBlob(args[3].p, args[1].i * 36);
+    break;
+  case GlCall::UniformMatrix4fv:
+    copyBlob(args[3].p, args[1].i * 64);
+    break;
+  case GlCall::GenBuffers:
+  case GlCall::GenVertexArrays:
+  case GlCall::GenTextures:
+  {
+    copyBlob(args[1].p, args[0].i * sizeof(GLuint));
+    std::set<uint32_t> &created = call == GlCall::GenBuffers        ? newBuffers_
+                                  : call == GlCall::GenVertexArrays ? newVaos_
+                                                                    : newTextures_;
+    const GLuint *names = static_cast<const GLuint *>(args[1].p);
+    for (int64_t i = 0; i < args[0].i; i++)
+      created.insert(names[i]);
+    break;
+  }
+  case GlCall::DeleteBuffers:
+  case GlCall::DeleteVertexArrays:
+  case GlCall::DeleteTextures:
+    copyBlob(args[1].p, args[0].i * sizeof(GLuint));
+    break;
+  default:
+    break;
+  }
+
+  capture_.commands.push_back(std::move(command));
+}
+
+void GlTrace::captureBaseline()
+{
+  bypass_ = true;
+  gltrace::BaselineState &state = capture_.baseline;
+  glGetIntegerv(GL_VIEWPORT, state.viewport);
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, state.clearColor);
+  state.depthTest = glIsEnabled(GL_DEPTH_TEST);
+  state.cullFace = glIsEnabled(GL_CULL_FACE);
+  state.blend = glIsEnabled(GL_BLEND);
+  state.scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+  GLboolean depthMask = GL_TRUE;
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+  state.depthMask = depthMask;
+  glGetIntegerv(GL_CULL_FACE_MODE, &state.cullMode);
+  glGetIntegerv(GL_FRONT_FACE, &state.frontFace);
+  glGetIntegerv(GL_DEPTH_FUNC, &state.depthFunc);
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &state.unpackRowLength);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &state.unpackAlignment);
+  GLint unpackBuffer = 0;
+  glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+  unpackRowLength_ = state.unpackRowLength;
+  unpackAlignment_ = state.unpackAlignment;
+  unpackBuffer_ = static_cast<uint32_t>(unpackBuffer);
+  bypass_ = false;
+}
+
+// 帧结束后读回帧内引用、但在帧之前创建的对象
+void GlTrace::snapshotResources()
+{
+  GLint lastVao = 0, lastTexture = 0, lastPackBuffer = 0, lastPackAlignment = 4;
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &lastVao);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &lastPackBuffer);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &lastPackAlignment);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  // VAO：属性格式与引用的缓冲
+  for (uint32_t id : refVaos_)
+  {
+    if (!glIsVertexArray(id))
+      continue;
+    glBindVertexArray(id);
+    gltrace::VaoSnapshot vao;
+    vao.id = id;
+    GLint elementBuffer = 0;
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementBuffer);
+    vao.elementBuffer = static_cast<uint32_t>(elementBuffer);
+    if (elementBuffer && !newBuffers_.count(vao.elementBuffer))
+      refBuffers_.insert(vao.elementBuffer);
+
+    GLint maxAttribs = 16;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs);
+    for (GLint i = 0; i < maxAttribs; i++)
+    {
+      GLint enabled = 0;
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+      if (!enabled)
+        continue;
+      gltrace::VertexAttribSnapshot attrib;
+      GLint value = 0;
+      attrib.index = i;
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_SIZE, &attrib.size);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_TYPE, &attrib.type);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &attrib.stride);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &value);
+      attrib.normalized = static_cast<uint8_t>(value);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &value);
+      attrib.integer = static_cast<uint8_t>(value);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, &value);
+      attrib.divisor = static_cast<uint32_t>(value);
+      glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &value);
+      attrib.buffer = static_cast<uint32_t>(value);
+      void *offset = nullptr;
+      glGetVertexAttribPointerv(i, GL_VERTEX_ATTRIB_ARRAY_POINTER, &offset);
+      attrib.offset = reinterpret_cast<uintptr_t>(offset);
+      if (attrib.buffer && !newBuffers_.count(attrib.buffer))
+        refBuffers_.insert(attrib.buffer);
+      vao.attribs.push_back(attrib);
+    }
+    capture_.vaos.push_back(std::move(vao));
+  }
+  glBindVertexArray(lastVao);
+
+  // 缓冲内容（经由 GL_COPY_READ_BUFFER 读回，不影响其它绑定点）
+  GLint lastCopyRead = 0;
+  glGetIntegerv(GL_COPY_READ_BUFFER, &lastCopyRead); // 3.3中绑定查询即使用 GL_COPY_READ_BUFFER
+  for (uint32_t id : refBuffers_)
+  {
+    if (!glIsBuffer(id))
+      continue;
+    gltrace::BufferSnapshot buffer;
+    buffer.id = id;
+    glBindBuffer(GL_COPY_READ_BUFFER, id);
+    GLint size = 0;
+    glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+    buffer.data.resize(size);
+    if (size > 0)
+      glGetBufferSubData(GL_COPY_READ_BUFFER, 0, size, buffer.data.data());
+    capture_.buffers.push_back(std::move(buffer));
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, lastCopyRead);
+
+  // 纹理：基础层按RGBA8读回
+  for (uint32_t id : refTextures_)
+  {
+    if (!glIsTexture(id))
+      continue;
+    glBindTexture(GL_TEXTURE_2D, id);
+    gltrace::TextureSnapshot texture;
+    texture.id = id;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texture.width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &texture.height);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &texture.minFilter);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &texture.magFilter);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &texture.wrapS);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &texture.wrapT);
+    if (texture.width > 0 && texture.height > 0)
+    {
+      texture.rgba.resize(size_t(texture.width) * texture.height * 4);
+      glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.rgba.data());
+    }
+    capture_.textures.push_back(std::move(texture));
+  }
+  glBindTexture(GL_TEXTURE_2D, lastTexture);
+
+  // 程序：着色器源码、属性位置与当前uniform值
+  for (uint32_t id : refPrograms_)
+  {
+    if (!glIsProgram(id))
+      continue;
+    gltrace::ProgramSnapshot program;
+    program.id = id;
+
+    GLuint shaders[8];
+    GLsizei shaderCount = 0;
+    glGetAttachedShaders(id, 8, &shaderCount, shaders);
+    for (GLsizei i = 0; i < shaderCount; i++)
+    {
+      GLint type = 0, length = 0;
+      glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type);
+      glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length);
+      std::string source(std::max(length, 1), '\0');
+      glGetShaderSource(shaders[i], length, nullptr, &source[0]);
+      source.resize(std::max(length, 1) - 1);
+      program.shaders.emplace_back(type, source);
+    }
+    if (program.shaders.empty())
+    {
+      // 已分离着色器的程序（如ImGui）使用链接时记录的源码
+      auto recorded = programSources_.find(id);
+      if (recorded != programSources_.end())
+        program.shaders = recorded->second;
+    }
+
+    GLint count = 0;
+    GLchar name[256];
+    glGetProgramiv(id, GL_ACTIVE_ATTRIBUTES, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+      GLint size = 0;
+      GLenum type = 0;
+      glGetActiveAttrib(id, i, sizeof(name), nullptr, &size, &type, name);
+      GLint location = glGetAttribLocation(id, name);
+      if (location >= 0)
+        program.attribs.emplace_back(name, location);
+    }
+
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+      GLint size = 0;
+      GLenum type = 0;
+      glGetActiveUniform(id, i, sizeof(name), nullptr, &size, &type, name);
+      gltrace::UniformSnapshot uniform;
+      uniform.name = name;
+      uniform.location = glGetUniformLocation(id, name);
+      uniform.type = static_cast<int32_t>(type);
+      if (uniform.location < 0)
+        continue;
+      uniform.value.resize(16 * sizeof(float));
+      bool isFloat = type == GL_FLOAT || type == GL_FLOAT_VEC2 || type == GL_FLOAT_VEC3 || type == GL_FLOAT_VEC4 ||
+                     type == GL_FLOAT_MAT3 || type == GL_FLOAT_MAT4;
+      if (isFloat)
+        glGetUniformfv(id, uniform.location, reinterpret_cast<GLfloat *>(uniform.value.data()));
+      else
+        glGetUniformiv(id, uniform.location, reinterpret_cast<GLint *>(uniform.value.data()));
+      program.uniforms.push_back(std::move(uniform));
+    }
+    capture_.programs.push_back(std::move(program));
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, lastPackBuffer);
+  glPixelStorei(GL_PACK_ALIGNMENT, lastPackAlignment);
+}
+
+void GlTrace::finishCapture()
+{
+  bypass_ = true;
+  snapshotResources();
+  bypass_ = false;
+
+  size_t missingShaders = 0;
+  for (const gltrace::ProgramSnapshot &program : capture_.programs)
+  {
+    if (program.shaders.empty())
+      missingShaders++;
+  }
+
+  char status[256];
+  if (gltrace::writeCapture(capturePath_, capture_))
+  {
+    snprintf(status, sizeof(status), "已捕获 %zu 条命令，%zu 缓冲 / %zu 纹理 / %zu VAO / %zu 程序", capture_.commands.size(),
+             capture_.buffers.size(), capture_.textures.size(), capture_.vaos.size(), capture_.programs.size());
+    if (missingShaders > 0)
+      std::cout << "警告: " << missingShaders << " 个程序缺少着色器源码（请使用 --gl-trace 在启动时启用跟踪）" << std::endl;
+  }
+  else
+  {
+    snprintf(status, sizeof(status), "无法写入捕获文件: %s", capturePath_.c_str());
+  }
+  lastCaptureStatus_ = status;
+  std::cout << lastCaptureStatus_ << std::endl;
+  capture_ = gltrace::Capture();
+}
+
+// ---------------------------------------------------------------------------
+// 面板
+// ---------------------------------------------------------------------------
+
+void GlTrace::render_panel()
+{
+  if (!ImGui::CollapsingHeader("GL调用统计"))
+    return;
+
+  // 替换函数指针须在GL线程上进行：渲染线程模式下面板构建时渲染线程可能正在不持锁地提交
+  bool enabled = installed_;
+  if (ImGui::Checkbox("启用跟踪", &enabled))
+  {
+    GlTaskQueue::get_instance().post([this, enabled]()
+                                     {
+                                       if (enabled)
+                                         install();
+                                       else
+                                         uninstall(); });
+  }
+  if (!installed_)
+  {
+    ImGui::TextDisabled("以 --gl-trace 启动可同时记录ImGui的着色器，以便完整捕获");
+    return;
+  }
+
+  if (ImGui::BeginTable("gl_trace_categories", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+  {
+    ImGui::TableSetupColumn("分类");
+    ImGui::TableSetupColumn("App");
+    ImGui::TableSetupColumn("ImGui");
+    ImGui::TableHeadersRow();
+    uint32_t totals[kGlSourceCount] = {};
+    for (int c = 0; c < kGlCategoryCount; c++)
+    {
+      GlCategory category = static_cast<GlCategory>(c);
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(glCategoryName(category));
+      for (int s = 0; s < kGlSourceCount; s++)
+      {
+        uint32_t count = lastCategoryCount(static_cast<GlTraceSource>(s), category);
+        totals[s] += count;
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", count);
+      }
+    }
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted("合计");
+    for (int s = 0; s < kGlSourceCount; s++)
+    {
+      ImGui::TableNextColumn();
+      ImGui::Text("%u", totals[s]);
+    }
+    ImGui::EndTable();
+  }
+
+  // 调用最多的函数
+  std::vector<std::pair<uint32_t, int>> top;
+  for (int i = 0; i < kGlCallCount; i++)
+  {
+    uint32_t total = lastCounts_[0][i] + lastCounts_[1][i];
+    if (total > 0)
+      top.emplace_back(total, i);
+  }
+  std::sort(top.rbegin(), top.rend());
+  for (size_t i = 0; i < top.size() && i < 8; i++)
+  {
+    GlCall call = static_cast<GlCall>(top[i].second);
+    ImGui::BulletText("%s: %u (App %u, ImGui %u)", glCallName(call), top[i].first, lastCount(GlTraceSource::App, call),
+                      lastCount(GlTraceSource::ImGui, call));
+  }
+
+  static std::string capture_path = "frame.gltrace";
+  ImGui::InputText("捕获文件", &capture_path);
+  ImGui::SameLine();
+  if (ImGui::Button(isCapturing() ? "捕获中..." : "捕获下一帧") && !isCapturing())
+  {
+    requestCapture(capture_path);
+  }
+  if (!lastCaptureStatus_.empty())
+    ImGui::TextWrapped("%s", lastCaptureStatus_.c_str());
+}
@@ -0,0 +1,95 @@
+#ifndef __GL_TRACE_H
+#define __GL_TRACE_H
+
+#include "gl_trace_format.h"
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// GL调用跟踪：替换glad与ImGui后端加载器中的函数指针，按分类统计每帧调用次数，
+// 并可将一帧的命令流连同其引用的资源捕获到文件，由 gl_trackball_replay 离线回放。
+// 默认不安装，不安装时没有任何额外开销。
+class GlTrace
+{
+private:
+  bool installed_ = false;
+  bool bypass_ = false; // 快照读回期间不统计、不捕获
+
+  uint32_t counts_[kGlSourceCount][kGlCallCount] = {};     // 当前帧
+  uint32_t lastCounts_[kGlSourceCount][kGlCallCount] = {}; // 上一完整帧
+
+  // 帧捕获
+  std::string capturePath_;
+  bool captureRequested_ = false;
+  bool capturing_ = false;
+  gltrace::Capture capture_;
+  std::set<uint32_t> refBuffers_, refTextures_, refVaos_, refPrograms_; // 帧内引用的已有对象
+  std::set<uint32_t> newBuffers_, newTextures_, newVaos_;               // 帧内创建的对象
+  int32_t unpackRowLength_ = 0;
+  int32_t unpackAlignment_ = 4;
+  uint32_t unpackBuffer_ = 0;
+  std::string lastCaptureStatus_;
+
+  // 着色器源码影子状态：ImGui链接后会分离着色器，只能在创建时记录
+  std::map<uint32_t, int32_t> shaderTypes_;
+  std::map<uint32_t, std::string> shaderSources_;
+  std::map<uint32_t, std::vector<uint32_t>> attachedShaders_;
+  std::map<uint32_t, std::vector<std::pair<int32_t, std::string>>> programSources_;
+
+  GlTrace() = default;
+  GlTrace(const GlTrace &) = delete;
+  GlTrace &operator=(const GlTrace &) = delete;
+
+  void captureCall(GlTraceSource source, GlCall call, const GlArg *args, int argc);
+  void trackProgram(GlCall call, GlArg result, const GlArg *args);
+  void captureBaseline();
+  void snapshotResources();
+  void finishCapture();
+
+public:
+  static GlTrace &get_instance()
+  {
+    static GlTrace instance;
+    return instance;
+  }
+
+  // 安装/卸载钩子；ImGui部分需在 ImGui_ImplOpenGL3_Init 之后安装
+  void install();
+  void uninstall();
+  bool isInstalled() const { return installed_; }
+
+  void beginFrame();
+  void endFrame();
+
+  // 钩子入口（热路径）
+  void onCall(GlTraceSource source, GlCall call, GlArg result, const GlArg *args, int argc)
+  {
+    if (bypass_)
+      return;
+    counts_[static_cast<int>(source)][static_cast<int>(call)]++;
+    if (glCallCategory(call) == GlCategory::Program)
+      trackProgram(call, result, args);
+    else if (capturing_)
+      captureCall(source, call, args, argc);
+  }
+
+  // 在下一帧开始时捕获，帧结束后写入文件
+  void requestCapture(const std::string &path);
+  bool isCapturing() const { return captureRequested_ || capturing_; }
+
+  uint32_t lastCount(GlTraceSource source, GlCall call) const
+  {
+    return lastCounts_[static_cast<int>(source)][static_cast<int>(call)];
+  }
+  uint32_t lastCategoryCount(GlTraceSource source, GlCategory category) const;
+
+  void render_panel();
+};
+
+// 由 gl_trace_imgui.cpp 实现：该编译单元只包含ImGui的GL加载器而不包含glad
+void glTraceHookImGui(bool install);
+
+#endif
@@ -0,0 +1,481 @@
+#ifndef __GL_TRACE_FORMAT_H
+#define __GL_TRACE_FORMAT_H
+
+// GL调用跟踪的公共定义与捕获文件格式（不依赖任何GL头文件，
+// 供应用、ImGui后端钩子与独立回放工具共用）
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class GlCategory : uint8_t
+{
+  Draw,    // 绘制与清屏
+  Bind,    // 对象绑定
+  Uniform, // uniform 上传
+  Upload,  // 缓冲/纹理数据上传
+  State,   // 固定管线状态与顶点格式
+  Object,  // 对象创建/删除
+  Program, // 着色器创建与链接（仅用于记录着色器源码）
+  Query,   // 查询（不进入捕获流）
+  Count
+};
+
+// 被跟踪的GL函数：X(函数名去掉gl前缀, 分类, 是否写入捕获流)
+#define GL_TRACE_CALLS(X)                       \
+  X(DrawArrays, Draw, true)                     \
+  X(DrawElements, Draw, true)                   \
+  X(DrawElementsBaseVertex, Draw, true)         \
+  X(DrawArraysInstanced, Draw, true)            \
+  X(DrawElementsInstanced, Draw, true)          \
+  X(Clear, Draw, true)                          \
+  X(BindVertexArray, Bind, true)                \
+  X(BindBuffer, Bind, true)                     \
+  X(BindTexture, Bind, true)                    \
+  X(ActiveTexture, Bind, true)                  \
+  X(UseProgram, Bind, true)                     \
+  X(BindFramebuffer, Bind, true)                \
+  X(BindSampler, Bind, true)                    \
+  X(Uniform1i, Uniform, true)                   \
+  X(Uniform1f, Uniform, true)                   \
+  X(Uniform2f, Uniform, true)                   \
+  X(Uniform3f, Uniform, true)                   \
+  X(Uniform4f, Uniform, true)                   \
+  X(Uniform1iv, Uniform, true)                  \
+  X(Uniform1fv, Uniform, true)                  \
+  X(Uniform2fv, Uniform, true)                  \
+  X(Uniform3fv, Uniform, true)                  \
+  X(Uniform4fv, Uniform, true)                  \
+  X(UniformMatrix3fv, Uniform, true)            \
+  X(UniformMatrix4fv, Uniform, true)            \
+  X(BufferData, Upload, true)                   \
+  X(BufferSubData, Upload, true)                \
+  X(TexImage2D, Upload, true)                   \
+  X(TexSubImage2D, Upload, true)                \
+  X(CompressedTexImage2D, Upload, true)         \
+  X(CompressedTexSubImage2D, Upload, true)      \
+  X(TexImage3D, Upload, true)                   \
+  X(TexSubImage3D, Upload, true)                \
+  X(CompressedTexImage3D, Upload, true)         \
+  X(CompressedTexSubImage3D, Upload, true)      \
+  X(MapBufferRange, Upload, false)              \
+  X(UnmapBuffer, Upload, false)                 \
+  X(GenerateMipmap, Upload, true)               \
+  X(PixelStorei, Upload, true)                  \
+  X(Enable, State, true)                        \
+  X(Disable, State, true)                       \
+  X(BlendEquation, State, true)                 \
+  X(BlendEquationSeparate, State, true)         \
+  X(BlendFunc, State, true)                     \
+  X(BlendFuncSeparate, State, true)             \
+  X(Viewport, State, true)                      \
+  X(Scissor, State, true)                       \
+  X(PolygonMode, State, true)                   \
+  X(CullFace, State, true)                      \
+  X(FrontFace, State, true)                     \
+  X(DepthFunc, State, true)                     \
+  X(DepthMask, State, true)                     \
+  X(ClearColor, State, true)                    \
+  X(TexParameteri, State, true)                 \
+  X(VertexAttribPointer, State, true)           \
+  X(VertexAttribIPointer, State, true)          \
+  X(VertexAttribDivisor, State, true)           \
+  X(EnableVertexAttribArray, State, true)       \
+  X(DisableVertexAttribArray, State, true)      \
+  X(GenBuffers, Object, true)                   \
+  X(DeleteBuffers, Object, true)                \
+  X(GenVertexArrays, Object, true)              \
+  X(DeleteVertexArrays, Object, true)           \
+  X(GenTextures, Object, true)                  \
+  X(DeleteTextures, Object, true)               \
+  X(CreateShader, Program, false)               \
+  X(ShaderSource, Program, false)               \
+  X(AttachShader, Program, false)               \
+  X(LinkProgram, Program, false)                \
+  X(GetUniformLocation, Query, false)           \
+  X(GetIntegerv, Query, false)                  \
+  X(GetError, Query, false)                     \
+  X(IsEnabled, Query, false)                    \
+  X(BeginQuery, Query, false)                   \
+  X(EndQuery, Query, false)                     \
+  X(GetQueryObjectiv, Query, false)             \
+  X(GetQueryObjectui64v, Query, false)          \
+  X(FenceSync, Query, false)                    \
+  X(ClientWaitSync, Query, false)               \
+  X(DeleteSync, Query, false)
+
+enum class GlCall : uint16_t
+{
+#define GL_TRACE_ENUM(name, category, captured) name,
+  GL_TRACE_CALLS(GL_TRACE_ENUM)
+#undef GL_TRACE_ENUM
+      Count
+};
+
+constexpr int kGlCallCount = static_cast<int>(GlCall::Count);
+constexpr int kGlCategoryCount = static_cast<int>(GlCategory::Count);
+
+enum class GlTraceSource : uint8_t
+{
+  App,   // 经由glad调用（应用代码）
+  ImGui, // 经由ImGui后端自带的加载器调用
+  Count
+};
+
+constexpr int kGlSourceCount = static_cast<int>(GlTraceSource::Count);
+
+inline const char *glCallName(GlCall call)
+{
+  static const char *names[] = {
+#define GL_TRACE_NAME(name, category, captured) "gl" #name,
+      GL_TRACE_CALLS(GL_TRACE_NAME)
+#undef GL_TRACE_NAME
+  };
+  return names[static_cast<int>(call)];
+}
+
+inline GlCategory glCallCategory(GlCall call)
+{
+  static const GlCategory categories[] = {
+#define GL_TRACE_CATEGORY(name, category, captured) GlCategory::category,
+      GL_TRACE_CALLS(GL_TRACE_CATEGORY)
+#undef GL_TRACE_CATEGORY
+  };
+  return categories[static_cast<int>(call)];
+}
+
+inline bool glCallCaptured(GlCall call)
+{
+  static const bool captured[] = {
+#define GL_TRACE_CAPTURED(name, category, captured) captured,
+      GL_TRACE_CALLS(GL_TRACE_CAPTURED)
+#undef GL_TRACE_CAPTURED
+  };
+  return captured[static_cast<int>(call)];
+}
+
+inline const char *glCategoryName(GlCategory category)
+{
+  static const char *names[] = {"Draw", "Bind", "Uniform", "Upload", "State", "Object", "Program", "Query"};
+  return names[static_cast<int>(category)];
+}
+
+// 一个调用参数：整数/枚举、浮点数或指针（指针在捕获流中按整数保存）
+union GlArg
+{
+  int64_t i;
+  double f;
+  const void *p;
+  GlArg() : i(0) {}
+};
+
+// ---------------------------------------------------------------------------
+// 捕获文件
+// ---------------------------------------------------------------------------
+
+namespace gltrace
+{
+  constexpr char kMagic[8] = {'G', 'L', 'T', 'R', 'A', 'C', 'E', '1'};
+
+  // 捕获开始时的固定状态
+  struct BaselineState
+  {
+    int32_t viewport[4] = {0, 0, 0, 0};
+    float clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    uint8_t depthTest = 0, cullFace = 0, blend = 0, scissorTest = 0, depthMask = 1;
+    int32_t cullMode = 0, frontFace = 0, depthFunc = 0;
+    int32_t unpackRowLength = 0, unpackAlignment = 4;
+  };
+
+  struct BufferSnapshot
+  {
+    uint32_t id = 0;
+    std::vector<uint8_t> data;
+  };
+
+  // 纹理按RGBA8读回，回放时按需重新生成mipmap
+  struct TextureSnapshot
+  {
+    uint32_t id = 0;
+    int32_t width = 0, height = 0;
+    int32_t minFilter = 0, magFilter = 0, wrapS = 0, wrapT = 0;
+    std::vector<uint8_t> rgba;
+  };
+
+  struct VertexAttribSnapshot
+  {
+    uint32_t index = 0;
+    uint8_t normalized = 0, integer = 0;
+    int32_t size = 0, type = 0, stride = 0;
+    uint32_t buffer = 0;
+    uint64_t offset = 0;
+    uint32_t divisor = 0;
+  };
+
+  // 只记录已启用的属性
+  struct VaoSnapshot
+  {
+    uint32_t id = 0;
+    uint32_t elementBuffer = 0;
+    std::vector<VertexAttribSnapshot> attribs;
+  };
+
+  struct UniformSnapshot
+  {
+    std::string name;
+    int32_t location = -1;
+    int32_t type = 0;
+    std::vector<uint8_t> value; // glGetUniformfv/iv 读回的原始值
+  };
+
+  struct ProgramSnapshot
+  {
+    uint32_t id = 0;
+    std::vector<std::pair<int32_t, std::string>> shaders; // (着色器类型, 源码)
+    std::vector<std::pair<std::string, int32_t>> attribs; // (名称, 位置)
+    std::vector<UniformSnapshot> uniforms;
+  };
+
+  struct Command
+  {
+    GlCall call = GlCall::Count;
+    GlTraceSource source = GlTraceSource::App;
+    std::vector<GlArg> args;
+    std::vector<uint8_t> blob; // 指针参数指向的数据（顶点、像素、uniform值、对象名）
+  };
+
+  struct Capture
+  {
+    BaselineState baseline;
+    std::vector<BufferSnapshot> buffers;
+    std::vector<TextureSnapshot> textures;
+    std::vector<VaoSnapshot> vaos;
+    std::vector<ProgramSnapshot> programs;
+    std::vector<Command> commands;
+  };
+
+  class Writer
+  {
+  private:
+    std::ofstream &out_;
+
+  public:
+    explicit Writer(std::ofstream &out) : out_(out) {}
+    void bytes(const void *data, size_t size) { out_.write(static_cast<const char *>(data), size); }
+    template <typename T>
+    void pod(const T &value) { bytes(&value, sizeof(T)); }
+    void blob(const std::vector<uint8_t> &data)
+    {
+      pod<uint64_t>(data.size());
+      bytes(data.data(), data.size());
+    }
+    void str(const std::string &text)
+    {
+      pod<uint32_t>(static_cast<uint32_t>(text.size()));
+      bytes(text.data(), text.size());
+    }
+  };
+
+  class Reader
+  {
+  private:
+    std::ifstream &in_;
+
+  public:
+    explicit Reader(std::ifstream &in) : in_(in) {}
+    bool ok() const { return static_cast<bool>(in_); }
+    void bytes(void *data, size_t size) { in_.read(static_cast<char *>(data), size); }
+    template <typename T>
+    T pod()
+    {
+      T value{};
+      bytes(&value, sizeof(T));
+      return value;
+    }
+    void blob(std::vector<uint8_t> &data)
+    {
+      uint64_t size = pod<uint64_t>();
+      if (!ok())
+        return;
+      data.resize(size);
+      bytes(data.data(), size);
+    }
+    void str(std::string &text)
+    {
+      uint32_t size = pod<uint32_t>();
+      if (!ok())
+        return;
+      text.resize(size);
+      bytes(&text[0], size);
+    }
+  };
+
+  inline bool writeCapture(const std::string &path, const Capture &capture)
+  {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      return false;
+
+    Writer w(file);
+    w.bytes(kMagic, sizeof(kMagic));
+    w.pod(capture.baseline);
+
+    w.pod<uint32_t>(static_cast<uint32_t>(capture.buffers.size()));
+    for (const BufferSnapshot &buffer : capture.buffers)
+    {
+      w.pod(buffer.id);
+      w.blob(buffer.data);
+    }
+
+    w.pod<uint32_t>(static_cast<uint32_t>(capture.textures.size()));
+    for (const TextureSnapshot &texture : capture.textures)
+    {
+      w.pod(texture.id);
+      w.pod(texture.width);
+      w.pod(texture.height);
+      w.pod(texture.minFilter);
+      w.pod(texture.magFilter);
+      w.pod(texture.wrapS);
+      w.pod(texture.wrapT);
+      w.blob(texture.rgba);
+    }
+
+    w.pod<uint32_t>(static_cast<uint32_t>(capture.vaos.size()));
+    for (const VaoSnapshot &vao : capture.vaos)
+    {
+      w.pod(vao.id);
+      w.pod(vao.elementBuffer);
+      w.pod<uint32_t>(static_cast<uint32_t>(vao.attribs.size()));
+      for (const VertexAttribSnapshot &attrib : vao.attribs)
+        w.pod(attrib);
+    }
+
+    w.pod<uint32_t>(static_cast<uint32_t>(capture.programs.size()));
+    for (const ProgramSnapshot &program : capture.programs)
+    {
+      w.pod(program.id);
+      w.pod<uint32_t>(static_cast<uint32_t>(program.shaders.size()));
+      for (const auto &shader : program.shaders)
+      {
+        w.pod(shader.first);
+        w.str(shader.second);
+      }
+      w.pod<uint32_t>(static_cast<uint32_t>(program.attribs.size()));
+      for (const auto &attrib : program.attribs)
+      {
+        w.str(attrib.first);
+        w.pod(attrib.second);
+      }
+      w.pod<uint32_t>(static_cast<uint32_t>(program.uniforms.size()));
+      for (const UniformSnapshot &uniform : program.uniforms)
+      {
+        w.str(uniform.name);
+        w.pod(uniform.location);
+        w.pod(uniform.type);
+        w.blob(uniform.value);
+      }
+    }
+
+    w.pod<uint32_t>(static_cast<uint32_t>(capture.commands.size()));
+    for (const Command &command : capture.commands)
+    {
+      w.pod(command.call);
+      w.pod(command.source);
+      w.pod<uint8_t>(static_cast<uint8_t>(command.args.size()));
+      for (const GlArg &arg : command.args)
+        w.pod(arg.i);
+      w.blob(command.blob);
+    }
+    return static_cast<bool>(file);
+  }
+
+  inline bool readCapture(const std::string &path, Capture &capture)
+  {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+      return false;
+
+    Reader r(file);
+    char magic[sizeof(kMagic)];
+    r.bytes(magic, sizeof(magic));
+    if (!r.ok() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+      return false;
+    capture.baseline = r.pod<BaselineState>();
+
+    capture.buffers.resize(r.pod<uint32_t>());
+    for (BufferSnapshot &buffer : capture.buffers)
+    {
+      buffer.id = r.pod<uint32_t>();
+      r.blob(buffer.data);
+    }
+
+    capture.textures.resize(r.pod<uint32_t>());
+    for (TextureSnapshot &texture : capture.textures)
+    {
+      texture.id = r.pod<uint32_t>();
+      texture.width = r.pod<int32_t>();
+      texture.height = r.pod<int32_t>();
+      texture.minFilter = r.pod<int32_t>();
+      texture.magFilter = r.pod<int32_t>();
+      texture.wrapS = r.pod<int32_t>();
+      texture.wrapT = r.pod<int32_t>();
+      r.blob(texture.rgba);
+    }
+
+    capture.vaos.resize(r.pod<uint32_t>());
+    for (VaoSnapshot &vao : capture.vaos)
+    {
+      vao.id = r.pod<uint32_t>();
+      vao.elementBuffer = r.pod<uint32_t>();
+      vao.attribs.resize(r.pod<uint32_t>());
+      for (VertexAttribSnapshot &attrib : vao.attribs)
+        attrib = r.pod<VertexAttribSnapshot>();
+    }
+
+    capture.programs.resize(r.pod<uint32_t>());
+    for (ProgramSnapshot &program : capture.programs)
+    {
+      program.id = r.pod<uint32_t>();
+      program.shaders.resize(r.pod<uint32_t>());
+      for (auto &shader : program.shaders)
+      {
+        shader.first = r.pod<int32_t>();
+        r.str(shader.second);
+      }
+      program.attribs.resize(r.pod<uint32_t>());
+      for (auto &attrib : program.attribs)
+      {
+        r.str(attrib.first);
+        attrib.second = r.pod<int32_t>();
+      }
+      program.uniforms.resize(r.pod<uint32_t>());
+      for (UniformSnapshot &uniform : program.uniforms)
+      {
+        r.str(uniform.name);
+        uniform.location = r.pod<int32_t>();
+        uniform.type = r.pod<int32_t>();
+        r.blob(uniform.value);
+      }
+      if (!r.ok())
+        return false;
+    }
+
+    capture.commands.resize(r.pod<uint32_t>());
+    for (Command &command : capture.commands)
+    {
+      command.call = r.pod<GlCall>();
+      command.source = r.pod<GlTraceSource>();
+      command.args.resize(r.pod<uint8_t>());
+      for (GlArg &arg : command.args)
+        arg.i = r.pod<int64_t>();
+      r.blob(command.blob);
+      if (!r.ok() || command.call >= GlCall::Count)
+        return false;
+    }
+    return r.ok();
+  }
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __GL_TRACE_HOOK_H
+#define __GL_TRACE_HOOK_H
+
+// 函数指针钩子模板，需在包含GL加载器头文件（glad或ImGui的gl3w）之后包含
+#include "gl_trace.h"
+#include <array>
+#include <type_traits>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+template <typename T>
+inline GlArg glTraceArg(T value)
+{
+  GlArg arg;
+  if constexpr (std::is_pointer_v<T>)
+    arg.p = reinterpret_cast<const void *>(value);
+  else if constexpr (std::is_floating_point_v<T>)
+    arg.f = value;
+  else
+    arg.i = static_cast<int64_t>(value);
+  return arg;
+}
+
+// 每个 (来源, 函数) 一个实例：保存原函数指针，包装函数先调用原函数再记录（以便取得返回值与生成的对象名）
+template <GlTraceSource Source, GlCall Call, typename Fn>
+struct GlHook;
+
+template <GlTraceSource Source, GlCall Call, typename R, typename... Args>
+struct GlHook<Source, Call, R(APIENTRY *)(Args...)>
+{
+  using Fn = R(APIENTRY *)(Args...);
+  static inline Fn *slot = nullptr;
+  static inline Fn original = nullptr;
+
+  static R APIENTRY call(Args... args)
+  {
+    if constexpr (std::is_void_v<R>)
+    {
+      original(args...);
+      record(GlArg(), args...);
+    }
+    else
+    {
+      R result = original(args...);
+      record(glTraceArg(result), args...);
+      return result;
+    }
+  }
+
+  static void record(GlArg result, Args... args)
+  {
+    const std::array<GlArg, sizeof...(Args)> packed = {glTraceArg(args)...};
+    GlTrace::get_instance().onCall(Source, Call, result, packed.data(), static_cast<int>(packed.size()));
+  }
+
+  static void install(Fn *target)
+  {
+    if (slot || !target || !*target)
+      return;
+    slot = target;
+    original = *target;
+    *target = &call;
+  }
+
+  static void uninstall()
+  {
+    if (!slot)
+      return;
+    *slot = original;
+    slot = nullptr;
+  }
+};
+
+#endif
@@ -0,0 +1,63 @@
+// ImGui后端使用自带的gl3w加载器（imgl3wProcs），与glad的头文件互相冲突，
+// 因此在单独的编译单元中替换其函数指针
+#include "imgui_impl_opengl3_loader.h"
+#include "gl_trace_hook.h"
+
+#define GL_TRACE_IMGUI_HOOK(name) GlHook<GlTraceSource::ImGui, GlCall::name, decltype(imgl3wProcs.gl.name)>
+
+// ImGui加载器中存在、且在 GL_TRACE_CALLS 中的函数
+#define GL_TRACE_IMGUI_CALLS(X)  \
+  X(ActiveTexture)               \
+  X(AttachShader)                \
+  X(BindBuffer)                  \
+  X(BindSampler)                 \
+  X(BindTexture)                 \
+  X(BindVertexArray)             \
+  X(BlendEquation)               \
+  X(BlendEquationSeparate)       \
+  X(BlendFuncSeparate)           \
+  X(BufferData)                  \
+  X(BufferSubData)               \
+  X(Clear)                       \
+  X(ClearColor)                  \
+  X(CreateShader)                \
+  X(DeleteBuffers)               \
+  X(DeleteTextures)              \
+  X(DeleteVertexArrays)          \
+  X(Disable)                     \
+  X(DisableVertexAttribArray)    \
+  X(DrawElements)                \
+  X(DrawElementsBaseVertex)      \
+  X(Enable)                      \
+  X(EnableVertexAttribArray)     \
+  X(GenBuffers)                  \
+  X(GenTextures)                 \
+  X(GenVertexArrays)             \
+  X(GetError)                    \
+  X(GetIntegerv)                 \
+  X(GetUniformLocation)          \
+  X(IsEnabled)                   \
+  X(LinkProgram)                 \
+  X(PixelStorei)                 \
+  X(PolygonMode)                 \
+  X(Scissor)                     \
+  X(ShaderSource)                \
+  X(TexImage2D)                  \
+  X(TexParameteri)               \
+  X(TexSubImage2D)               \
+  X(Uniform1i)                   \
+  X(UniformMatrix4fv)            \
+  X(UseProgram)                  \
+  X(VertexAttribPointer)         \
+  X(Viewport)
+
+void glTraceHookImGui(bool install)
+{
+#define GL_TRACE_HOOK_IMGUI(name)                           \
+  if (install)                                              \
+    GL_TRACE_IMGUI_HOOK(name)::install(&imgl3wProcs.gl.name); \
+  else                                                      \
+    GL_TRACE_IMGUI_HOOK(name)::uninstall();
+  GL_TRACE_IMGUI_CALLS(GL_TRACE_HOOK_IMGUI)
+#undef GL_TRACE_HOOK_IMGUI
+}
@@ -0,0 +1,618 @@
+// gl_trackball_replay：离线回放 GL 帧捕获文件，用于在没有应用逻辑的情况下分析驱动开销
+//
+//   gl_trackball_replay <capture.gltrace> [--loops <次数>] [--warmup <次数>] [--visible]
+//
+// 每轮依次执行捕获的命令流，统计CPU提交耗时与GPU耗时，结果以一行JSON输出
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "gl_trace_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+  // 捕获中的对象名到回放上下文中对象名的映射
+  struct ObjectMap
+  {
+    std::map<uint32_t, uint32_t> names;
+    uint32_t missing = 0; // 引用了捕获中不存在的对象
+
+    GLuint get(int64_t id)
+    {
+      if (id == 0)
+        return 0;
+      auto it = names.find(static_cast<uint32_t>(id));
+      if (it == names.end())
+      {
+        missing++;
+        return 0;
+      }
+      return it->second;
+    }
+  };
+
+  class Replayer
+  {
+  private:
+    const gltrace::Capture &capture_;
+    ObjectMap buffers_, textures_, vaos_, programs_;
+    std::map<GLuint, std::map<GLint, GLint>> uniformLocations_; // 回放程序 -> (捕获位置 -> 回放位置)
+    GLuint currentProgram_ = 0;
+    uint32_t skippedDraws_ = 0;
+
+    GLint location(int64_t captured)
+    {
+      auto program = uniformLocations_.find(currentProgram_);
+      if (program == uniformLocations_.end())
+        return -1;
+      auto it = program->second.find(static_cast<GLint>(captured));
+      return it == program->second.end() ? -1 : it->second;
+    }
+
+    // 有blob时指针参数指向blob，否则保持原值（缓冲偏移量或空指针）
+    static const void *data(const gltrace::Command &command, int index)
+    {
+      return command.blob.empty() ? command.args[index].p : command.blob.data();
+    }
+
+    GLuint compileProgram(const gltrace::ProgramSnapshot &snapshot)
+    {
+      GLuint program = glCreateProgram();
+      std::vector<GLuint> shaders;
+      for (const auto &source : snapshot.shaders)
+      {
+        GLuint shader = glCreateShader(source.first);
+        const char *text = source.second.c_str();
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok)
+        {
+          char log[512];
+          glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+          std::cerr << "着色器编译失败 (程序 " << snapshot.id << "): " << log << std::endl;
+        }
+        glAttachShader(program, shader);
+        shaders.push_back(shader);
+      }
+      // 保持与捕获时相同的属性位置，命令流中的 glVertexAttribPointer 才能对应
+      for (const auto &attrib : snapshot.attribs)
+        glBindAttribLocation(program, attrib.second, attrib.first.c_str());
+      glLinkProgram(program);
+      for (GLuint shader : shaders)
+      {
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+      }
+      GLint ok = 0;
+      glGetProgramiv(program, GL_LINK_STATUS, &ok);
+      if (!ok)
+      {
+        char log[512];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "程序链接失败 (程序 " << snapshot.id << "): " << log << std::endl;
+      }
+      return program;
+    }
+
+    void restoreUniform(GLint location, const gltrace::UniformSnapshot &uniform)
+    {
+      const GLfloat *f = reinterpret_cast<const GLfloat *>(uniform.value.data());
+      const GLint *i = reinterpret_cast<const GLint *>(uniform.value.data());
+      switch (uniform.type)
+      {
+      case GL_FLOAT:
+        glUniform1fv(location, 1, f);
+        break;
+      case GL_FLOAT_VEC2:
+        glUniform2fv(location, 1, f);
+        break;
+      case GL_FLOAT_VEC3:
+        glUniform3fv(location, 1, f);
+        break;
+      case GL_FLOAT_VEC4:
+        glUniform4fv(location, 1, f);
+        break;
+      case GL_FLOAT_MAT3:
+        glUniformMatrix3fv(location, 1, GL_FALSE, f);
+        break;
+      case GL_FLOAT_MAT4:
+        glUniformMatrix4fv(location, 1, GL_FALSE, f);
+        break;
+      default: // int/bool/sampler
+        glUniform1iv(location, 1, i);
+        break;
+      }
+    }
+
+  public:
+    explicit Replayer(const gltrace::Capture &capture) : capture_(capture) {}
+
+    uint32_t missingObjects() const
+    {
+      return buffers_.missing + textures_.missing + vaos_.missing + programs_.missing;
+    }
+    uint32_t skippedDraws() const { return skippedDraws_; }
+
+    // 重建捕获帧之前已存在的资源
+    void createResources()
+    {
+      for (const gltrace::BufferSnapshot &snapshot : capture_.buffers)
+      {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, snapshot.data.size(), snapshot.data.data(), GL_STATIC_DRAW);
+        buffers_.names[snapshot.id] = buffer;
+      }
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      for (const gltrace::TextureSnapshot &snapshot : capture_.textures)
+      {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, snapshot.width, snapshot.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     snapshot.rgba.empty() ? nullptr : snapshot.rgba.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, snapshot.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, snapshot.magFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, snapshot.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, snapshot.wrapT);
+        if (snapshot.minFilter != GL_LINEAR && snapshot.minFilter != GL_NEAREST)
+          glGenerateMipmap(GL_TEXTURE_2D);
+        textures_.names[snapshot.id] = texture;
+      }
+      glBindTexture(GL_TEXTURE_2D, 0);
+
+      for (const gltrace::VaoSnapshot &snapshot : capture_.vaos)
+      {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        for (const gltrace::VertexAttribSnapshot &attrib : snapshot.attribs)
+        {
+          glBindBuffer(GL_ARRAY_BUFFER, buffers_.get(attrib.buffer));
+          const void *offset = reinterpret_cast<const void *>(static_cast<uintptr_t>(attrib.offset));
+          if (attrib.integer)
+            glVertexAttribIPointer(attrib.index, attrib.size, attrib.type, attrib.stride, offset);
+          else
+            glVertexAttribPointer(attrib.index, attrib.size, attrib.type, attrib.normalized, attrib.stride, offset);
+          glVertexAttribDivisor(attrib.index, attrib.divisor);
+          glEnableVertexAttribArray(attrib.index);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_.get(snapshot.elementBuffer));
+        vaos_.names[snapshot.id] = vao;
+      }
+      glBindVertexArray(0);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      for (const gltrace::ProgramSnapshot &snapshot : capture_.programs)
+      {
+        if (snapshot.shaders.empty())
+        {
+          std::cerr << "程序 " << snapshot.id << " 缺少着色器源码，使用它的绘制将被跳过" << std::endl;
+          continue;
+        }
+        GLuint program = compileProgram(snapshot);
+        programs_.names[snapshot.id] = program;
+        glUseProgram(program);
+        auto &locations = uniformLocations_[program];
+        for (const gltrace::UniformSnapshot &uniform : snapshot.uniforms)
+        {
+          GLint location = glGetUniformLocation(program, uniform.name.c_str());
+          locations[uniform.location] = location;
+          if (location >= 0)
+            restoreUniform(location, uniform);
+        }
+      }
+      glUseProgram(0);
+    }
+
+    void applyBaseline()
+    {
+      const gltrace::BaselineState &state = capture_.baseline;
+      glViewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+      glClearColor(state.clearColor[0], state.clearColor[1], state.clearColor[2], state.clearColor[3]);
+      auto enable = [](GLenum cap, bool on)
+      {
+        if (on)
+          glEnable(cap);
+        else
+          glDisable(cap);
+      };
+      enable(GL_DEPTH_TEST, state.depthTest);
+      enable(GL_CULL_FACE, state.cullFace);
+      enable(GL_BLEND, state.blend);
+      enable(GL_SCISSOR_TEST, state.scissorTest);
+      glDepthMask(state.depthMask);
+      glCullFace(state.cullMode);
+      glFrontFace(state.frontFace);
+      glDepthFunc(state.depthFunc);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, state.unpackRowLength);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, state.unpackAlignment);
+    }
+
+    void execute(const gltrace::Command &c)
+    {
+      const GlArg *a = c.args.data();
+      auto i = [a](int index)
+      { return static_cast<GLint>(a[index].i); };
+      auto u = [a](int index)
+      { return static_cast<GLuint>(a[index].i); };
+      auto e = [a](int index)
+      { return static_cast<GLenum>(a[index].i); };
+      auto f = [a](int index)
+      { return static_cast<GLfloat>(a[index].f); };
+      auto ptr = [a](int index)
+      { return a[index].p; };
+      auto names = [&c]()
+      { return reinterpret_cast<const GLuint *>(c.blob.data()); };
+      bool drawable = currentProgram_ != 0 || programs_.names.empty();
+
+      switch (c.call)
+      {
+      case GlCall::DrawArrays:
+        if (drawable)
+          glDrawArrays(e(0), i(1), i(2));
+        else
+          skippedDraws_++;
+        break;
+      case GlCall::DrawElements:
+        if (drawable)
+          glDrawElements(e(0), i(1), e(2), ptr(3));
+        else
+          skippedDraws_++;
+        break;
+      case GlCall::DrawElementsBaseVertex:
+        if (drawable)
+          glDrawElementsBaseVertex(e(0), i(1), e(2), ptr(3), i(4));
+        else
+          skippedDraws_++;
+        break;
+      case GlCall::DrawArraysInstanced:
+        if (drawable)
+          glDrawArraysInstanced(e(0), i(1), i(2), i(3));
+        else
+          skippedDraws_++;
+        break;
+      case GlCall::DrawElementsInstanced:
+        if (drawable)
+          glDrawElementsInstanced(e(0), i(1), e(2), ptr(3), i(4));
+        else
+          skippedDraws_++;
+        break;
+      case GlCall::Clear:
+        glClear(u(0));
+        break;
+      case GlCall::BindVertexArray:
+        glBindVertexArray(vaos_.get(a[0].i));
+        break;
+      case GlCall::BindBuffer:
+        glBindBuffer(e(0), buffers_.get(a[1].i));
+        break;
+      case GlCall::BindTexture:
+        glBindTexture(e(0), textures_.get(a[1].i));
+        break;
+      case GlCall::ActiveTexture:
+        glActiveTexture(e(0));
+        break;
+      case GlCall::UseProgram:
+        currentProgram_ = programs_.get(a[0].i);
+        glUseProgram(currentProgram_);
+        break;
+      case GlCall::BindFramebuffer:
+        // 只回放默认帧缓冲
+        if (a[1].i == 0)
+          glBindFramebuffer(e(0), 0);
+        break;
+      case GlCall::BindSampler:
+        glBindSampler(u(0), 0);
+        break;
+      case GlCall::Uniform1i:
+        glUniform1i(location(a[0].i), i(1));
+        break;
+      case GlCall::Uniform1f:
+        glUniform1f(location(a[0].i), f(1));
+        break;
+      case GlCall::Uniform2f:
+        glUniform2f(location(a[0].i), f(1), f(2));
+        break;
+      case GlCall::Uniform3f:
+        glUniform3f(location(a[0].i), f(1), f(2), f(3));
+        break;
+      case GlCall::Uniform4f:
+        glUniform4f(location(a[0].i), f(1), f(2), f(3), f(4));
+        break;
+      case GlCall::Uniform1iv:
+        glUniform1iv(location(a[0].i), i(1), reinterpret_cast<const GLint *>(data(c, 2)));
+        break;
+      case GlCall::Uniform1fv:
+        glUniform1fv(location(a[0].i), i(1), reinterpret_cast<const GLfloat *>(data(c, 2)));
+        break;
+      case GlCall::Uniform2fv:
+        glUniform2fv(location(a[0].i), i(1), reinterpret_cast<const GLfloat *>(data(c, 2)));
+        break;
+      case GlCall::Uniform3fv:
+        glUniform3fv(location(a[0].i), i(1), reinterpret_cast<const GLfloat *>(data(c, 2)));
+        break;
+      case GlCall::Uniform4fv:
+        glUniform4fv(location(a[0].i), i(1), reinterpret_cast<const GLfloat *>(data(c, 2)));
+        break;
+      case GlCall::UniformMatrix3fv:
+        glUniformMatrix3fv(location(a[0].i), i(1), static_cast<GLboolean>(a[2].i),
+                           reinterpret_cast<const GLfloat *>(data(c, 3)));
+        break;
+      case GlCall::UniformMatrix4fv:
+        glUniformMatrix4fv(location(a[0].i), i(1), static_cast<GLboolean>(a[2].i),
+                           reinterpret_cast<const GLfloat *>(data(c, 3)));
+        break;
+      case GlCall::BufferData:
+        glBufferData(e(0), static_cast<GLsizeiptr>(a[1].i), c.blob.empty() ? nullptr : c.blob.data(), e(3));
+        break;
+      case GlCall::BufferSubData:
+        if (!c.blob.empty())
+          glBufferSubData(e(0), static_cast<GLintptr>(a[1].i), static_cast<GLsizeiptr>(a[2].i), c.blob.data());
+        break;
+      case GlCall::TexImage2D:
+        glTexImage2D(e(0), i(1), i(2), i(3), i(4), i(5), e(6), e(7), data(c, 8));
+        break;
+      case GlCall::TexSubImage2D:
+        glTexSubImage2D(e(0), i(1), i(2), i(3), i(4), i(5), e(6), e(7), data(c, 8));
+        break;
+      case GlCall::CompressedTexImage2D:
+        glCompressedTexImage2D(e(0), i(1), e(2), i(3), i(4), i(5), i(6), data(c, 7));
+        break;
+      case GlCall::CompressedTexSubImage2D:
+        glCompressedTexSubImage2D(e(0), i(1), i(2), i(3), i(4), i(5), e(6), i(7), data(c, 8));
+        break;
+      case GlCall::TexImage3D:
+        glTexImage3D(e(0), i(1), i(2), i(3), i(4), i(5), i(6), e(7), e(8), data(c, 9));
+        break;
+      case GlCall::TexSubImage3D:
+        glTexSubImage3D(e(0), i(1), i(2), i(3), i(4), i(5), i(6), i(7), e(8), e(9), data(c, 10));
+        break;
+      case GlCall::CompressedTexImage3D:
+        glCompressedTexImage3D(e(0), i(1), e(2), i(3), i(4), i(5), i(6), i(7), data(c, 8));
+        break;
+      case GlCall::CompressedTexSubImage3D:
+        glCompressedTexSubImage3D(e(0), i(1), i(2), i(3), i(4), i(5), i(6), i(7), e(8), i(9), data(c, 10));
+        break;
+      case GlCall::GenerateMipmap:
+        glGenerateMipmap(e(0));
+        break;
+      case GlCall::PixelStorei:
+        glPixelStorei(e(0), i(1));
+        break;
+      case GlCall::Enable:
+        glEnable(e(0));
+        break;
+      case GlCall::Disable:
+        glDisable(e(0));
+        break;
+      case GlCall::BlendEquation:
+        glBlendEquation(e(0));
+        break;
+      case GlCall::BlendEquationSeparate:
+        glBlendEquationSeparate(e(0), e(1));
+        break;
+      case GlCall::BlendFunc:
+        glBlendFunc(e(0), e(1));
+        break;
+      case GlCall::BlendFuncSeparate:
+        glBlendFuncSeparate(e(0), e(1), e(2), e(3));
+        break;
+      case GlCall::Viewport:
+        glViewport(i(0), i(1), i(2), i(3));
+        break;
+      case GlCall::Scissor:
+        glScissor(i(0), i(1), i(2), i(3));
+        break;
+      case GlCall::PolygonMode:
+        glPolygonMode(e(0), e(1));
+        break;
+      case GlCall::CullFace:
+        glCullFace(e(0));
+        break;
+      case GlCall::FrontFace:
+        glFrontFace(e(0));
+        break;
+      case GlCall::DepthFunc:
+        glDepthFunc(e(0));
+        break;
+      case GlCall::DepthMask:
+        glDepthMask(static_cast<GLboolean>(a[0].i));
+        break;
+      case GlCall::ClearColor:
+        glClearColor(f(0), f(1), f(2), f(3));
+        break;
+      case GlCall::TexParameteri:
+        glTexParameteri(e(0), e(1), i(2));
+        break;
+      case GlCall::VertexAttribPointer:
+        glVertexAttribPointer(u(0), i(1), e(2), static_cast<GLboolean>(a[3].i), i(4), ptr(5));
+        break;
+      case GlCall::VertexAttribIPointer:
+        glVertexAttribIPointer(u(0), i(1), e(2), i(3), ptr(4));
+        break;
+      case GlCall::VertexAttribDivisor:
+        glVertexAttribDivisor(u(0), u(1));
+        break;
+      case GlCall::EnableVertexAttribArray:
+        glEnableVertexAttribArray(u(0));
+        break;
+      case GlCall::DisableVertexAttribArray:
+        glDisableVertexAttribArray(u(0));
+        break;
+      case GlCall::GenBuffers:
+      case GlCall::GenVertexArrays:
+      case GlCall::GenTextures:
+      {
+        ObjectMap &map = c.call == GlCall::GenBuffers ? buffers_ : c.call == GlCall::GenVertexArrays ? vaos_ : textures_;
+        GLsizei n = i(0);
+        std::vector<GLuint> created(n);
+        if (c.call == GlCall::GenBuffers)
+          glGenBuffers(n, created.data());
+        else if (c.call == GlCall::GenVertexArrays)
+          glGenVertexArrays(n, created.data());
+        else
+          glGenTextures(n, created.data());
+        for (GLsizei k = 0; k < n && c.blob.size() >= (k + 1) * sizeof(GLuint); k++)
+          map.names[names()[k]] = created[k];
+        break;
+      }
+      case GlCall::DeleteBuffers:
+      case GlCall::DeleteVertexArrays:
+      case GlCall::DeleteTextures:
+      {
+        ObjectMap &map = c.call == GlCall::DeleteBuffers ? buffers_ : c.call == GlCall::DeleteVertexArrays ? vaos_ : textures_;
+        GLsizei n = static_cast<GLsizei>(c.blob.size() / sizeof(GLuint));
+        for (GLsizei k = 0; k < n; k++)
+        {
+          auto it = map.names.find(names()[k]);
+          if (it == map.names.end())
+            continue;
+          GLuint name = it->second;
+          if (c.call == GlCall::DeleteBuffers)
+            glDeleteBuffers(1, &name);
+          else if (c.call == GlCall::DeleteVertexArrays)
+            glDeleteVertexArrays(1, &name);
+          else
+            glDeleteTextures(1, &name);
+          map.names.erase(it);
+        }
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  };
+
+  double median(std::vector<double> values)
+  {
+    if (values.empty())
+      return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = nullptr;
+  int loops = 100;
+  int warmup = 5;
+  bool visible = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+      loops = std::max(1, std::atoi(argv[++i]));
+    else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+      warmup = std::max(0, std::atoi(argv[++i]));
+    else if (std::strcmp(argv[i], "--visible") == 0)
+      visible = true;
+    else if (!path)
+      path = argv[i];
+    else
+      std::cerr << "未知参数: " << argv[i] << std::endl;
+  }
+  if (!path)
+  {
+    std::cerr << "用法: gl_trackball_replay <capture.gltrace> [--loops N] [--warmup N] [--visible]" << std::endl;
+    return 1;
+  }
+
+  gltrace::Capture capture;
+  if (!gltrace::readCapture(path, capture))
+  {
+    std::cerr << "无法读取捕获文件: " << path << std::endl;
+    return 1;
+  }
+
+  if (!glfwInit())
+  {
+    std::cerr << "Fail initalize GLFW" << std::endl;
+    return 1;
+  }
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+  glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+  int width = std::max(1, capture.baseline.viewport[2]);
+  int height = std::max(1, capture.baseline.viewport[3]);
+  GLFWwindow *window = glfwCreateWindow(width, height, "gl_trackball_replay", nullptr, nullptr);
+  if (!window)
+  {
+    std::cerr << "Fail create GLFW window" << std::endl;
+    glfwTerminate();
+    return 1;
+  }
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(0);
+  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+  {
+    std::cerr << "Fail initalize GLAD" << std::endl;
+    return 1;
+  }
+
+  Replayer replayer(capture);
+  replayer.createResources();
+  glFinish();
+
+  GLuint query = 0;
+  glGenQueries(1, &query);
+  std::vector<double> cpuMs, gpuMs;
+  for (int loop = 0; loop < warmup + loops; loop++)
+  {
+    replayer.applyBaseline();
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    auto start = std::chrono::steady_clock::now();
+    for (const gltrace::Command &command : capture.commands)
+      replayer.execute(command);
+    auto end = std::chrono::steady_clock::now();
+    glEndQuery(GL_TIME_ELAPSED);
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+    if (visible)
+      glfwSwapBuffers(window);
+    glfwPollEvents();
+
+    if (loop >= warmup)
+    {
+      cpuMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+      gpuMs.push_back(elapsed / 1.0e6);
+    }
+  }
+  glDeleteQueries(1, &query);
+
+  size_t calls[kGlSourceCount] = {};
+  for (const gltrace::Command &command : capture.commands)
+    calls[static_cast<int>(command.source)]++;
+
+  std::ostringstream line;
+  line.setf(std::ios::fixed);
+  line.precision(3);
+  line << "{\"capture\": \"" << path << "\", \"commands\": " << capture.commands.size()
+       << ", \"app_commands\": " << calls[static_cast<int>(GlTraceSource::App)]
+       << ", \"imgui_commands\": " << calls[static_cast<int>(GlTraceSource::ImGui)] << ", \"loops\": " << loops
+       << ", \"cpu_submit_ms_median\": " << median(cpuMs) << ", \"gpu_ms_median\": " << median(gpuMs)
+       << ", \"missing_objects\": " << replayer.missingObjects() << ", \"skipped_draws\": " << replayer.skippedDraws()
+       << "}";
+  std::cout << line.str() << std::endl;
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+  return 0;
+}
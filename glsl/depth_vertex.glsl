@@ -0,0 +1,36 @@
+#version 330 core
+// 深度预渲染：只读位置流，位置计算必须与 vertex.glsl 完全一致（颜色遍以 GL_EQUAL 比较深度）
+layout (location = 0) in vec3 aPos;
+layout (location = 5) in ivec4 aBoneIDs;
+layout (location = 6) in vec4 aWeights;
+layout (location = 7) in mat4 aInstanceModel;
+
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform bool instanced;
+uniform bool skinned;
+uniform samplerBuffer bonePalette;
+uniform int paletteBase;
+
+mat4 boneMatrix(int bone)
+{
+    int texel = (paletteBase + bone) * 4;
+    return mat4(texelFetch(bonePalette, texel), texelFetch(bonePalette, texel + 1),
+                texelFetch(bonePalette, texel + 2), texelFetch(bonePalette, texel + 3));
+}
+
+void main()
+{
+    mat4 world = instanced ? model * aInstanceModel : model;
+    vec4 position = vec4(aPos, 1.0);
+    if (skinned && dot(aWeights, vec4(1.0)) > 0.0)
+    {
+        mat4 skin = aWeights.x * boneMatrix(aBoneIDs.x) + aWeights.y * boneMatrix(aBoneIDs.y) +
+                    aWeights.z * boneMatrix(aBoneIDs.z) + aWeights.w * boneMatrix(aBoneIDs.w);
+        position = skin * position;
+    }
+    gl_Position = projection * view * world * position;
+}
@@ -3,15 +3,50 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 uniform sampler2D texture_diffuse1;
+uniform sampler2DArray texture_diffuse_array;
+uniform int diffuseLayer; // >=0 时漫反射纹理来自纹理数组页的该层
 
 uniform vec3 objectColor;
 uniform vec3 lightColor;
 uniform vec3 lightPos;
 uniform vec3 viewPos;
 
+// 光源：0 点光源（未设置时的默认值，不投射阴影），1 方向光，2 聚光灯
+uniform int lightType;
+uniform vec3 lightDirection; // 方向光与聚光灯轴线的照射方向（单位向量）
+uniform float spotCosOuter;
+uniform float spotCosInner;
+
+// 阴影贴图：lightSpace 把世界坐标变换到光源裁剪空间，PCF 采样 (2*pcfRadius+1)^2 次
+uniform bool shadowsEnabled;
+uniform sampler2DShadow shadowMap;
+uniform mat4 lightSpace;
+uniform float shadowBias;
+uniform int pcfRadius;
+
 in vec3 Normal;
 in vec3 FragPos;
 
+// 返回未被遮挡的比例（1为完全受光）
+float shadowFactor(vec3 norm, vec3 lightDir)
+{
+    vec4 clip = lightSpace * vec4(FragPos, 1.0);
+    vec3 coord = clip.xyz / clip.w * 0.5 + 0.5;
+    if (coord.z > 1.0)
+        return 1.0;
+    // 掠射角越大偏移越大，减轻自阴影条纹
+    float bias = shadowBias * (1.0 + 2.0 * (1.0 - max(dot(norm, lightDir), 0.0)));
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float lit = 0.0;
+    for (int x = -pcfRadius; x <= pcfRadius; x++)
+    {
+        for (int y = -pcfRadius; y <= pcfRadius; y++)
+            lit += texture(shadowMap, vec3(coord.xy + vec2(x, y) * texel, coord.z - bias));
+    }
+    float taps = float((2 * pcfRadius + 1) * (2 * pcfRadius + 1));
+    return lit / taps;
+}
+
 void main()
 {     
     // 检查是否是坐标轴（通过纹理坐标的特殊值来判断）
@@ -37,7 +72,8 @@ void main()
     vec3 baseColor = objectColor;
     
     // 如果有纹理，使用纹理颜色
-    vec3 textureColor = texture(texture_diffuse1, TexCoords).rgb;
+    vec3 textureColor = diffuseLayer >= 0 ? texture(texture_diffuse_array, vec3(TexCoords, diffuseLayer)).rgb
+                                          : texture(texture_diffuse1, TexCoords).rgb;
     if (length(textureColor) > 0.1) {
         baseColor = textureColor;
     }
@@ -47,7 +83,13 @@ void main()
 
     // 漫反射光
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = lightType == 1 ? -lightDirection : normalize(lightPos - FragPos);
+    float attenuation = 1.0;
+    if (lightType == 2)
+    {
+        float theta = dot(-lightDir, lightDirection);
+        attenuation = clamp((theta - spotCosOuter) / max(spotCosInner - spotCosOuter, 1e-4), 0.0, 1.0);
+    }
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
 
@@ -58,6 +100,7 @@ void main()
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 256);
     vec3 specular = specularStrength * spec * lightColor;  
 
-    vec3 result = (ambient + diffuse + specular) * baseColor;
+    float shadow = shadowsEnabled ? shadowFactor(norm, lightDir) : 1.0;
+    vec3 result = (ambient + shadow * attenuation * (diffuse + specular)) * baseColor;
     FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
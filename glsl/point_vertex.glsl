@@ -0,0 +1,20 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;   // 八叉树节点内的16位量化坐标
+layout (location = 1) in vec4 aColor;
+
+out vec3 Color;
+
+uniform mat4 model; // 量化网格坐标 -> 世界
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 nodeMin;   // 节点最小角（量化网格坐标）
+uniform float nodeScale; // 节点内坐标的单位长度
+uniform float pointSize;
+
+void main()
+{
+    vec3 position = nodeMin + aPos * nodeScale;
+    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_PointSize = pointSize;
+    Color = aColor.rgb;
+}
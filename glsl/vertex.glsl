@@ -2,21 +2,47 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+layout (location = 5) in ivec4 aBoneIDs;
+layout (location = 6) in vec4 aWeights;
+layout (location = 7) in mat4 aInstanceModel; // 实例化绘制时每实例的节点世界矩阵（占用位置7~10）
 
 out vec2 TexCoords;
+invariant gl_Position; // 深度预渲染的颜色遍以 GL_EQUAL 比较，与 depth_vertex.glsl 的结果必须逐位相同
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat3 normalMatrix; 
+uniform bool instanced; // 为真时 model 只含整体变换，再乘以每实例矩阵
+uniform bool skinned;   // 为真时按骨骼权重混合 bonePalette 中从 paletteBase 开始的骨骼矩阵
+uniform samplerBuffer bonePalette; // 每个矩阵占4个RGBA32F纹素（按列）
+uniform int paletteBase;
 
 out vec3 Normal;
 out vec3 FragPos;
 
+mat4 boneMatrix(int bone)
+{
+    int texel = (paletteBase + bone) * 4;
+    return mat4(texelFetch(bonePalette, texel), texelFetch(bonePalette, texel + 1),
+                texelFetch(bonePalette, texel + 2), texelFetch(bonePalette, texel + 3));
+}
+
 void main()
 {
+    mat4 world = instanced ? model * aInstanceModel : model;
+    mat3 normalWorld = instanced ? normalMatrix * transpose(inverse(mat3(aInstanceModel))) : normalMatrix;
+    vec4 position = vec4(aPos, 1.0);
+    vec3 normal = aNormal;
+    if (skinned && dot(aWeights, vec4(1.0)) > 0.0)
+    {
+        mat4 skin = aWeights.x * boneMatrix(aBoneIDs.x) + aWeights.y * boneMatrix(aBoneIDs.y) +
+                    aWeights.z * boneMatrix(aBoneIDs.z) + aWeights.w * boneMatrix(aBoneIDs.w);
+        position = skin * position;
+        normal = mat3(skin) * normal;
+    }
     TexCoords = aTexCoords;    
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = normalMatrix * aNormal;
+    gl_Position = projection * view * world * position;
+    FragPos = vec3(world * position);
+    Normal = normalWorld * normal;
 }
\ No newline at end of file
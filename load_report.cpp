@@ -0,0 +1,153 @@
+#include "load_report.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+static std::string jsonEscape(const std::string &text)
+{
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text)
+  {
+    switch (c)
+    {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+        out += buffer;
+      }
+      else
+      {
+        out += c;
+      }
+    }
+  }
+  return out;
+}
+
+void LoadReport::addStage(const std::string &name, double ms, uint64_t count, uint64_t bytes)
+{
+  stages.push_back({name, ms, count, bytes});
+}
+
+const LoadReport::Stage *LoadReport::findStage(const std::string &name) const
+{
+  for (const Stage &stage : stages)
+  {
+    if (stage.name == name)
+      return &stage;
+  }
+  return nullptr;
+}
+
+std::string LoadReport::toJson() const
+{
+  std::ostringstream out;
+  out.setf(std::ios::fixed);
+  out.precision(3);
+
+  auto vec3 = [&out](const glm::vec3 &v)
+  {
+    out << "[" << v.x << ", " << v.y << ", " << v.z << "]";
+  };
+
+  out << "{\n  \"source\": \"" << jsonEscape(source) << "\",\n";
+  out << "  \"total_ms\": " << totalMs << ",\n";
+  out << "  \"bounds\": {\"min\": ";
+  vec3(boundsMin);
+  out << ", \"max\": ";
+  vec3(boundsMax);
+  out << ", \"center\": ";
+  vec3(center);
+  out << ", \"scale_factor\": " << scaleFactor << "},\n";
+
+  out << "  \"stages\": [";
+  for (size_t i = 0; i < stages.size(); i++)
+  {
+    const Stage &stage = stages[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << jsonEscape(stage.name) << "\", \"ms\": " << stage.ms
+        << ", \"count\": " << stage.count << ", \"bytes\": " << stage.bytes << "}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"meshes\": [";
+  for (size_t i = 0; i < meshes.size(); i++)
+  {
+    const MeshStat &mesh = meshes[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << jsonEscape(mesh.name) << "\", \"vertices\": " << mesh.vertices
+        << ", \"indices\": " << mesh.indices << ", \"bytes\": " << mesh.bytes
+        << ", \"convert_ms\": " << mesh.convertMs << ", \"upload_ms\": " << mesh.uploadMs << "}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"textures\": [";
+  for (size_t i = 0; i < textures.size(); i++)
+  {
+    const TextureStat &texture = textures[i];
+    out << (i ? ",\n" : "\n") << "    {\"path\": \"" << jsonEscape(texture.path) << "\", \"loaded\": "
+        << (texture.loaded ? "true" : "false") << ", \"width\": " << texture.width << ", \"height\": " << texture.height
+        << ", \"channels\": " << texture.channels << ", \"format\": \"" << texture.format
+        << "\", \"cache_hit\": " << (texture.cacheHit ? "true" : "false")
+        << ", \"streamed\": " << (texture.streamed ? "true" : "false") << ", \"array_layer\": " << texture.arrayLayer
+        << ", \"bytes\": " << texture.bytes
+        << ", \"gpu_bytes\": " << texture.gpuBytes << ", \"decode_ms\": " << texture.decodeMs
+        << ", \"encode_ms\": " << texture.encodeMs << ", \"upload_ms\": " << texture.uploadMs
+        << ", \"mipmap_ms\": " << texture.mipmapMs << "}";
+  }
+  out << "\n  ]\n}";
+  return out.str();
+}
+
+void LoadReport::render_panel() const
+{
+  if (!ImGui::CollapsingHeader("加载报告"))
+    return;
+
+  ImGui::Text("总耗时: %.1f ms", totalMs);
+  for (const Stage &stage : stages)
+  {
+    if (stage.bytes > 0)
+      ImGui::BulletText("%s: %.2f ms (%llu 项, %.2f MB)", stage.name.c_str(), stage.ms,
+                        (unsigned long long)stage.count, stage.bytes / (1024.0 * 1024.0));
+    else if (stage.count > 0)
+      ImGui::BulletText("%s: %.2f ms (%llu 项)", stage.name.c_str(), stage.ms, (unsigned long long)stage.count);
+    else
+      ImGui::BulletText("%s: %.2f ms", stage.name.c_str(), stage.ms);
+  }
+
+  // 最慢的网格与纹理
+  auto slowestMesh = std::max_element(meshes.begin(), meshes.end(), [](const MeshStat &a, const MeshStat &b)
+                                      { return a.convertMs + a.uploadMs < b.convertMs + b.uploadMs; });
+  if (slowestMesh != meshes.end())
+  {
+    ImGui::Text("最慢网格: %s (%u 顶点, 转换 %.2f ms, 上传 %.2f ms)", slowestMesh->name.c_str(), slowestMesh->vertices,
+                slowestMesh->convertMs, slowestMesh->uploadMs);
+  }
+  auto slowestTexture = std::max_element(textures.begin(), textures.end(), [](const TextureStat &a, const TextureStat &b)
+                                         { return a.decodeMs + a.encodeMs + a.uploadMs + a.mipmapMs <
+                                                  b.decodeMs + b.encodeMs + b.uploadMs + b.mipmapMs; });
+  if (slowestTexture != textures.end())
+  {
+    ImGui::Text("最慢纹理: %s (%dx%d %s, 解码 %.2f ms, 转码 %.2f ms, 上传 %.2f ms, Mipmap %.2f ms)",
+                slowestTexture->path.c_str(), slowestTexture->width, slowestTexture->height,
+                slowestTexture->format.c_str(), slowestTexture->decodeMs, slowestTexture->encodeMs,
+                slowestTexture->uploadMs, slowestTexture->mipmapMs);
+  }
+  ImGui::Text("模型边界: (%.3f, %.3f, %.3f) - (%.3f, %.3f, %.3f)", boundsMin.x, boundsMin.y, boundsMin.z,
+              boundsMax.x, boundsMax.y, boundsMax.z);
+}
@@ -0,0 +1,82 @@
+#ifndef __LOAD_REPORT_H
+#define __LOAD_REPORT_H
+
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 简单计时器（毫秒）
+class LoadTimer
+{
+private:
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  LoadTimer() : start_(std::chrono::steady_clock::now()) {}
+  void reset() { start_ = std::chrono::steady_clock::now(); }
+  double elapsedMs() const
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+  }
+};
+
+// 模型加载各阶段耗时报告
+struct LoadReport
+{
+  struct Stage
+  {
+    std::string name;
+    double ms = 0.0;
+    uint64_t count = 0; // 处理对象数量（网格/纹理/三角形等）
+    uint64_t bytes = 0; // 产生或上传的字节数
+  };
+
+  struct MeshStat
+  {
+    std::string name;
+    uint32_t vertices = 0;
+    uint32_t indices = 0;
+    uint64_t bytes = 0;     // 顶点与索引字节数
+    double convertMs = 0.0; // aiMesh -> Vertex 转换
+    double uploadMs = 0.0;  // 创建GL缓冲并上传
+  };
+
+  struct TextureStat
+  {
+    std::string path;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    uint64_t bytes = 0;    // 解码后的像素字节数（缓存命中时为读取的压缩数据字节数）
+    uint64_t gpuBytes = 0; // 显存占用（含mip链）
+    std::string format;    // RGBA8/RGB8/R8 或 BC1/BC3/BC5
+    double decodeMs = 0.0;
+    double encodeMs = 0.0; // CPU mip生成与块压缩
+    double uploadMs = 0.0;
+    double mipmapMs = 0.0;
+    bool cacheHit = false; // 从转码缓存读取
+    bool streamed = false; // 经 TextureStreamer 分帧上传（uploadMs 只含尾部mip）
+    int arrayLayer = -1;   // 合并进纹理数组页时的层号
+    bool loaded = false;
+  };
+
+  std::string source;
+  std::vector<Stage> stages;
+  std::vector<MeshStat> meshes;
+  std::vector<TextureStat> textures;
+
+  glm::vec3 boundsMin = glm::vec3(0.0f);
+  glm::vec3 boundsMax = glm::vec3(0.0f);
+  glm::vec3 center = glm::vec3(0.0f);
+  float scaleFactor = 1.0f;
+  double totalMs = 0.0;
+
+  void addStage(const std::string &name, double ms, uint64_t count = 0, uint64_t bytes = 0);
+  const Stage *findStage(const std::string &name) const;
+  std::string toJson() const;
+  void render_panel() const; // 在调试面板中显示摘要
+};
+
+#endif
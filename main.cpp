@@ -1,8 +1,95 @@
 #include "app.h"
+#include "asset_archive.h"
+#include "startup.h"
+#include <cstring>
+#include <filesystem>
 
-int main()
+int main(int argc, char **argv)
 {
+  Startup &startup = Startup::get_instance();
+  startup.begin();
+
+  // 创建窗口之前：设置资源根目录、打开资源包，并在工作线程上预取启动时要打开的模型
+  // （命令行指定的模型；没有指定模型、压力场景或回放时为上次打开的模型）。
+  // 命令行给出的模型路径相对于当前目录，转为绝对路径，不按资源根目录解析
+  std::string startupModel;
+  bool explicitScene = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc)
+      AssetArchive::get_instance().setRoot(std::filesystem::absolute(argv[++i]).lexically_normal().generic_string());
+    else if (std::strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+      AssetArchive::get_instance().open(argv[++i]);
+    else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+      startupModel = std::filesystem::absolute(argv[++i]).generic_string();
+    else if (std::strcmp(argv[i], "--stress") == 0 || std::strcmp(argv[i], "--replay") == 0)
+      explicitScene = true;
+  }
+  std::string reopenModel;
+  if (startupModel.empty() && !explicitScene)
+    startupModel = reopenModel = Startup::lastModel();
+  if (!explicitScene)
+    startup.prefetchModel(startupModel);
+
   App &app = App::get_instance();
+
+  // 命令行参数：
+  //   --record <file>        录制操作会话
+  //   --replay <file>        回放操作会话（按录制速度）
+  //   --fast                 全速回放
+  //   --exit-after-replay    回放结束后退出（用于性能回归）
+  //   --model <file>         启动时加载模型
+  //   --stress <参数>        启动时生成压力场景：网格数,每网格三角形数[,材质数,纹理边长,种子]
+  //   --gl-trace             启动时开启GL调用跟踪（可记录ImGui着色器源码，便于离线回放）
+  //   --render-thread        GL渲染放到独立线程，主线程只处理输入与界面
+  //   --pack <file>          从资源包（gl_trackball_pack 生成）读取着色器、字体与模型
+  //   --assets <dir>         资源根目录：资源包中没有的着色器、字体与默认模型从这里读取（默认为源码目录）
+  const char *recordPath = nullptr;
+  const char *replayPath = nullptr;
+  bool fast = false;
+  bool exitAfterReplay = false;
+  std::string modelPath;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+      replayPath = argv[++i];
+    else if (std::strcmp(argv[i], "--fast") == 0)
+      fast = true;
+    else if (std::strcmp(argv[i], "--exit-after-replay") == 0)
+      exitAfterReplay = true;
+    else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+      modelPath = std::filesystem::absolute(argv[++i]).generic_string();
+    else if (std::strcmp(argv[i], "--stress") == 0 && i + 1 < argc)
+    {
+      StressSceneParams params;
+      if (StressSceneParams::parse(argv[++i], params))
+        modelPath = params.toString();
+      else
+        std::cout << "压力场景参数无效: " << argv[i] << std::endl;
+    }
+    else if (std::strcmp(argv[i], "--gl-trace") == 0)
+      GlTrace::get_instance().install();
+    else if (std::strcmp(argv[i], "--render-thread") == 0)
+      app.set_render_thread(true);
+    else if ((std::strcmp(argv[i], "--pack") == 0 || std::strcmp(argv[i], "--assets") == 0) && i + 1 < argc)
+      i++; // 已在创建窗口前处理
+    else
+      std::cout << "未知参数: " << argv[i] << std::endl;
+  }
+
+  if (replayPath)
+    app.start_replay(replayPath, fast, exitAfterReplay);
+  else if (recordPath)
+    app.start_recording(recordPath);
+
+  // 录制开始后再加载，使加载动作写入会话
+  if (!replayPath && modelPath.empty())
+    modelPath = reopenModel;
+  if (!replayPath && !modelPath.empty())
+    app.load_model(modelPath);
+
   app.app_run();
   app.app_exit();
   return 0;
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "shader.h"
+#include "texture_budget.h"
 
 #define MAX_BONE_INFLUENCE 4
 
@@ -27,6 +28,18 @@ struct Texture
   unsigned int id;
   std::string type;
   std::string path;
+  int layer = -1; // >=0 时 id 为 GL_TEXTURE_2D_ARRAY 纹理数组页，纹理位于该层
+};
+
+// 连续绘制之间共享的纹理绑定状态：与上一次绘制相同的纹理（数组页）不再重复绑定
+struct TextureBindings
+{
+  static constexpr int kUnitCount = 8;
+  GLuint units[kUnitCount] = {};
+  GLuint diffuseArray = 0;
+  int diffuseLayer = -2; // 着色器中 diffuseLayer 的当前值（-2表示尚未设置）
+  uint64_t binds = 0;    // 实际发出的 glBindTexture 次数
+  uint64_t skipped = 0;  // 因状态相同而省略的次数
 };
 
 class Mesh
@@ -39,25 +52,54 @@ public:
 public:
   Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
   {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->textures = std::move(textures);
 
     setupMesh();
   }
 
-  void draw(Shader *shader)
+  // 纹理数组页固定绑定在该纹理单元上（与 sampler2D 不能共用同一单元）
+  static constexpr int kDiffuseArrayUnit = TextureBindings::kUnitCount;
+  // 骨骼矩阵纹理缓冲（samplerBuffer）固定使用的纹理单元
+  static constexpr int kBonePaletteUnit = kDiffuseArrayUnit + 1;
+  // 阴影贴图（sampler2DShadow）固定使用的纹理单元
+  static constexpr int kShadowMapUnit = kBonePaletteUnit + 1;
+
+  void draw(Shader *shader, TextureBindings *bindings = nullptr)
   {
+    TextureBindings local;
+    if (!bindings)
+      bindings = &local;
+
     unsigned int diffuseNr = 1;
     unsigned int specularNr = 1;
     unsigned int normalNr = 1;
     unsigned int heightNr = 1;
+    int diffuseLayer = -1;
     for (unsigned int i = 0; i < textures.size(); i++)
     {
-      glActiveTexture(GL_TEXTURE0 + i);
       std::string number;
       std::string name = textures[i].type;
 
+      if (textures[i].layer >= 0)
+      {
+        // 纹理数组页：同页的网格连续绘制时只需更新层号
+        if (bindings->diffuseArray != textures[i].id)
+        {
+          glActiveTexture(GL_TEXTURE0 + kDiffuseArrayUnit);
+          glBindTexture(GL_TEXTURE_2D_ARRAY, textures[i].id);
+          bindings->diffuseArray = textures[i].id;
+          bindings->binds++;
+        }
+        else
+        {
+          bindings->skipped++;
+        }
+        diffuseLayer = textures[i].layer;
+        continue;
+      }
+
       if (name == "texture_diffuse")
         number = std::to_string(diffuseNr++);
       else if (name == "texture_specular")
@@ -68,19 +110,128 @@ public:
         number = std::to_string(heightNr++); // transfer unsigned int to string
 
       glUniform1i(glGetUniformLocation(shader->ID, (name + number).c_str()), i);
+      TextureBudget::get_instance().touch(textures[i].id);
+      if (i < TextureBindings::kUnitCount && bindings->units[i] == textures[i].id)
+      {
+        bindings->skipped++;
+        continue;
+      }
+      glActiveTexture(GL_TEXTURE0 + i);
       glBindTexture(GL_TEXTURE_2D, textures[i].id);
+      if (i < TextureBindings::kUnitCount)
+        bindings->units[i] = textures[i].id;
+      bindings->binds++;
+    }
+    if (bindings->diffuseLayer != diffuseLayer)
+    {
+      shader->setInt("diffuseLayer", diffuseLayer);
+      bindings->diffuseLayer = diffuseLayer;
     }
 
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+    if (instanceCount_ > 0)
+      glDrawElementsInstanced(GL_TRIANGLES, indexCount_, GL_UNSIGNED_INT, 0, instanceCount_);
+    else
+      glDrawElements(GL_TRIANGLES, indexCount_, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
     glActiveTexture(GL_TEXTURE0);
   }
 
+  // 深度预渲染：只读紧凑的位置流（蒙皮与实例属性仍来自原缓冲），不绑定纹理
+  void drawDepth()
+  {
+    glBindVertexArray(depthVAO_);
+    if (instanceCount_ > 0)
+      glDrawElementsInstanced(GL_TRIANGLES, indexCount_, GL_UNSIGNED_INT, 0, instanceCount_);
+    else
+      glDrawElements(GL_TRIANGLES, indexCount_, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+  }
+
+  // 实例化绘制：buffer 中从 offset 起每实例一个 mat4（属性7~10，每实例前进一次）
+  void setInstanceBuffer(GLuint buffer, size_t offset, GLsizei count)
+  {
+    for (GLuint vao : {VAO, depthVAO_})
+    {
+      glBindVertexArray(vao);
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      for (GLuint i = 0; i < 4; i++)
+      {
+        glEnableVertexAttribArray(7 + i);
+        glVertexAttribPointer(7 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              (void *)(offset + sizeof(glm::vec4) * i));
+        glVertexAttribDivisor(7 + i, 1);
+      }
+    }
+    glBindVertexArray(0);
+    instanceCount_ = count;
+  }
+  GLsizei instanceCount() const { return instanceCount_; }
+
+  // 局部坐标包围盒（上传时计算，释放CPU副本后仍可用于视锥剔除）
+  const glm::vec3 &boundsMin() const { return boundsMin_; }
+  const glm::vec3 &boundsMax() const { return boundsMax_; }
+
+  // 排序绘制顺序用的键：漫反射纹理所在的数组页（或2D纹理）
+  GLuint diffuseKey() const
+  {
+    for (const Texture &texture : textures)
+    {
+      if (texture.type == "texture_diffuse")
+        return texture.id;
+    }
+    return 0;
+  }
+
+  // 释放GL对象（Mesh按值拷贝传递，因此不在析构函数中释放）
+  void releaseGL()
+  {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &depthVAO_);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &positionVBO_);
+    glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+    depthVAO_ = positionVBO_ = 0;
+  }
+
+  // 释放CPU端的顶点/索引副本（数据已上传到GPU，绘制不再需要）
+  void releaseCpuData()
+  {
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+  }
+
+  size_t cpuBytes() const { return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int); }
+  size_t gpuBytes() const
+  {
+    return size_t(vertexCount_) * (sizeof(Vertex) + sizeof(glm::vec3)) + size_t(indexCount_) * sizeof(unsigned int);
+  }
+  GLsizei indexCount() const { return indexCount_; }
+
 private:
   GLuint VAO, VBO, EBO;
+  GLuint depthVAO_ = 0;    // 深度预渲染用：位置来自 positionVBO_，共享 EBO
+  GLuint positionVBO_ = 0; // 只含顶点位置的紧凑缓冲（12字节/顶点）
+  GLsizei vertexCount_ = 0; // 已上传的顶点数
+  GLsizei indexCount_ = 0;  // 已上传的索引数（释放CPU副本后绘制仍需要）
+  GLsizei instanceCount_ = 0; // 大于0时实例化绘制
+  glm::vec3 boundsMin_ = glm::vec3(0.0f);
+  glm::vec3 boundsMax_ = glm::vec3(0.0f);
   void setupMesh()
   {
+    vertexCount_ = static_cast<GLsizei>(vertices.size());
+    indexCount_ = static_cast<GLsizei>(indices.size());
+    if (!vertices.empty())
+    {
+      boundsMin_ = boundsMax_ = vertices[0].Position;
+      for (const Vertex &vertex : vertices)
+      {
+        boundsMin_ = glm::min(boundsMin_, vertex.Position);
+        boundsMax_ = glm::max(boundsMax_, vertex.Position);
+      }
+    }
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -114,6 +265,24 @@ private:
     glEnableVertexAttribArray(6);
     glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, m_Weights));
 
+    // 深度预渲染的VAO：位置单独成流，深度遍每顶点只读12字节而不是整个 Vertex
+    std::vector<glm::vec3> positions(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+      positions[i] = vertices[i].Position;
+    glGenVertexArrays(1, &depthVAO_);
+    glGenBuffers(1, &positionVBO_);
+    glBindVertexArray(depthVAO_);
+    glBindBuffer(GL_ARRAY_BUFFER, positionVBO_);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void *)offsetof(Vertex, m_BoneIDs));
+    glEnableVertexAttribArray(6);
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, m_Weights));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
     glBindVertexArray(0);
   }
 };
@@ -1,15 +1,127 @@
 #define STB_IMAGE_IMPLEMENTATION
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <map>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <glm/gtc/matrix_transform.hpp>
 #include <stb/stb_image.h>
 #include "model.h"
+#include "texture_streamer.h"
+#include "texture_budget.h"
+#include "asset_archive.h"
+
+// S3TC（BC1/BC3）枚举不在GL 3.3核心头文件中，需要 GL_EXT_texture_compression_s3tc
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+static bool hasGlExtension(const char *name)
+{
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; i++)
+  {
+    const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+    if (extension && std::strcmp(extension, name) == 0)
+      return true;
+  }
+  return false;
+}
+
+// 贴图在资源包中时直接从映射内存解码
+static unsigned char *loadImage(const std::string &file, int *width, int *height, int *channels, int desired)
+{
+  if (AssetArchive::Blob blob = AssetArchive::get_instance().find(file))
+    return stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(blob.data), static_cast<int>(blob.size), width, height,
+                                 channels, desired);
+  return stbi_load(file.c_str(), width, height, channels, desired);
+}
+
+// aiMatrix4x4 为行主序，glm 为列主序
+static glm::mat4 toGlm(const aiMatrix4x4 &m)
+{
+  return glm::mat4(glm::vec4(m.a1, m.b1, m.c1, m.d1), glm::vec4(m.a2, m.b2, m.c2, m.d2),
+                   glm::vec4(m.a3, m.b3, m.c3, m.d3), glm::vec4(m.a4, m.b4, m.c4, m.d4));
+}
+
+static GLenum glBlockFormat(BlockFormat format)
+{
+  switch (format)
+  {
+  case BlockFormat::BC3:
+    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case BlockFormat::BC5:
+    return GL_COMPRESSED_RG_RGTC2;
+  default:
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+  }
+}
 
-Model::Model(const char *path, bool gamma, bool createModelAxis, bool createWorldAxis)
+// BC5（RGTC）自GL 3.0起为核心功能；BC1/BC3需要S3TC扩展（部分Mesa/嵌入式驱动没有）
+static bool blockFormatSupported(BlockFormat format)
+{
+  if (format == BlockFormat::BC5)
+    return true;
+  static const bool s3tc = hasGlExtension("GL_EXT_texture_compression_s3tc");
+  return s3tc;
+}
+
+Model::Model(const char *path, bool gamma, bool createModelAxis, bool createWorldAxis, const ModelLoadOptions &options)
     : gammaCorection(gamma), showModelAxis(false), showWorldAxis(false),
-      modelAxisLength(1.0f), worldAxisLength(5.0f)
+      modelAxisLength(1.0f), worldAxisLength(5.0f), options_(options)
 {
-  load_model(path);
+  LoadTimer total;
+  load_imported(*importFile(path));
+  create_axes(createModelAxis, createWorldAxis);
+
+  load_report_.totalMs = total.elapsedMs();
+  std::cout << load_report_.toJson() << std::endl;
+}
 
+Model::Model(std::unique_ptr<ImportedScene> imported, bool gamma, bool createModelAxis, bool createWorldAxis,
+             const ModelLoadOptions &options)
+    : gammaCorection(gamma), showModelAxis(false), showWorldAxis(false),
+      modelAxisLength(1.0f), worldAxisLength(5.0f), options_(options)
+{
+  // 导入已在别处完成，总耗时只计本线程上的部分（导入各阶段仍列在报告中）
+  LoadTimer total;
+  load_imported(*imported);
+  imported.reset();
+  create_axes(createModelAxis, createWorldAxis);
+
+  load_report_.totalMs = total.elapsedMs();
+  std::cout << load_report_.toJson() << std::endl;
+}
+
+Model::Model(const aiScene *scene, const std::string &name, bool gamma, bool createModelAxis, bool createWorldAxis,
+             const ModelLoadOptions &options)
+    : gammaCorection(gamma), showModelAxis(false), showWorldAxis(false),
+      modelAxisLength(1.0f), worldAxisLength(5.0f), options_(options)
+{
+  LoadTimer total;
+  load_report_.source = name;
+  if (!scene || !scene->mRootNode)
+  {
+    throw std::runtime_error("Failed to load model: empty scene " + name);
+  }
+  load_scene(scene);
+  create_axes(createModelAxis, createWorldAxis);
+
+  load_report_.totalMs = total.elapsedMs();
+  std::cout << load_report_.toJson() << std::endl;
+}
+
+void Model::create_axes(bool createModelAxis, bool createWorldAxis)
+{
   // 根据参数决定是否创建坐标轴
+  LoadTimer timer;
   if (createModelAxis)
   {
     this->createModelAxis();
@@ -21,24 +133,358 @@ Model::Model(const char *path, bool gamma, bool createModelAxis, bool createWorl
     this->createWorldAxis();
     showWorldAxis = true;
   }
+  load_report_.addStage("create_axis", timer.elapsedMs(), modelAxisMeshes.size() + worldAxisMeshes.size());
+}
+
+void Model::draw(Shader *shader, const glm::mat4 &transform)
+{
+  FramePacket packet;
+  packet.transform = transform;
+  prepareFrame(packet);
+  submitFrame(packet, shader);
+}
+
+// 只读写CPU数据（场景图、BVH与命令包），可在工作线程上执行
+void Model::prepareFrame(FramePacket &packet)
+{
+  auto start = std::chrono::steady_clock::now();
+  packet.owner = this;
+  packet.commands.clear();
+  packet.instanceMatrices.clear();
+  packet.instanceVersion = 0;
+  packet.culled = 0;
+
+  // 节点被修改过时增量更新世界矩阵，拾取用的BVH只标记过期：拖动节点时每帧都会走到这里，
+  // 完整重建留到下一次拾取（见 pick）
+  if (scene_graph_.update() && options_.retention != MeshRetention::None)
+    bvh_stale_ = true;
+  // 当前版本的实例矩阵尚未上传时随命令包带上，由提交方上传
+  if (instance_buffer_ && uploaded_instance_version_.load(std::memory_order_acquire) != geometry_version_)
+  {
+    packet.instanceMatrices.resize(instance_slots_.size());
+    for (size_t i = 0; i < instance_slots_.size(); i++)
+      packet.instanceMatrices[i] = scene_graph_.world(instances_[instance_slots_[i]].node);
+    packet.instanceVersion = geometry_version_;
+  }
+
+  packet.bonePalettes.clear();
+  packet.animateMs = 0.0;
+  if (packet.animationClip >= 0 && static_cast<size_t>(packet.animationClip) < animation_.clipCount())
+  {
+    prepare_animated(packet);
+    packet.prepareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return;
+  }
+
+  const glm::mat4 &transform = packet.transform;
+  glm::mat3 transformNormal = glm::transpose(glm::inverse(glm::mat3(transform)));
+  glm::mat4 viewProjection = packet.projection * packet.view;
+  packet.commands.reserve(draw_items_.size());
+  for (const DrawItem &item : draw_items_)
+  {
+    if (item.instance == kInstancedDraw)
+    {
+      packet.commands.push_back({item.mesh, true, transform, transformNormal});
+      continue;
+    }
+    const MeshInstance &instance = instances_[item.instance];
+    glm::mat4 world = transform * scene_graph_.world(instance.node);
+    const Mesh &mesh = meshes[item.mesh];
+    if (packet.cull && !boxInFrustum(viewProjection * world, mesh.boundsMin(), mesh.boundsMax()))
+    {
+      packet.culled++;
+      continue;
+    }
+    packet.commands.push_back({item.mesh, false, world, transformNormal * scene_graph_.normalMatrix(instance.node)});
+  }
+  packet.prepareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Model::uploadFrame(const FramePacket &packet)
+{
+  // 同一版本可能由两个命令包携带（光源命令包与 next，或被覆盖后重新准备的命令包），只上传更新的版本
+  if (!packet.instanceMatrices.empty() &&
+      packet.instanceVersion > uploaded_instance_version_.load(std::memory_order_relaxed))
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, packet.instanceMatrices.size() * sizeof(glm::mat4),
+                    packet.instanceMatrices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    uploaded_instance_version_.store(packet.instanceVersion, std::memory_order_release);
+  }
+  if (!packet.bonePalettes.empty())
+    upload_bone_palettes(packet.bonePalettes);
 }
 
-void Model::draw(Shader *shader)
+// 深度预渲染：与 submitFrame 相同的命令与矩阵，只写深度（模型坐标轴也要写入，否则颜色遍的 GL_EQUAL 测试不通过）
+void Model::submitDepth(const FramePacket &packet, Shader *shader, bool axes)
 {
-  // 绘制主模型的网格
-  for (unsigned int i = 0; i < meshes.size(); i++)
-    meshes[i].draw(shader);
+  bool instanced = false;
+  bool skinned = false;
+  shader->setBool("instanced", false);
+  shader->setBool("skinned", false);
+  for (const DrawCommand &command : packet.commands)
+  {
+    if (command.instanced != instanced)
+    {
+      shader->setBool("instanced", command.instanced);
+      instanced = command.instanced;
+    }
+    bool commandSkinned = command.palette != DrawCommand::kNoPalette;
+    if (commandSkinned != skinned)
+    {
+      shader->setBool("skinned", commandSkinned);
+      skinned = commandSkinned;
+    }
+    if (commandSkinned)
+      shader->setInt("paletteBase", static_cast<int>(command.palette));
+    shader->setMat4("model", command.model);
+    meshes[command.mesh].drawDepth();
+  }
+  if (instanced)
+    shader->setBool("instanced", false);
+  if (skinned)
+    shader->setBool("skinned", false);
+
+  if (axes && showModelAxis)
+  {
+    shader->setMat4("model", packet.transform);
+    for (Mesh &axis : modelAxisMeshes)
+      axis.drawDepth();
+  }
+}
+
+void Model::packetBounds(const FramePacket &packet, glm::vec3 &boundsMin, glm::vec3 &boundsMax) const
+{
+  boundsMin = glm::vec3(FLT_MAX);
+  boundsMax = glm::vec3(-FLT_MAX);
+  auto expand = [&](const glm::mat4 &world, const Mesh &mesh)
+  {
+    for (int corner = 0; corner < 8; corner++)
+    {
+      glm::vec3 local((corner & 1) ? mesh.boundsMax().x : mesh.boundsMin().x,
+                      (corner & 2) ? mesh.boundsMax().y : mesh.boundsMin().y,
+                      (corner & 4) ? mesh.boundsMax().z : mesh.boundsMin().z);
+      glm::vec3 point = glm::vec3(world * glm::vec4(local, 1.0f));
+      boundsMin = glm::min(boundsMin, point);
+      boundsMax = glm::max(boundsMax, point);
+    }
+  };
+  for (const DrawCommand &command : packet.commands)
+  {
+    const Mesh &mesh = meshes[command.mesh];
+    if (!command.instanced)
+    {
+      expand(command.model, mesh);
+      continue;
+    }
+    // 实例化绘制的命令只含整体变换，逐个实例乘以节点矩阵
+    for (const MeshInstance &instance : instances_)
+    {
+      if (instance.mesh == command.mesh)
+        expand(command.model * scene_graph_.world(instance.node), mesh);
+    }
+  }
+  if (boundsMin.x > boundsMax.x)
+    boundsMin = boundsMax = glm::vec3(0.0f);
+}
+
+void Model::submitFrame(const FramePacket &packet, Shader *shader, bool upload)
+{
+  if (upload)
+    uploadFrame(packet);
+
+  shader->setInt("texture_diffuse_array", Mesh::kDiffuseArrayUnit);
+  shader->setInt("bonePalette", Mesh::kBonePaletteUnit);
+  shader->setInt("shadowMap", Mesh::kShadowMapUnit);
+  TextureBindings bindings;
+
+  // 绘制主模型的网格实例
+  DrawStats stats;
+  stats.paletteBytes = packet.bonePalettes.size() * sizeof(glm::mat4);
+  bool instanced = false;
+  bool skinned = false;
+  shader->setBool("instanced", false);
+  shader->setBool("skinned", false);
+  for (const DrawCommand &command : packet.commands)
+  {
+    Mesh &mesh = meshes[command.mesh];
+    if (command.instanced != instanced)
+    {
+      shader->setBool("instanced", command.instanced);
+      instanced = command.instanced;
+    }
+    bool commandSkinned = command.palette != DrawCommand::kNoPalette;
+    if (commandSkinned != skinned)
+    {
+      shader->setBool("skinned", commandSkinned);
+      skinned = commandSkinned;
+    }
+    if (commandSkinned)
+    {
+      shader->setInt("paletteBase", static_cast<int>(command.palette));
+      stats.skinnedDraws++;
+    }
+    shader->setMat4("model", command.model);
+    shader->setMat3("normalMatrix", command.normalMatrix);
+    if (command.instanced)
+    {
+      stats.instancedDraws++;
+      stats.instances += mesh.instanceCount();
+    }
+    else
+    {
+      stats.instances++;
+    }
+    mesh.draw(shader, &bindings);
+    stats.drawCalls++;
+  }
+  if (instanced)
+    shader->setBool("instanced", false);
+  if (skinned)
+    shader->setBool("skinned", false);
+  stats.culled = packet.culled;
+  draw_stats_ = stats;
 
   // 绘制模型坐标轴（如果启用）
   if (showModelAxis)
   {
+    shader->setMat4("model", packet.transform);
+    shader->setMat3("normalMatrix", glm::transpose(glm::inverse(glm::mat3(packet.transform))));
     for (unsigned int i = 0; i < modelAxisMeshes.size(); i++)
-      modelAxisMeshes[i].draw(shader);
+      modelAxisMeshes[i].draw(shader, &bindings);
   }
+  draw_bindings_ = bindings;
+}
+
+// 每个副本按自己的时间求出全部节点矩阵，蒙皮网格的每个实例各生成一组骨骼矩阵。
+// 副本较多时把求值分给多个线程（本函数本身通常已在帧流水线的工作线程上）
+void Model::prepare_animated(FramePacket &packet)
+{
+  auto start = std::chrono::steady_clock::now();
+  constexpr uint32_t kParallelCopies = 8; // 少于该副本数时分发与同步的开销大于收益
+  constexpr float kCopyPhase = 0.37f;     // 相邻副本的时间差（秒）
+
+  uint32_t copies = std::max(1u, packet.crowd);
+  size_t clip = static_cast<size_t>(packet.animationClip);
+
+  // 蒙皮绘制项与其骨骼矩阵在每个副本中的偏移
+  std::vector<uint32_t> paletteOffsets(draw_items_.size(), DrawCommand::kNoPalette);
+  uint32_t copyPaletteSize = 0;
+  for (size_t i = 0; i < draw_items_.size(); i++)
+  {
+    const DrawItem &item = draw_items_[i];
+    int32_t skin = mesh_skins_[item.mesh];
+    if (skin < 0 || item.instance == kInstancedDraw)
+      continue;
+    paletteOffsets[i] = copyPaletteSize;
+    copyPaletteSize += static_cast<uint32_t>(std::min<size_t>(skins_[skin].nodes.size(), Animation::kMaxBones));
+  }
+  packet.bonePalettes.resize(size_t(copies) * copyPaletteSize);
+  crowd_world_.resize(copies);
+
+  auto evaluateCopies = [&](Animation::Scratch &scratch, uint32_t begin, uint32_t end)
+  {
+    for (uint32_t c = begin; c < end; c++)
+    {
+      std::vector<glm::mat4> &world = crowd_world_[c];
+      animation_.evaluate(scene_graph_, clip, packet.animationTime + c * kCopyPhase, world, scratch);
+      for (size_t i = 0; i < draw_items_.size(); i++)
+      {
+        if (paletteOffsets[i] == DrawCommand::kNoPalette)
+          continue;
+        const DrawItem &item = draw_items_[i];
+        glm::mat4 *palette = packet.bonePalettes.data() + size_t(c) * copyPaletteSize + paletteOffsets[i];
+        Animation::skinPalette(skins_[mesh_skins_[item.mesh]], instances_[item.instance].node, world, palette);
+      }
+    }
+  };
+  unsigned threads = copies >= kParallelCopies ? std::max(1u, std::min(std::thread::hardware_concurrency(), copies)) : 1;
+  anim_scratch_.resize(std::max<size_t>(anim_scratch_.size(), threads));
+  if (threads == 1)
+  {
+    evaluateCopies(anim_scratch_[0], 0, copies);
+  }
+  else
+  {
+    // 第0段在调用线程上求值，其余各段交给常驻线程
+    while (anim_workers_.size() + 1 < threads)
+      anim_workers_.push_back(std::make_unique<FramePipeline>());
+    uint32_t chunk = (copies + threads - 1) / threads;
+    unsigned kicked = 0;
+    for (unsigned t = 1; t < threads; t++)
+    {
+      uint32_t begin = t * chunk;
+      uint32_t end = std::min(copies, begin + chunk);
+      if (begin >= end)
+        break;
+      Animation::Scratch &scratch = anim_scratch_[t];
+      anim_workers_[t - 1]->kick([&evaluateCopies, &scratch, begin, end]
+                                 { evaluateCopies(scratch, begin, end); });
+      kicked++;
+    }
+    evaluateCopies(anim_scratch_[0], 0, std::min(copies, chunk));
+    for (unsigned t = 0; t < kicked; t++)
+      anim_workers_[t]->wait();
+  }
+  packet.animateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  // 副本排成方阵，中心位于原点
+  uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(copies))));
+  float half = (side - 1) * 0.5f;
+  glm::mat4 viewProjection = packet.projection * packet.view;
+  packet.commands.reserve(size_t(copies) * draw_items_.size());
+  for (uint32_t c = 0; c < copies; c++)
+  {
+    glm::vec3 offset((c % side - half) * packet.crowdSpacing, 0.0f, (c / side - half) * packet.crowdSpacing);
+    glm::mat4 copyTransform = packet.transform * glm::translate(glm::mat4(1.0f), offset);
+    const std::vector<glm::mat4> &world = crowd_world_[c];
+    for (size_t i = 0; i < draw_items_.size(); i++)
+    {
+      const DrawItem &item = draw_items_[i];
+      if (item.instance == kInstancedDraw)
+        continue;
+      glm::mat4 model = copyTransform * world[instances_[item.instance].node];
+      bool skinnedItem = paletteOffsets[i] != DrawCommand::kNoPalette;
+      // 蒙皮网格的包围盒是绑定姿态的，动画后可能超出，不参与剔除
+      const Mesh &mesh = meshes[item.mesh];
+      if (packet.cull && !skinnedItem && !boxInFrustum(viewProjection * model, mesh.boundsMin(), mesh.boundsMax()))
+      {
+        packet.culled++;
+        continue;
+      }
+      DrawCommand command{item.mesh, false, model, glm::transpose(glm::inverse(glm::mat3(model)))};
+      if (skinnedItem)
+        command.palette = c * copyPaletteSize + paletteOffsets[i];
+      packet.commands.push_back(command);
+    }
+  }
+}
+
+// 骨骼矩阵放在纹理缓冲中（每个矩阵4个RGBA32F纹素），着色器按 paletteBase + 骨骼号读取
+void Model::upload_bone_palettes(const std::vector<glm::mat4> &palettes)
+{
+  if (!bone_buffer_)
+  {
+    glGenBuffers(1, &bone_buffer_);
+    glGenTextures(1, &bone_texture_);
+    glBindBuffer(GL_TEXTURE_BUFFER, bone_buffer_);
+    glBufferData(GL_TEXTURE_BUFFER, palettes.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, bone_texture_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, bone_buffer_);
+  }
+  // 每帧重新分配存储（orphan），不等待上一帧仍在读取的缓冲
+  glBindBuffer(GL_TEXTURE_BUFFER, bone_buffer_);
+  glBufferData(GL_TEXTURE_BUFFER, palettes.size() * sizeof(glm::mat4), palettes.data(), GL_STREAM_DRAW);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  glActiveTexture(GL_TEXTURE0 + Mesh::kBonePaletteUnit);
+  glBindTexture(GL_TEXTURE_BUFFER, bone_texture_);
+  glActiveTexture(GL_TEXTURE0);
 }
 
 void Model::drawWorldAxis(Shader *shader)
 {
+  shader->setInt("texture_diffuse_array", Mesh::kDiffuseArrayUnit);
   // 绘制世界坐标轴（如果启用）
   if (showWorldAxis)
   {
@@ -47,42 +493,293 @@ void Model::drawWorldAxis(Shader *shader)
   }
 }
 
-void Model::load_model(std::string const path)
+Model::Model()
+    : gammaCorection(false), model_center(0.0f), model_scale_factor(1.0f), showModelAxis(false),
+      showWorldAxis(false), modelAxisLength(1.0f), worldAxisLength(5.0f)
+{
+}
+
+Model::~Model()
+{
+  // 释放GL对象，避免重新加载模型时泄漏显存
+  for (Mesh &mesh : meshes)
+    mesh.releaseGL();
+  for (Mesh &mesh : modelAxisMeshes)
+    mesh.releaseGL();
+  for (Mesh &mesh : worldAxisMeshes)
+    mesh.releaseGL();
+  if (instance_buffer_)
+    glDeleteBuffers(1, &instance_buffer_);
+  if (bone_texture_)
+    glDeleteTextures(1, &bone_texture_);
+  if (bone_buffer_)
+    glDeleteBuffers(1, &bone_buffer_);
+  for (const TextureArrayPage &page : texture_pages_)
+    glDeleteTextures(1, &page.texture);
+  for (const Texture &texture : textures_loaded)
+  {
+    if (texture.layer >= 0)
+      continue;
+    TextureStreamer::get_instance().cancel(texture.id);
+    TextureBudget::get_instance().remove(texture.id);
+    glDeleteTextures(1, &texture.id);
+  }
+}
+
+ModelMemoryStats Model::memoryStats() const
+{
+  ModelMemoryStats stats;
+  auto addMeshes = [&stats](const std::vector<Mesh> &list)
+  {
+    for (const Mesh &mesh : list)
+    {
+      stats.cpuVertexBytes += mesh.vertices.capacity() * sizeof(Vertex);
+      stats.cpuIndexBytes += mesh.indices.capacity() * sizeof(unsigned int);
+      stats.gpuBufferBytes += mesh.gpuBytes();
+    }
+  };
+  addMeshes(meshes);
+  addMeshes(modelAxisMeshes);
+  addMeshes(worldAxisMeshes);
+
+  stats.gpuBufferBytes += instance_slots_.size() * sizeof(glm::mat4);
+  stats.cpuBvhBytes = bvh_.memoryBytes();
+
+  for (const LoadReport::TextureStat &texture : load_report_.textures)
+  {
+    if (!texture.loaded)
+      continue;
+    stats.textureStagingPeak = std::max(stats.textureStagingPeak, texture.bytes);
+  }
+  for (const TextureArrayPage &page : texture_pages_)
+    stats.gpuTextureBytes += page.bytes;
+  for (const Texture &texture : textures_loaded)
+  {
+    if (texture.layer >= 0)
+      continue;
+    stats.gpuTextureBytes += TextureBudget::get_instance().allocatedBytes(texture.id);
+    stats.textureStreamBytes += TextureStreamer::get_instance().pendingBytes(texture.id);
+  }
+  return stats;
+}
+
+std::unique_ptr<ImportedScene> Model::importFile(const std::string &name)
 {
-  Assimp::Importer importer;
-  const aiScene *scene = importer.ReadFile(path,
-                                           aiProcess_Triangulate |
-                                               aiProcess_FlipUVs |
-                                               aiProcess_CalcTangentSpace |
-                                               aiProcess_GenNormals |          // 生成法线
-                                               aiProcess_GenSmoothNormals |    // 生成平滑法线
-                                               aiProcess_JoinIdenticalVertices // 合并相同顶点
-  );
+  // 相对路径按资源根目录解析；根目录下的文件（含 .mtl 与贴图）在资源包中以逻辑名找到
+  std::string path = AssetArchive::get_instance().resolve(name);
+  auto imported = std::make_unique<ImportedScene>();
+  imported->report.source = path;
+  imported->importer = std::make_unique<Assimp::Importer>();
+  Assimp::Importer &importer = *imported->importer;
+  // 模型及其引用的文件优先从资源包读取（Importer 负责释放）
+  if (AssetArchive::get_instance().isOpen())
+    importer.SetIOHandler(new ArchiveIOSystem());
+  LoadTimer timer;
+  const aiScene *scene = importer.ReadFile(path, 0);
+  imported->report.addStage("ReadFile", timer.elapsedMs(), scene ? scene->mNumMeshes : 0);
+
+  // 后处理步骤逐个执行以便分别计时，顺序与Assimp内部的执行顺序一致
+  static const struct
+  {
+    const char *name;
+    unsigned int flags;
+  } post_steps[] = {
+      {"aiProcess_FlipUVs", aiProcess_FlipUVs},
+      {"aiProcess_Triangulate", aiProcess_Triangulate},
+      {"aiProcess_GenSmoothNormals", aiProcess_GenNormals | aiProcess_GenSmoothNormals}, // 生成（平滑）法线
+      {"aiProcess_CalcTangentSpace", aiProcess_CalcTangentSpace},
+      {"aiProcess_JoinIdenticalVertices", aiProcess_JoinIdenticalVertices}, // 合并相同顶点
+      {"aiProcess_LimitBoneWeights", aiProcess_LimitBoneWeights},           // 每个顶点最多4个骨骼影响
+  };
+  for (const auto &step : post_steps)
+  {
+    if (!scene)
+      break;
+    timer.reset();
+    scene = importer.ApplyPostProcessing(step.flags);
+    imported->report.addStage(step.name, timer.elapsedMs());
+  }
 
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
   {
-    throw std::runtime_error(std::string("Failed to load model: ") + importer.GetErrorString());
+    imported->error = importer.GetErrorString();
+    scene = nullptr;
   }
+  imported->scene = scene;
+  return imported;
+}
+
+void Model::load_imported(ImportedScene &imported)
+{
+  load_report_ = imported.report;
+  if (!imported.scene)
+  {
+    throw std::runtime_error(std::string("Failed to load model: ") + imported.error);
+  }
+  const std::string &path = load_report_.source;
   directory = path.substr(0, path.find_last_of('/'));
 
+  load_scene(imported.scene);
+}
+
+// 由已完成后处理的场景创建网格（文件加载与内存场景共用）
+void Model::load_scene(const aiScene *scene)
+{
   // 第一步：计算整个模型的边界
+  LoadTimer timer;
   calculate_model_bounds(scene);
+  load_report_.addStage("calculate_model_bounds", timer.elapsedMs(), scene->mNumMeshes);
 
   // 第二步：处理所有节点
-  process_node(scene->mRootNode, scene);
+  timer.reset();
+  collect_layers_ = options_.textureArrayMaxSize > 0;
+  scene_graph_.clear();
+  instances_.clear();
+  glm::mat4 normalize = glm::scale(glm::mat4(1.0f), glm::vec3(model_scale_factor)) *
+                        glm::translate(glm::mat4(1.0f), -model_center);
+  uint32_t root = scene_graph_.addNode(SceneGraph::kNoParent, "<normalize>", normalize);
+  std::vector<uint32_t> meshIndex(scene->mNumMeshes, UINT32_MAX);
+  process_node(scene->mRootNode, scene, root, meshIndex);
+  scene_graph_.update();
+  load_report_.addStage("process_node", timer.elapsedMs(), instances_.size());
+  timer.reset();
+  animation_.load(scene, scene_graph_);
+  for (Animation::Skin &skin : skins_)
+  {
+    size_t missing = Animation::resolveSkin(skin, scene_graph_);
+    if (missing > 0)
+      std::cout << "蒙皮: " << missing << " 个骨骼找不到节点" << std::endl;
+  }
+  load_report_.addStage("animation", timer.elapsedMs(), animation_.clipCount());
+  timer.reset();
+  build_texture_arrays();
+  uint64_t pageBytes = 0;
+  for (const TextureArrayPage &page : texture_pages_)
+    pageBytes += page.bytes;
+  load_report_.addStage("texture_arrays", timer.elapsedMs(), texture_pages_.size(), pageBytes);
+  timer.reset();
+  setup_instancing();
+  build_draw_order();
+  summarize_load_stages();
+
+  // 第三步：构建拾取用BVH
+  if (options_.retention != MeshRetention::None)
+  {
+    timer.reset();
+    build_bvh();
+    load_report_.addStage("build_bvh", timer.elapsedMs(), bvh_.triangleCount(), bvh_.memoryBytes());
+  }
+
+  // 第四步：按保留策略释放网格的CPU副本
+  if (options_.retention != MeshRetention::KeepAll)
+  {
+    timer.reset();
+    uint64_t releasedBytes = 0;
+    for (Mesh &mesh : meshes)
+    {
+      releasedBytes += mesh.cpuBytes();
+      mesh.releaseCpuData();
+    }
+    load_report_.addStage("release_cpu_data", timer.elapsedMs(), meshes.size(), releasedBytes);
+  }
 }
 
-void Model::process_node(aiNode *node, const aiScene *scene)
+// 汇总各网格与纹理的分项耗时
+void Model::summarize_load_stages()
 {
+  double convertMs = 0.0, uploadMs = 0.0;
+  uint64_t meshBytes = 0;
+  for (const LoadReport::MeshStat &stat : load_report_.meshes)
+  {
+    convertMs += stat.convertMs;
+    uploadMs += stat.uploadMs;
+    meshBytes += stat.bytes;
+  }
+  load_report_.addStage("process_mesh", convertMs, load_report_.meshes.size(), meshBytes);
+  load_report_.addStage("mesh_upload", uploadMs, load_report_.meshes.size(), meshBytes);
+
+  double decodeMs = 0.0, encodeMs = 0.0, textureUploadMs = 0.0, mipmapMs = 0.0;
+  uint64_t textureBytes = 0, encodedBytes = 0, encodedCount = 0, cacheHits = 0;
+  for (const LoadReport::TextureStat &stat : load_report_.textures)
+  {
+    decodeMs += stat.decodeMs;
+    encodeMs += stat.encodeMs;
+    textureUploadMs += stat.uploadMs;
+    mipmapMs += stat.mipmapMs;
+    textureBytes += stat.bytes;
+    if (stat.encodeMs > 0.0)
+    {
+      encodedCount++;
+      encodedBytes += stat.gpuBytes;
+    }
+    if (stat.cacheHit)
+      cacheHits++;
+  }
+  load_report_.addStage("stbi_load", decodeMs, load_report_.textures.size(), textureBytes);
+  if (options_.compressTextures)
+  {
+    load_report_.addStage("bc_encode", encodeMs, encodedCount, encodedBytes);
+    load_report_.addStage("texture_cache_hit", 0.0, cacheHits);
+  }
+  load_report_.addStage("glTexImage2D", textureUploadMs, load_report_.textures.size(), textureBytes);
+  load_report_.addStage("glGenerateMipmap", mipmapMs, load_report_.textures.size());
+}
+
+void Model::build_bvh()
+{
+  size_t vertexCount = 0, indexCount = 0;
+  for (const MeshInstance &instance : instances_)
+  {
+    vertexCount += meshes[instance.mesh].vertices.size();
+    indexCount += meshes[instance.mesh].indices.size();
+  }
+
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+  positions.reserve(vertexCount);
+  indices.reserve(indexCount);
+  // BVH在标准化后的模型空间中：每个实例的顶点按节点世界矩阵变换
+  for (const MeshInstance &instance : instances_)
+  {
+    const Mesh &mesh = meshes[instance.mesh];
+    const glm::mat4 &world = scene_graph_.world(instance.node);
+    uint32_t base = static_cast<uint32_t>(positions.size());
+    for (const Vertex &vertex : mesh.vertices)
+      positions.push_back(glm::vec3(world * glm::vec4(vertex.Position, 1.0f)));
+    for (unsigned int index : mesh.indices)
+      indices.push_back(base + index);
+  }
+
+  bvh_.build(std::move(positions), std::move(indices));
+  bvh_stale_ = false;
+}
+
+bool Model::pick(const Ray &ray, RayHit &hit)
+{
+  // 保留了网格副本时按当前节点变换重建；PickingOnly 没有副本，沿用加载时的BVH
+  if (bvh_stale_ && options_.retention == MeshRetention::KeepAll)
+    build_bvh();
+  return bvh_.intersect(ray, hit);
+}
+
+void Model::process_node(aiNode *node, const aiScene *scene, uint32_t parent, std::vector<uint32_t> &meshIndex)
+{
+  uint32_t index = scene_graph_.addNode(parent, node->mName.C_Str(), toGlm(node->mTransformation));
   for (unsigned int i = 0; i < node->mNumMeshes; i++)
   {
-    aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-    meshes.push_back(process_mesh(mesh, scene));
+    uint32_t &mesh = meshIndex[node->mMeshes[i]];
+    if (mesh == UINT32_MAX)
+    {
+      mesh = static_cast<uint32_t>(meshes.size());
+      mesh_skins_.push_back(scene->mMeshes[node->mMeshes[i]]->HasBones() ? static_cast<int32_t>(skins_.size()) : -1);
+      meshes.push_back(process_mesh(scene->mMeshes[node->mMeshes[i]], scene));
+    }
+    instances_.push_back({index, mesh});
   }
 
   for (unsigned int i = 0; i < node->mNumChildren; i++)
   {
-    process_node(node->mChildren[i], scene);
+    process_node(node->mChildren[i], scene, index, meshIndex);
   }
 }
 
@@ -92,15 +789,26 @@ Mesh Model::process_mesh(aiMesh *mesh, const aiScene *scene)
   std::vector<unsigned int> indices;
   std::vector<Texture> textures;
 
-  // 处理顶点，应用中心偏移和统一缩放
+  LoadReport::MeshStat stat;
+  stat.name = mesh->mName.C_Str();
+  LoadTimer timer;
+  vertices.reserve(mesh->mNumVertices);
+  indices.reserve(mesh->mNumFaces * 3);
+
+  // 处理顶点：位置保持网格局部坐标，节点变换与标准化（居中、统一缩放）由场景图在绘制时应用
   for (unsigned int i = 0; i < mesh->mNumVertices; i++)
   {
     Vertex vertex;
+    for (int k = 0; k < MAX_BONE_INFLUENCE; k++)
+    {
+      vertex.m_BoneIDs[k] = 0;
+      vertex.m_Weights[k] = 0.0f;
+    }
     glm::vec3 vector; // we declare a placeholder vector since assimp uses its own vector class that doesn't directly convert to glm's vec3 class so we transfer the data to this placeholder glm::vec3 first.
-    // positions - 应用整个模型的中心偏移和统一缩放
-    vector.x = (mesh->mVertices[i].x - model_center.x) * model_scale_factor;
-    vector.y = (mesh->mVertices[i].y - model_center.y) * model_scale_factor;
-    vector.z = (mesh->mVertices[i].z - model_center.z) * model_scale_factor;
+    // positions
+    vector.x = mesh->mVertices[i].x;
+    vector.y = mesh->mVertices[i].y;
+    vector.z = mesh->mVertices[i].z;
     vertex.Position = vector;
     // normals
     if (mesh->HasNormals())
@@ -155,8 +863,54 @@ Mesh Model::process_mesh(aiMesh *mesh, const aiScene *scene)
     vertices.push_back(vertex);
   }
 
-  // 输出调试信息
-  std::cout << "网格处理完成，顶点数: " << vertices.size() << std::endl;
+  // 骨骼权重：每个顶点保留权重最大的 MAX_BONE_INFLUENCE 个骨骼并归一化
+  if (mesh->HasBones())
+  {
+    Animation::Skin skin;
+    size_t dropped = 0;
+    for (unsigned int b = 0; b < mesh->mNumBones; b++)
+    {
+      const aiBone *bone = mesh->mBones[b];
+      skin.names.push_back(bone->mName.C_Str());
+      skin.offsets.push_back(toGlm(bone->mOffsetMatrix));
+      if (b >= static_cast<unsigned int>(Animation::kMaxBones))
+      {
+        dropped++;
+        continue;
+      }
+      for (unsigned int w = 0; w < bone->mNumWeights; w++)
+      {
+        const aiVertexWeight &weight = bone->mWeights[w];
+        Vertex &vertex = vertices[weight.mVertexId];
+        int slot = 0;
+        for (int k = 1; k < MAX_BONE_INFLUENCE; k++)
+        {
+          if (vertex.m_Weights[k] < vertex.m_Weights[slot])
+            slot = k;
+        }
+        if (weight.mWeight > vertex.m_Weights[slot])
+        {
+          vertex.m_BoneIDs[slot] = static_cast<int>(b);
+          vertex.m_Weights[slot] = weight.mWeight;
+        }
+      }
+    }
+    for (Vertex &vertex : vertices)
+    {
+      float total = 0.0f;
+      for (int k = 0; k < MAX_BONE_INFLUENCE; k++)
+        total += vertex.m_Weights[k];
+      if (total > 0.0f)
+      {
+        for (int k = 0; k < MAX_BONE_INFLUENCE; k++)
+          vertex.m_Weights[k] /= total;
+      }
+    }
+    if (dropped > 0)
+      std::cout << "网格 " << stat.name << ": 骨骼数超过 " << Animation::kMaxBones << "，忽略 " << dropped << " 个骨骼" << std::endl;
+    skins_.push_back(std::move(skin));
+  }
+
   // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
   for (unsigned int i = 0; i < mesh->mNumFaces; i++)
   {
@@ -165,6 +919,10 @@ Mesh Model::process_mesh(aiMesh *mesh, const aiScene *scene)
     for (unsigned int j = 0; j < face.mNumIndices; j++)
       indices.push_back(face.mIndices[j]);
   }
+  stat.convertMs = timer.elapsedMs();
+  stat.vertices = static_cast<uint32_t>(vertices.size());
+  stat.indices = static_cast<uint32_t>(indices.size());
+  stat.bytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
   // process materials
   aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
   // we assume a convention for sampler names in the shaders. Each diffuse texture should be named
@@ -175,22 +933,26 @@ Mesh Model::process_mesh(aiMesh *mesh, const aiScene *scene)
   // normal: texture_normalN
 
   // 1. diffuse maps
-  std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+  std::vector<Texture> diffuseMaps = loadMaterialTextures(scene, material, aiTextureType_DIFFUSE, "texture_diffuse");
   textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
   // 2. specular maps
-  std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+  std::vector<Texture> specularMaps = loadMaterialTextures(scene, material, aiTextureType_SPECULAR, "texture_specular");
   textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
   // 3. normal maps - 修复纹理类型
-  std::vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_NORMALS, "texture_normal");
+  std::vector<Texture> normalMaps = loadMaterialTextures(scene, material, aiTextureType_NORMALS, "texture_normal");
   textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
   // 4. height maps
-  std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
+  std::vector<Texture> heightMaps = loadMaterialTextures(scene, material, aiTextureType_AMBIENT, "texture_height");
   textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
-  return Mesh(vertices, indices, textures);
+  timer.reset();
+  Mesh result(std::move(vertices), std::move(indices), std::move(textures));
+  stat.uploadMs = timer.elapsedMs();
+  load_report_.meshes.push_back(stat);
+  return result;
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName)
+std::vector<Texture> Model::loadMaterialTextures(const aiScene *scene, aiMaterial *mat, aiTextureType type, std::string typeName)
 {
   std::vector<Texture> textures;
   for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
@@ -211,7 +973,11 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType
     if (!skip)
     { // if texture hasn't been loaded already, load it
       Texture texture;
-      texture.id = TextureFromFile(str.C_Str(), this->directory);
+      const aiTexture *embedded = scene->GetEmbeddedTexture(str.C_Str());
+      if (embedded)
+        texture.id = TextureFromEmbedded(embedded, str.C_Str(), textureRoleFromType(typeName));
+      else
+        texture.id = TextureFromFile(str.C_Str(), this->directory, false, textureRoleFromType(typeName));
       texture.type = typeName;
       texture.path = str.C_Str();
       textures.push_back(texture);
@@ -221,7 +987,7 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType
   return textures;
 }
 
-unsigned int Model::TextureFromFile(const char *path, const std::string &directory, bool gamma)
+unsigned int Model::TextureFromFile(const char *path, const std::string &directory, bool gamma, TextureRole role)
 {
   std::string filename = std::string(path);
   filename = directory + '/' + filename;
@@ -229,11 +995,31 @@ unsigned int Model::TextureFromFile(const char *path, const std::string &directo
   unsigned int textureID;
   glGenTextures(1, &textureID);
 
+  LoadReport::TextureStat stat;
+  stat.path = filename;
+
+  TextureSource source;
+  source.file = filename;
+  source.role = role;
+  if (options_.compressTextures)
+  {
+    source.cacheKey = TextureCache::keyForFile(filename, role);
+    if (load_cached_texture(textureID, source, stat))
+    {
+      load_report_.textures.push_back(stat);
+      return textureID;
+    }
+  }
+
+  LoadTimer timer;
   int width, height, nrComponents;
   stbi_set_flip_vertically_on_load(true);
-  unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+  unsigned char *data = loadImage(filename, &width, &height, &nrComponents, 0);
+  stat.decodeMs = timer.elapsedMs();
   if (data)
   {
+    stat.channels = nrComponents;
+
     GLenum format;
     if (nrComponents == 1)
       format = GL_RED;
@@ -242,15 +1028,9 @@ unsigned int Model::TextureFromFile(const char *path, const std::string &directo
     else if (nrComponents == 4)
       format = GL_RGBA;
 
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
+    if (!options_.compressTextures ||
+        !compress_texture(textureID, data, width, height, nrComponents, false, source, stat))
+      upload_texture(textureID, data, width, height, format, format, source, stat);
     stbi_image_free(data);
   }
   else
@@ -258,25 +1038,575 @@ unsigned int Model::TextureFromFile(const char *path, const std::string &directo
     std::cout << "Texture failed to load at path: " << path << std::endl;
     stbi_image_free(data);
   }
+  load_report_.textures.push_back(stat);
 
   return textureID;
 }
 
+// 场景内嵌纹理（"*N"）：压缩格式由stb解码，未压缩格式为BGRA8888像素
+unsigned int Model::TextureFromEmbedded(const aiTexture *texture, const std::string &name, TextureRole role)
+{
+  unsigned int textureID;
+  glGenTextures(1, &textureID);
+
+  LoadReport::TextureStat stat;
+  stat.path = name;
+
+  // 内嵌纹理没有文件时间戳，按内容哈希作为缓存键；场景释放后只能从缓存重新加载
+  size_t sourceBytes = texture->mHeight == 0 ? texture->mWidth : size_t(texture->mWidth) * texture->mHeight * sizeof(aiTexel);
+  TextureSource source;
+  source.role = role;
+  if (options_.compressTextures)
+  {
+    source.cacheKey = TextureCache::keyForMemory(texture->pcData, sourceBytes, role);
+    if (load_cached_texture(textureID, source, stat))
+    {
+      load_report_.textures.push_back(stat);
+      return textureID;
+    }
+  }
+
+  LoadTimer timer;
+  if (texture->mHeight == 0)
+  {
+    int width, height, nrComponents;
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(texture->pcData),
+                                                static_cast<int>(texture->mWidth), &width, &height, &nrComponents, 0);
+    stat.decodeMs = timer.elapsedMs();
+    if (data)
+    {
+      GLenum format = nrComponents == 1 ? GL_RED : nrComponents == 3 ? GL_RGB : GL_RGBA;
+      stat.channels = nrComponents;
+      if (!options_.compressTextures ||
+          !compress_texture(textureID, data, width, height, nrComponents, false, source, stat))
+        upload_texture(textureID, data, width, height, format, format, source, stat);
+      stbi_image_free(data);
+    }
+    else
+    {
+      std::cout << "Embedded texture failed to decode: " << name << std::endl;
+    }
+  }
+  else
+  {
+    stat.channels = 4;
+    const unsigned char *pixels = reinterpret_cast<const unsigned char *>(texture->pcData);
+    int width = static_cast<int>(texture->mWidth), height = static_cast<int>(texture->mHeight);
+    if (!options_.compressTextures || !compress_texture(textureID, pixels, width, height, 4, true, source, stat))
+      upload_texture(textureID, pixels, width, height, GL_RGBA, GL_BGRA, source, stat);
+  }
+  load_report_.textures.push_back(stat);
+
+  return textureID;
+}
+
+// 不经流式上传，直接指定全部mip层（返回时纹理保持绑定）
+static void uploadLevels(GLuint texture, const std::vector<TextureLevel> &levels, bool compressed,
+                         GLenum internalFormat, GLenum format)
+{
+  GLint alignment = 4;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  GLint levelCount = static_cast<GLint>(levels.size());
+  for (GLint level = 0; level < levelCount; level++)
+  {
+    const TextureLevel &data = levels[level];
+    if (compressed)
+      glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, data.width, data.height, 0,
+                             static_cast<GLsizei>(data.data.size()), data.data.data());
+    else
+      glTexImage2D(GL_TEXTURE_2D, level, internalFormat, data.width, data.height, 0, format, GL_UNSIGNED_BYTE,
+                   data.data.data());
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+// 显存预算恢复被降级的纹理时重新取得mip链：压缩纹理优先读转码缓存，其余从源文件重新解码。
+// 内嵌的未压缩纹理没有可重新读取的来源，不提供回调
+static TextureBudget::Reloader makeReloader(const Model::TextureSource &source, const ModelLoadOptions &options,
+                                            bool compressed, BlockFormat format, int channels)
+{
+  if (source.file.empty() && (!compressed || source.cacheKey.empty()))
+    return TextureBudget::Reloader();
+  std::string cacheDir = options.textureCacheDir;
+  uint32_t maxSize = options.maxTextureSize;
+  return [source, cacheDir, maxSize, compressed, format, channels]()
+  {
+    std::vector<TextureLevel> levels;
+    if (compressed)
+    {
+      CompressedTexture texture;
+      if (!TextureCache(cacheDir).load(source.cacheKey, texture) && !source.file.empty())
+      {
+        int width, height, nrComponents;
+        stbi_set_flip_vertically_on_load(true);
+        unsigned char *data = loadImage(source.file, &width, &height, &nrComponents, 4);
+        if (data)
+        {
+          texture = compressTexture(data, width, height, format, source.role);
+          stbi_image_free(data);
+        }
+      }
+      if (texture.format == format)
+        levels = std::move(texture.levels);
+    }
+    else
+    {
+      int width, height, nrComponents;
+      stbi_set_flip_vertically_on_load(true);
+      unsigned char *data = loadImage(source.file, &width, &height, &nrComponents, 0);
+      if (data && nrComponents == channels)
+        levels = buildMipChain(data, width, height, channels, false);
+      stbi_image_free(data);
+    }
+    capTextureLevels(levels, maxSize);
+    return levels;
+  };
+}
+
+void Model::upload_texture(unsigned int textureID, const void *data, int width, int height, GLenum internalFormat,
+                           GLenum format, const TextureSource &source, LoadReport::TextureStat &stat)
+{
+  stat.loaded = true;
+  stat.width = width;
+  stat.height = height;
+  stat.bytes = static_cast<uint64_t>(width) * height * stat.channels;
+  stat.format = stat.channels == 1 ? "R8" : stat.channels == 3 ? "RGB8" : "RGBA8";
+
+  // 数组页资格按应用分辨率上限后的尺寸判断（与 capTextureLevels 相同：逐层减半直到不超过上限）
+  uint32_t uploadSize = static_cast<uint32_t>(std::max(width, height));
+  while (options_.maxTextureSize > 0 && uploadSize > options_.maxTextureSize && uploadSize > 1)
+    uploadSize >>= 1;
+
+  LoadTimer timer;
+  if (collect_layers_ && source.role == TextureRole::Diffuse && uploadSize <= options_.textureArrayMaxSize)
+  {
+    PendingLayer layer;
+    layer.texture = textureID;
+    layer.statIndex = load_report_.textures.size(); // 调用方随后把 stat 加入报告
+    layer.source = source;
+    layer.internalFormat = internalFormat;
+    layer.format = format;
+    layer.levels = buildMipChain(static_cast<const uint8_t *>(data), width, height, stat.channels, false);
+    capTextureLevels(layer.levels, options_.maxTextureSize);
+    stat.mipmapMs = timer.elapsedMs();
+    pending_layers_.push_back(std::move(layer));
+    return;
+  }
+
+  TextureBudget::TextureInfo info;
+  info.texture = textureID;
+  info.name = stat.path;
+  info.width = width;
+  info.height = height;
+  info.internalFormat = internalFormat;
+  info.format = format;
+  info.type = GL_UNSIGNED_BYTE;
+  info.texelBytes = stat.channels;
+  info.levelCount = 1;
+  while (std::max(width, height) >> info.levelCount)
+    info.levelCount++;
+
+  uint32_t maxSize = options_.maxTextureSize;
+  bool capped = maxSize > 0 && static_cast<uint32_t>(std::max(width, height)) > maxSize;
+  if (options_.streamTextures || capped)
+  {
+    // 流式上传与分辨率上限都需要CPU mip链，代替GPU上的 glGenerateMipmap
+    std::vector<TextureLevel> levels = buildMipChain(static_cast<const uint8_t *>(data), width, height, stat.channels, false);
+    capTextureLevels(levels, maxSize);
+    info.width = levels[0].width;
+    info.height = levels[0].height;
+    info.levelCount = static_cast<int>(levels.size());
+    stat.mipmapMs = timer.elapsedMs();
+    timer.reset();
+    if (options_.streamTextures)
+    {
+      TextureStreamer::get_instance().enqueue(textureID, internalFormat, format, GL_UNSIGNED_BYTE, stat.channels,
+                                              std::move(levels));
+      stat.streamed = true;
+    }
+    else
+    {
+      uploadLevels(textureID, levels, false, internalFormat, format);
+    }
+    stat.uploadMs = timer.elapsedMs();
+  }
+  else
+  {
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    stat.uploadMs = timer.elapsedMs();
+    timer.reset();
+    glGenerateMipmap(GL_TEXTURE_2D);
+    stat.mipmapMs = timer.elapsedMs();
+  }
+  info.baseLevel = TextureStreamer::get_instance().residentLevel(textureID);
+  TextureBudget::get_instance().add(info, makeReloader(source, options_, false, BlockFormat::BC1, stat.channels));
+  stat.gpuBytes = TextureBudget::get_instance().allocatedBytes(textureID);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+bool Model::load_cached_texture(unsigned int textureID, const TextureSource &source, LoadReport::TextureStat &stat)
+{
+  LoadTimer timer;
+  CompressedTexture compressed;
+  if (!TextureCache(options_.textureCacheDir).load(source.cacheKey, compressed) ||
+      !blockFormatSupported(compressed.format))
+    return false;
+  stat.decodeMs = timer.elapsedMs();
+  stat.cacheHit = true;
+  stat.channels = compressed.format == BlockFormat::BC5 ? 2 : compressed.format == BlockFormat::BC3 ? 4 : 3;
+  stat.bytes = compressed.totalBytes();
+  upload_compressed(textureID, std::move(compressed), source, stat);
+  return true;
+}
+
+bool Model::compress_texture(unsigned int textureID, const unsigned char *pixels, int width, int height, int channels,
+                             bool bgra, const TextureSource &source, LoadReport::TextureStat &stat)
+{
+  // 单通道纹理本身只有1字节/像素，保持未压缩
+  if (channels < 3 || width <= 0 || height <= 0)
+    return false;
+
+  LoadTimer timer;
+  size_t pixelCount = size_t(width) * height;
+  std::vector<uint8_t> rgba(pixelCount * 4);
+  bool hasAlpha = false;
+  for (size_t i = 0; i < pixelCount; i++)
+  {
+    const unsigned char *src = pixels + i * channels;
+    uint8_t *dst = &rgba[i * 4];
+    dst[0] = src[bgra ? 2 : 0];
+    dst[1] = src[1];
+    dst[2] = src[bgra ? 0 : 2];
+    dst[3] = channels == 4 ? src[3] : 255;
+    hasAlpha |= dst[3] != 255;
+  }
+  BlockFormat format = chooseBlockFormat(source.role, hasAlpha);
+  if (!blockFormatSupported(format))
+    return false;
+
+  CompressedTexture compressed = compressTexture(rgba.data(), width, height, format, source.role);
+  stat.encodeMs = timer.elapsedMs();
+  TextureCache(options_.textureCacheDir).store(source.cacheKey, compressed);
+  stat.bytes = static_cast<uint64_t>(width) * height * channels;
+  upload_compressed(textureID, std::move(compressed), source, stat);
+  return true;
+}
+
+void Model::upload_compressed(unsigned int textureID, CompressedTexture texture, const TextureSource &source,
+                              LoadReport::TextureStat &stat)
+{
+  stat.loaded = true;
+  stat.width = texture.width;
+  stat.height = texture.height;
+  stat.format = blockFormatName(texture.format);
+
+  // 缓存保存完整分辨率，分辨率上限在上传前应用
+  capTextureLevels(texture.levels, options_.maxTextureSize);
+  // 数组页资格按裁剪后实际上传的尺寸判断
+  if (collect_layers_ && source.role == TextureRole::Diffuse &&
+      std::max(texture.levels[0].width, texture.levels[0].height) <= options_.textureArrayMaxSize)
+  {
+    PendingLayer layer;
+    layer.texture = textureID;
+    layer.statIndex = load_report_.textures.size(); // 调用方随后把 stat 加入报告
+    layer.source = source;
+    layer.compressed = true;
+    layer.blockFormat = texture.format;
+    layer.internalFormat = glBlockFormat(texture.format);
+    layer.levels = std::move(texture.levels);
+    pending_layers_.push_back(std::move(layer));
+    return;
+  }
+  TextureBudget::TextureInfo info;
+  info.texture = textureID;
+  info.name = stat.path;
+  info.width = texture.levels[0].width;
+  info.height = texture.levels[0].height;
+  info.levelCount = static_cast<int>(texture.levels.size());
+  info.compressed = true;
+  info.internalFormat = glBlockFormat(texture.format);
+  info.texelBytes = blockFormatBytes(texture.format);
+
+  LoadTimer timer;
+  if (options_.streamTextures)
+  {
+    TextureStreamer::get_instance().enqueueCompressed(textureID, info.internalFormat, info.texelBytes,
+                                                      std::move(texture.levels));
+    stat.streamed = true;
+  }
+  else
+  {
+    uploadLevels(textureID, texture.levels, true, info.internalFormat, 0);
+  }
+  stat.uploadMs = timer.elapsedMs();
+  info.baseLevel = TextureStreamer::get_instance().residentLevel(textureID);
+  TextureBudget::get_instance().add(info, makeReloader(source, options_, true, texture.format, 0));
+  stat.gpuBytes = TextureBudget::get_instance().allocatedBytes(textureID);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void Model::build_texture_arrays()
+{
+  collect_layers_ = false;
+  std::vector<PendingLayer> pending = std::move(pending_layers_);
+  pending_layers_.clear();
+  if (pending.empty())
+    return;
+
+  // 按格式与尺寸分组（mip层数由尺寸与分辨率上限决定，也作为键的一部分）
+  std::map<std::tuple<bool, GLenum, GLenum, uint32_t, uint32_t, size_t>, std::vector<size_t>> groups;
+  for (size_t i = 0; i < pending.size(); i++)
+  {
+    const PendingLayer &layer = pending[i];
+    groups[std::make_tuple(layer.compressed, layer.internalFormat, layer.format, layer.levels[0].width,
+                           layer.levels[0].height, layer.levels.size())]
+        .push_back(i);
+  }
+
+  GLint maxLayers = 0;
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+  size_t pageLayers = std::max<size_t>(2, std::min<size_t>(maxLayers, kMaxPageLayers));
+  std::unordered_map<GLuint, std::pair<GLuint, int>> remap; // 2D纹理名 -> (数组页, 层)
+
+  GLint alignment = 4;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  for (const auto &group : groups)
+  {
+    const std::vector<size_t> &members = group.second;
+    for (size_t first = 0; first < members.size(); first += pageLayers)
+    {
+      size_t count = std::min(pageLayers, members.size() - first);
+      if (count < 2)
+      {
+        // 没有同类纹理，按普通2D纹理上传
+        PendingLayer &layer = pending[members[first]];
+        LoadReport::TextureStat &stat = load_report_.textures[layer.statIndex];
+        if (layer.compressed)
+        {
+          CompressedTexture texture;
+          texture.format = layer.blockFormat;
+          texture.width = layer.levels[0].width;
+          texture.height = layer.levels[0].height;
+          texture.levels = std::move(layer.levels);
+          upload_compressed(layer.texture, std::move(texture), layer.source, stat);
+        }
+        else
+        {
+          const TextureLevel &level = layer.levels[0];
+          upload_texture(layer.texture, level.data.data(), level.width, level.height, layer.internalFormat,
+                         layer.format, layer.source, stat);
+        }
+        continue;
+      }
+
+      const PendingLayer &base = pending[members[first]];
+      GLint levelCount = static_cast<GLint>(base.levels.size());
+      TextureArrayPage page;
+      page.width = base.levels[0].width;
+      page.height = base.levels[0].height;
+      page.layers = static_cast<int>(count);
+      glGenTextures(1, &page.texture);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, page.texture);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      for (GLint level = 0; level < levelCount; level++)
+      {
+        const TextureLevel &dims = base.levels[level];
+        GLsizei layerBytes = static_cast<GLsizei>(dims.data.size());
+        if (base.compressed)
+          glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, base.internalFormat, dims.width, dims.height,
+                                 page.layers, 0, layerBytes * page.layers, nullptr);
+        else
+          glTexImage3D(GL_TEXTURE_2D_ARRAY, level, base.internalFormat, dims.width, dims.height, page.layers, 0,
+                       base.format, GL_UNSIGNED_BYTE, nullptr);
+        page.bytes += uint64_t(layerBytes) * page.layers;
+      }
+      for (int i = 0; i < page.layers; i++)
+      {
+        PendingLayer &layer = pending[members[first + i]];
+        LoadReport::TextureStat &stat = load_report_.textures[layer.statIndex];
+        LoadTimer timer;
+        stat.gpuBytes = 0;
+        for (GLint level = 0; level < levelCount; level++)
+        {
+          const TextureLevel &data = layer.levels[level];
+          if (layer.compressed)
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, i, data.width, data.height, 1,
+                                      layer.internalFormat, static_cast<GLsizei>(data.data.size()), data.data.data());
+          else
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, i, data.width, data.height, 1, layer.format,
+                            GL_UNSIGNED_BYTE, data.data.data());
+          stat.gpuBytes += data.data.size();
+        }
+        stat.uploadMs = timer.elapsedMs();
+        stat.arrayLayer = i;
+        std::vector<TextureLevel>().swap(layer.levels);
+        glDeleteTextures(1, &layer.texture);
+        remap[layer.texture] = std::make_pair(page.texture, i);
+      }
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+      texture_pages_.push_back(page);
+    }
+  }
+
+  // 网格与已加载列表中的纹理改为引用数组页的层
+  auto patch = [&remap](Texture &texture)
+  {
+    auto it = remap.find(texture.id);
+    if (it == remap.end())
+      return;
+    texture.id = it->second.first;
+    texture.layer = it->second.second;
+  };
+  for (Texture &texture : textures_loaded)
+    patch(texture);
+  for (Mesh &mesh : meshes)
+  {
+    for (Texture &texture : mesh.textures)
+      patch(texture);
+  }
+}
+
+// 被多个节点引用的网格：实例矩阵按网格连续存放在一个缓冲中，每个网格的VAO指向自己的区段。
+// 加载报告记录合并的实例数与避免重复上传的顶点/索引字节数
+void Model::setup_instancing()
+{
+  LoadTimer timer;
+  std::vector<std::vector<uint32_t>> references(meshes.size());
+  for (uint32_t i = 0; i < instances_.size(); i++)
+    references[instances_[i].mesh].push_back(i);
+
+  uint64_t savedBytes = 0;
+  uint64_t folded = 0;
+  instance_slots_.clear();
+  std::vector<std::pair<uint32_t, size_t>> instancedMeshes; // (网格, 缓冲中的第一个槽位)
+  for (uint32_t mesh = 0; mesh < meshes.size(); mesh++)
+  {
+    const std::vector<uint32_t> &refs = references[mesh];
+    if (refs.size() < 2)
+      continue;
+    savedBytes += (refs.size() - 1) * meshes[mesh].gpuBytes();
+    // 动画模型的节点矩阵逐副本求出，不放入实例矩阵缓冲
+    if (!options_.instancing || !animation_.empty())
+      continue;
+    instancedMeshes.emplace_back(mesh, instance_slots_.size());
+    instance_slots_.insert(instance_slots_.end(), refs.begin(), refs.end());
+    folded += refs.size() - 1;
+  }
+
+  if (!instance_slots_.empty())
+  {
+    glGenBuffers(1, &instance_buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, instance_slots_.size() * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    upload_instance_matrices();
+    for (const auto &entry : instancedMeshes)
+    {
+      GLsizei count = static_cast<GLsizei>(references[entry.first].size());
+      meshes[entry.first].setInstanceBuffer(instance_buffer_, entry.second * sizeof(glm::mat4), count);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  load_report_.addStage("mesh_instancing", timer.elapsedMs(), folded, savedBytes);
+}
+
+void Model::upload_instance_matrices()
+{
+  if (!instance_buffer_)
+    return;
+  std::vector<glm::mat4> matrices(instance_slots_.size());
+  for (size_t i = 0; i < instance_slots_.size(); i++)
+    matrices[i] = scene_graph_.world(instances_[instance_slots_[i]].node);
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, matrices.size() * sizeof(glm::mat4), matrices.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// 同一数组页（或同一纹理）的网格排在一起，绘制时只需切换层号；实例化的网格只占一项
+void Model::build_draw_order()
+{
+  std::vector<uint32_t> order(instances_.size());
+  for (uint32_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                   {
+                     GLuint keyA = meshes[instances_[a].mesh].diffuseKey();
+                     GLuint keyB = meshes[instances_[b].mesh].diffuseKey();
+                     return keyA != keyB ? keyA < keyB : instances_[a].mesh < instances_[b].mesh; });
+
+  draw_items_.clear();
+  for (uint32_t i : order)
+  {
+    uint32_t mesh = instances_[i].mesh;
+    if (meshes[mesh].instanceCount() == 0)
+      draw_items_.push_back({mesh, i});
+    else if (draw_items_.empty() || draw_items_.back().mesh != mesh)
+      draw_items_.push_back({mesh, kInstancedDraw});
+  }
+}
+
 void Model::calculate_model_bounds(const aiScene *scene)
 {
   glm::vec3 scene_min(FLT_MAX);
   glm::vec3 scene_max(-FLT_MAX);
 
-  // 遍历场景中的所有网格，计算整个模型的边界
+  // 每个网格的局部包围盒只计算一次
+  std::vector<glm::vec3> meshMin(scene->mNumMeshes, glm::vec3(FLT_MAX));
+  std::vector<glm::vec3> meshMax(scene->mNumMeshes, glm::vec3(-FLT_MAX));
   for (unsigned int i = 0; i < scene->mNumMeshes; i++)
   {
     aiMesh *mesh = scene->mMeshes[i];
     for (unsigned int j = 0; j < mesh->mNumVertices; j++)
     {
       glm::vec3 pos(mesh->mVertices[j].x, mesh->mVertices[j].y, mesh->mVertices[j].z);
-      scene_min = glm::min(scene_min, pos);
-      scene_max = glm::max(scene_max, pos);
+      meshMin[i] = glm::min(meshMin[i], pos);
+      meshMax[i] = glm::max(meshMax[i], pos);
+    }
+  }
+
+  // 按引用网格的节点的累积变换变换包围盒的8个角点，得到整个模型的边界
+  std::vector<std::pair<const aiNode *, glm::mat4>> stack;
+  if (scene->mRootNode)
+    stack.emplace_back(scene->mRootNode, toGlm(scene->mRootNode->mTransformation));
+  while (!stack.empty())
+  {
+    const aiNode *node = stack.back().first;
+    glm::mat4 world = stack.back().second;
+    stack.pop_back();
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    {
+      unsigned int mesh = node->mMeshes[i];
+      if (meshMin[mesh].x > meshMax[mesh].x)
+        continue;
+      for (int corner = 0; corner < 8; corner++)
+      {
+        glm::vec3 local((corner & 1) ? meshMax[mesh].x : meshMin[mesh].x, (corner & 2) ? meshMax[mesh].y : meshMin[mesh].y,
+                        (corner & 4) ? meshMax[mesh].z : meshMin[mesh].z);
+        glm::vec3 pos = glm::vec3(world * glm::vec4(local, 1.0f));
+        scene_min = glm::min(scene_min, pos);
+        scene_max = glm::max(scene_max, pos);
+      }
     }
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+      stack.emplace_back(node->mChildren[i], world * toGlm(node->mChildren[i]->mTransformation));
   }
 
   // 计算整个模型的中心
@@ -293,14 +1623,10 @@ void Model::calculate_model_bounds(const aiScene *scene)
   // 模型坐标轴恢复原来的逻辑：根据标准化后的模型大小自适应
   modelAxisLength = targetSize * 1.25f;
 
-  std::cout << "整个模型边界计算:" << std::endl;
-  std::cout << "  最小点: (" << scene_min.x << ", " << scene_min.y << ", " << scene_min.z << ")" << std::endl;
-  std::cout << "  最大点: (" << scene_max.x << ", " << scene_max.y << ", " << scene_max.z << ")" << std::endl;
-  std::cout << "  模型中心: (" << model_center.x << ", " << model_center.y << ", " << model_center.z << ")" << std::endl;
-  std::cout << "  模型尺寸: (" << modelSize.x << ", " << modelSize.y << ", " << modelSize.z << ")" << std::endl;
-  std::cout << "  最大尺寸: " << maxDimension << std::endl;
-  std::cout << "  统一缩放因子: " << model_scale_factor << std::endl;
-  std::cout << "  坐标轴长度: " << modelAxisLength << " (根据标准化模型自适应)" << std::endl;
+  load_report_.boundsMin = scene_min;
+  load_report_.boundsMax = scene_max;
+  load_report_.center = model_center;
+  load_report_.scaleFactor = model_scale_factor;
 }
 
 void Model::addModelAxis(float length)
@@ -6,17 +6,87 @@
 
 #include "glad/glad.h"
 #include "mesh.h"
+#include "bvh.h"
+#include "load_report.h"
+#include "texture_codec.h"
+#include "scene_graph.h"
+#include "frame_pipeline.h"
+#include "animation.h"
+#include <atomic>
+
+// 网格CPU副本的保留策略
+enum class MeshRetention
+{
+  KeepAll,     // 保留完整顶点/索引副本
+  PickingOnly, // 上传后释放网格副本，仅保留BVH用的紧凑位置/索引
+  None         // 上传后释放网格副本且不构建BVH（禁用拾取）
+};
+
+// 模型文件的导入结果：Assimp读取与后处理，不涉及GL，可在工作线程上提前执行（见 Startup 的模型预取）
+struct ImportedScene
+{
+  std::unique_ptr<Assimp::Importer> importer; // 拥有 scene
+  const aiScene *scene = nullptr;
+  LoadReport report; // 导入各阶段的耗时
+  std::string error; // 导入失败的原因
+};
+
+struct ModelLoadOptions
+{
+  MeshRetention retention = MeshRetention::KeepAll;
+  bool compressTextures = true;                 // 转码为BC1/BC3/BC5块压缩纹理（不支持时回退为未压缩）
+  std::string textureCacheDir = "texture_cache"; // 转码结果的磁盘缓存目录，空字符串表示不缓存
+  bool streamTextures = true;                   // 纹理经PBO分帧上传（见 TextureStreamer），先显示低分辨率mip
+  uint32_t maxTextureSize = 0;                  // 纹理最大边长，超出时丢弃mip链顶部的层（0表示不限）
+  uint32_t textureArrayMaxSize = 1024;          // 边长不超过该值、尺寸与格式相同的漫反射纹理合并为纹理数组页（0表示不合并）
+  bool instancing = true;                       // 被多个节点引用的网格用 glDrawElementsInstanced 一次绘制
+};
+
+// 模型内存占用（字节）
+struct ModelMemoryStats
+{
+  uint64_t cpuVertexBytes = 0;      // 网格顶点副本
+  uint64_t cpuIndexBytes = 0;       // 网格索引副本
+  uint64_t cpuBvhBytes = 0;         // BVH节点与三角形数据
+  uint64_t textureStagingPeak = 0;  // 纹理解码的最大临时内存（上传后释放）
+  uint64_t textureStreamBytes = 0;  // 排队等待流式上传的mip数据
+  uint64_t gpuBufferBytes = 0;      // 顶点/索引缓冲与实例矩阵缓冲
+  uint64_t gpuTextureBytes = 0;     // 纹理当前分配的各mip层（随显存预算降级/恢复变化）
+
+  uint64_t cpuTotal() const { return cpuVertexBytes + cpuIndexBytes + cpuBvhBytes + textureStreamBytes; }
+  uint64_t gpuTotal() const { return gpuBufferBytes + gpuTextureBytes; }
+};
 
 class Model
 {
+  friend struct ModelBench; // 基准测试（bench.cpp）直接调用私有加载步骤
+
 public:
+  // 网格实例：场景图节点引用的网格（同一网格可被多个节点引用）
+  struct MeshInstance
+  {
+    uint32_t node;
+    uint32_t mesh;
+  };
+
+  // 上一次 draw 的绘制统计
+  struct DrawStats
+  {
+    uint64_t drawCalls = 0;      // 模型网格的绘制调用（不含坐标轴）
+    uint64_t instancedDraws = 0; // 其中的实例化绘制
+    uint64_t instances = 0;      // 绘制的实例总数（不使用实例化时的绘制调用数）
+    uint64_t culled = 0;         // 被视锥剔除的实例数
+    uint64_t skinnedDraws = 0;   // 蒙皮网格的绘制调用
+    uint64_t paletteBytes = 0;   // 上传的骨骼矩阵字节数
+  };
+
   std::vector<Texture> textures_loaded;
   std::vector<Mesh> meshes;
   std::string directory;
   bool gammaCorection;
 
-  glm::vec3 model_center;   // 整个模型的中心（用于顶点偏移）
-  float model_scale_factor; // 模型统一缩放因子
+  glm::vec3 model_center;   // 整个模型的中心（标准化变换的平移）
+  float model_scale_factor; // 模型统一缩放因子（场景图根节点的标准化变换）
 
 private:
   // 坐标轴相关成员变量
@@ -27,10 +97,79 @@ private:
   float modelAxisLength;             // 模型坐标轴长度
   float worldAxisLength;             // 世界坐标轴长度
 
+  Bvh bvh_;                // 模型三角形的BVH，用于射线拾取
+  LoadReport load_report_; // 加载各阶段耗时
+  ModelLoadOptions options_;
+
+  // 纹理数组页：尺寸与格式相同的小漫反射纹理共用一个 GL_TEXTURE_2D_ARRAY，网格通过层号引用
+  struct TextureArrayPage
+  {
+    GLuint texture = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int layers = 0;
+    uint64_t bytes = 0;
+  };
+  std::vector<TextureArrayPage> texture_pages_;
+  // 场景图：根节点为标准化变换（居中并统一缩放），其下为 aiNode 树；网格顶点保持局部坐标
+  SceneGraph scene_graph_;
+  std::vector<MeshInstance> instances_;
+  bool bvh_stale_ = false; // 节点移动后BVH未重建（KeepAll 下次拾取时重建，PickingOnly 无法重建）
+
+  // 绘制列表，按漫反射纹理（数组页）排序，同页的网格连续绘制。instance 为 kInstancedDraw 时
+  // 一次实例化绘制该网格的全部实例（矩阵来自 instance_buffer_），否则绘制单个实例
+  struct DrawItem
+  {
+    uint32_t mesh;
+    uint32_t instance;
+  };
+  static constexpr uint32_t kInstancedDraw = UINT32_MAX;
+  std::vector<DrawItem> draw_items_;
+  GLuint instance_buffer_ = 0;
+  std::vector<uint32_t> instance_slots_; // 实例矩阵缓冲中每个槽位对应的 instances_ 下标
+  DrawStats draw_stats_;
+  uint64_t geometry_version_ = 0;
+  // 已上传到实例矩阵缓冲的节点变换版本（GL线程写，帧准备读）。带着新矩阵的命令包被覆盖而没有提交时
+  // （如关闭流水线后就地重新准备），帧准备据此再次带上矩阵，不会丢失这次上传
+  std::atomic<uint64_t> uploaded_instance_version_{0};
+  TextureBindings draw_bindings_;    // 上一次 draw 的纹理绑定统计
+
+  // 骨骼动画：mesh_skins_ 把网格下标映射到 skins_（-1 表示不蒙皮）。动画模型不使用实例化绘制，
+  // 每个副本、每个网格实例单独绘制；骨骼矩阵每帧经纹理缓冲上传
+  Animation animation_;
+  std::vector<Animation::Skin> skins_;
+  std::vector<int32_t> mesh_skins_;
+  std::vector<std::vector<glm::mat4>> crowd_world_; // 每个副本的节点矩阵（帧准备期间使用）
+  std::vector<Animation::Scratch> anim_scratch_;    // 每个求值线程一份
+  // 常驻的求值线程（副本较多时使用），调用线程自己也分担一份；不在每帧创建和销毁线程
+  std::vector<std::unique_ptr<FramePipeline>> anim_workers_;
+  GLuint bone_buffer_ = 0;
+  GLuint bone_texture_ = 0;
+
 public:
-  Model(const char *path, bool gamma = false, bool createModelAxis = true, bool createWorldAxis = false);
-  ~Model() = default;
-  void draw(Shader *shader);
+  Model(const char *path, bool gamma = false, bool createModelAxis = true, bool createWorldAxis = false,
+        const ModelLoadOptions &options = ModelLoadOptions());
+  // 由已导入的模型文件创建（导入失败时抛出异常）
+  Model(std::unique_ptr<ImportedScene> imported, bool gamma = false, bool createModelAxis = true,
+        bool createWorldAxis = false, const ModelLoadOptions &options = ModelLoadOptions());
+  // 由内存中的场景创建（如程序生成的压力测试场景），场景需已三角化并带法线
+  Model(const aiScene *scene, const std::string &name, bool gamma = false, bool createModelAxis = true,
+        bool createWorldAxis = false, const ModelLoadOptions &options = ModelLoadOptions());
+  ~Model();
+  Model(const Model &) = delete;
+  Model &operator=(const Model &) = delete;
+  // 每个网格实例以 transform * 节点世界矩阵绘制（绘制前先更新被修改过的节点）
+  void draw(Shader *shader, const glm::mat4 &transform = glm::mat4(1.0f));
+  // 帧准备与提交分离：prepareFrame 只访问CPU数据，可在工作线程上为下一帧执行；
+  // submitFrame 在GL线程上按命令包绘制（两者之间不得修改场景图）
+  void prepareFrame(FramePacket &packet);
+  // upload 为 false 时调用方已对该命令包调用过 uploadFrame（例如深度预渲染在前）
+  void submitFrame(const FramePacket &packet, Shader *shader, bool upload = true);
+  void uploadFrame(const FramePacket &packet);                 // 上传命令包中变化的实例矩阵与骨骼矩阵
+  // 只写深度（深度程序，位置流），用于深度预渲染与阴影贴图；axes 为 false 时不画模型坐标轴
+  void submitDepth(const FramePacket &packet, Shader *shader, bool axes = true);
+  // 命令包中全部实例的世界空间包围盒（网格局部包围盒变换后合并；蒙皮网格按绑定姿态）
+  void packetBounds(const FramePacket &packet, glm::vec3 &boundsMin, glm::vec3 &boundsMax) const;
   void drawWorldAxis(Shader *shader); // 单独绘制世界坐标轴
 
   // 坐标轴控制方法
@@ -42,20 +181,100 @@ public:
   bool isWorldAxisVisible() const;        // 获取世界坐标轴显示状态
   float getModelScaleFactor() const;      // 获取模型统一缩放因子
 
+  // 射线拾取（模型空间）；节点移动后BVH过期，保留网格副本时在这里重建（与帧准备互斥，调用方持有场景锁）
+  bool pick(const Ray &ray, RayHit &hit);
+  const Bvh &bvh() const { return bvh_; }
+  bool bvhStale() const { return bvh_stale_; }
+  bool bvhRebuildable() const { return options_.retention == MeshRetention::KeepAll; }
+
+  // 场景图
+  const SceneGraph &sceneGraph() const { return scene_graph_; }
+  const std::vector<MeshInstance> &instances() const { return instances_; }
+  void setNodeTransform(uint32_t node, const glm::mat4 &local)
+  {
+    scene_graph_.setLocal(node, local);
+    geometry_version_++;
+  }
+  uint64_t geometryVersion() const { return geometry_version_; } // 节点变换每修改一次加一（阴影缓存据此失效）
+  const LoadReport &loadReport() const { return load_report_; }
+
+  // 内存统计
+  ModelMemoryStats memoryStats() const;
+  const ModelLoadOptions &loadOptions() const { return options_; }
+  size_t textureArrayPages() const { return texture_pages_.size(); }
+  const TextureBindings &drawBindings() const { return draw_bindings_; }
+  const DrawStats &drawStats() const { return draw_stats_; }
+
+  // 骨骼动画
+  const Animation &animation() const { return animation_; }
+  size_t skinCount() const { return skins_.size(); }
+
   // 坐标轴创建方法
   void createModelAxis(float length = 1.0f); // 创建模型坐标轴
   void createWorldAxis(float length = 5.0f); // 创建世界坐标轴
   void addModelAxis(float length = 1.0f);    // 添加模型坐标轴（向后兼容）
   void addWorldAxis(float length = 5.0f);    // 添加世界坐标轴（向后兼容）
 
-  unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma = false);
+  // 纹理的来源，用于显存预算重新加载被降级的纹理
+  struct TextureSource
+  {
+    std::string file;     // 源文件，内嵌纹理为空
+    std::string cacheKey; // 转码缓存键，未启用压缩时为空
+    TextureRole role = TextureRole::Diffuse;
+  };
+
+  // 读取模型文件并执行后处理（线程安全，不访问GL）；name 为逻辑名或路径
+  static std::unique_ptr<ImportedScene> importFile(const std::string &name);
+
+  unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma = false,
+                               TextureRole role = TextureRole::Diffuse);
+  unsigned int TextureFromEmbedded(const aiTexture *texture, const std::string &name,
+                                   TextureRole role = TextureRole::Diffuse);
 
 private:
-  void load_model(std::string const path);
-  void process_node(aiNode *node, const aiScene *scene);
+  static constexpr size_t kMaxPageLayers = 256; // 每个纹理数组页的最大层数
+
+  // 加载材质期间暂存的数组页候选纹理，所有材质处理完后由 build_texture_arrays 分组上传
+  struct PendingLayer
+  {
+    GLuint texture = 0;   // 预先生成的2D纹理名，合并进数组页后删除
+    size_t statIndex = 0; // load_report_.textures 中的下标
+    TextureSource source;
+    bool compressed = false;
+    BlockFormat blockFormat = BlockFormat::BC1;
+    GLenum internalFormat = 0;
+    GLenum format = 0;
+    std::vector<TextureLevel> levels; // 已按分辨率上限裁剪的完整mip链
+  };
+  std::vector<PendingLayer> pending_layers_;
+  bool collect_layers_ = false;
+
+  Model(); // 空模型，仅供基准测试构造合成场景使用
+  void load_imported(ImportedScene &imported);
+  void load_scene(const aiScene *scene);
+  void create_axes(bool createModelAxis, bool createWorldAxis);
+  void upload_texture(unsigned int textureID, const void *data, int width, int height, GLenum internalFormat,
+                      GLenum format, const TextureSource &source, LoadReport::TextureStat &stat);
+  // 块压缩路径：load_cached_texture 命中磁盘缓存时直接上传；compress_texture 转码、写缓存并上传。
+  // 当前GL不支持目标格式时返回false，调用方回退到未压缩上传
+  bool load_cached_texture(unsigned int textureID, const TextureSource &source, LoadReport::TextureStat &stat);
+  bool compress_texture(unsigned int textureID, const unsigned char *pixels, int width, int height, int channels,
+                        bool bgra, const TextureSource &source, LoadReport::TextureStat &stat);
+  void upload_compressed(unsigned int textureID, CompressedTexture texture, const TextureSource &source,
+                         LoadReport::TextureStat &stat);
+  // 先序遍历 aiNode 树加入场景图；meshIndex 把 aiMesh 下标映射到 meshes，每个网格只处理一次
+  void process_node(aiNode *node, const aiScene *scene, uint32_t parent, std::vector<uint32_t> &meshIndex);
   Mesh process_mesh(aiMesh *mesh, const aiScene *scene);
-  std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
-  void calculate_model_bounds(const aiScene *scene); // 新增：计算整个模型边界
+  std::vector<Texture> loadMaterialTextures(const aiScene *scene, aiMaterial *mat, aiTextureType type, std::string typeName);
+  void calculate_model_bounds(const aiScene *scene); // 计算整个模型（含节点变换）的边界
+  void build_bvh();                                  // 加载完成后构建拾取用BVH
+  void summarize_load_stages();                      // 汇总网格/纹理分项耗时到加载报告
+  void build_texture_arrays();                       // 把暂存的候选纹理按尺寸与格式合并为数组页
+  void setup_instancing();         // 多实例网格的实例矩阵放入同一缓冲并设置实例属性
+  void upload_instance_matrices(); // 节点世界矩阵变化后重新上传实例矩阵
+  void build_draw_order();
+  void prepare_animated(FramePacket &packet); // 动画帧：逐副本求姿态与骨骼矩阵并生成绘制命令
+  void upload_bone_palettes(const std::vector<glm::mat4> &palettes);
 
   // 坐标轴构建辅助函数
   Mesh createCylinder(glm::vec3 start, glm::vec3 end, float radius, glm::vec3 color, int segments = 12);
@@ -0,0 +1,705 @@
+#include "point_cloud.h"
+#include "bvh.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+  constexpr size_t kParallelMin = 65536;
+
+  template <typename Fn>
+  void parallelFor(size_t count, unsigned threads, Fn fn)
+  {
+    if (threads <= 1 || count < kParallelMin)
+    {
+      fn(size_t(0), count);
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++)
+    {
+      size_t begin = t * chunk;
+      size_t end = std::min(count, begin + chunk);
+      if (begin >= end)
+        break;
+      workers.emplace_back(fn, begin, end);
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  // 分段并行排序后逐轮两两归并
+  template <typename T, typename Less>
+  void parallelSort(std::vector<T> &items, unsigned threads, Less less)
+  {
+    size_t count = items.size();
+    if (threads <= 1 || count < kParallelMin)
+    {
+      std::sort(items.begin(), items.end(), less);
+      return;
+    }
+    size_t chunk = (count + threads - 1) / threads;
+    parallelFor(threads, threads, [&](size_t begin, size_t end)
+                {
+                  for (size_t t = begin; t < end; t++)
+                  {
+                    size_t first = std::min(count, t * chunk), last = std::min(count, first + chunk);
+                    std::sort(items.begin() + first, items.begin() + last, less);
+                  } });
+    for (size_t width = chunk; width < count; width *= 2)
+    {
+      size_t pairs = (count + 2 * width - 1) / (2 * width);
+      std::vector<std::thread> workers;
+      for (size_t p = 0; p < pairs; p++)
+      {
+        size_t first = p * 2 * width, middle = std::min(count, first + width), last = std::min(count, first + 2 * width);
+        if (middle < last)
+          workers.emplace_back([&items, first, middle, last, &less]
+                               { std::inplace_merge(items.begin() + first, items.begin() + middle, items.begin() + last, less); });
+      }
+      for (auto &worker : workers)
+        worker.join();
+    }
+  }
+
+  // 21位整数的位间插（Morton编码）及其逆运算
+  uint64_t splitBits(uint32_t value)
+  {
+    uint64_t x = value & 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+  }
+
+  uint32_t compactBits(uint64_t x)
+  {
+    x &= 0x1249249249249249ull;
+    x = (x ^ (x >> 2)) & 0x10c30c30c30c30c3ull;
+    x = (x ^ (x >> 4)) & 0x100f00f00f00f00full;
+    x = (x ^ (x >> 8)) & 0x1f0000ff0000ffull;
+    x = (x ^ (x >> 16)) & 0x1f00000000ffffull;
+    x = (x ^ (x >> 32)) & 0x1fffffull;
+    return static_cast<uint32_t>(x);
+  }
+
+  uint32_t packColor(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return uint32_t(r) | uint32_t(g) << 8 | uint32_t(b) << 16 | 0xff000000u;
+  }
+
+  std::string lowerExtension(const std::string &path)
+  {
+    size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    return ext;
+  }
+
+  // 每读到一个点回调一次；rgb 为空表示该文件没有颜色
+  using PointCallback = std::function<void(const double *, const uint8_t *)>;
+
+  enum class PlyType
+  {
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+  };
+
+  struct PlyProperty
+  {
+    PlyType type;
+    size_t offset;
+  };
+
+  struct PlyHeader
+  {
+    bool binaryLittleEndian = false;
+    uint64_t vertexCount = 0;
+    uint64_t faceCount = 0;
+    bool vertexFirst = true; // 顶点元素之前没有其他非空元素
+    bool vertexHasList = false;
+    size_t stride = 0;
+    int position[3] = {-1, -1, -1}; // properties 中的下标
+    int color[3] = {-1, -1, -1};
+    std::vector<PlyProperty> properties;
+    std::streamoff dataOffset = 0;
+  };
+
+  bool plyTypeFromName(const std::string &name, PlyType &type, size_t &size)
+  {
+    static const struct
+    {
+      const char *names[2];
+      PlyType type;
+      size_t size;
+    } kTypes[] = {{{"char", "int8"}, PlyType::Int8, 1},      {{"uchar", "uint8"}, PlyType::UInt8, 1},
+                  {{"short", "int16"}, PlyType::Int16, 2},   {{"ushort", "uint16"}, PlyType::UInt16, 2},
+                  {{"int", "int32"}, PlyType::Int32, 4},     {{"uint", "uint32"}, PlyType::UInt32, 4},
+                  {{"float", "float32"}, PlyType::Float32, 4}, {{"double", "float64"}, PlyType::Float64, 8}};
+    for (const auto &entry : kTypes)
+    {
+      if (name == entry.names[0] || name == entry.names[1])
+      {
+        type = entry.type;
+        size = entry.size;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  double readPlyValue(const uint8_t *data, PlyType type)
+  {
+    switch (type)
+    {
+    case PlyType::Int8:
+      return double(*reinterpret_cast<const int8_t *>(data));
+    case PlyType::UInt8:
+      return double(*data);
+    case PlyType::Int16:
+    {
+      int16_t v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case PlyType::UInt16:
+    {
+      uint16_t v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case PlyType::Int32:
+    {
+      int32_t v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case PlyType::UInt32:
+    {
+      uint32_t v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case PlyType::Float32:
+    {
+      float v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case PlyType::Float64:
+    {
+      double v;
+      std::memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    }
+    return 0.0;
+  }
+
+  bool readPlyHeader(std::ifstream &file, PlyHeader &header)
+  {
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, 3, "ply") != 0)
+      return false;
+    std::string element;
+    while (std::getline(file, line))
+    {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      std::istringstream in(line);
+      std::string keyword;
+      in >> keyword;
+      if (keyword == "format")
+      {
+        std::string format;
+        in >> format;
+        header.binaryLittleEndian = format == "binary_little_endian";
+      }
+      else if (keyword == "element")
+      {
+        uint64_t count = 0;
+        in >> element >> count;
+        if (element == "vertex")
+          header.vertexCount = count;
+        else if (element == "face")
+          header.faceCount = count;
+        else if (header.vertexCount == 0 && count > 0)
+          header.vertexFirst = false;
+      }
+      else if (keyword == "property" && element == "vertex")
+      {
+        std::string typeName, name;
+        in >> typeName;
+        if (typeName == "list")
+        {
+          header.vertexHasList = true;
+          continue;
+        }
+        in >> name;
+        PlyProperty property;
+        size_t size = 0;
+        if (!plyTypeFromName(typeName, property.type, size))
+          return false;
+        property.offset = header.stride;
+        header.stride += size;
+        int index = static_cast<int>(header.properties.size());
+        header.properties.push_back(property);
+        const char *axes[3] = {"x", "y", "z"};
+        const char *colors[3][3] = {{"red", "r", "diffuse_red"}, {"green", "g", "diffuse_green"}, {"blue", "b", "diffuse_blue"}};
+        for (int i = 0; i < 3; i++)
+        {
+          if (name == axes[i])
+            header.position[i] = index;
+          if (name == colors[i][0] || name == colors[i][1] || name == colors[i][2])
+            header.color[i] = index;
+        }
+      }
+      else if (keyword == "end_header")
+      {
+        header.dataOffset = file.tellg();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 二进制PLY（小端）：按块读取顶点元素
+  bool readPly(const std::string &path, const PointCallback &callback)
+  {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    PlyHeader header;
+    if (!file.is_open() || !readPlyHeader(file, header))
+      return false;
+    if (!header.binaryLittleEndian || !header.vertexFirst || header.vertexHasList || header.position[0] < 0 ||
+        header.position[1] < 0 || header.position[2] < 0)
+    {
+      std::cout << "点云只支持顶点元素在前、不含列表属性的 binary_little_endian PLY: " << path << std::endl;
+      return false;
+    }
+    bool hasColor = header.color[0] >= 0 && header.color[1] >= 0 && header.color[2] >= 0;
+
+    const uint64_t kBlockPoints = 65536;
+    std::vector<uint8_t> block(kBlockPoints * header.stride);
+    file.seekg(header.dataOffset);
+    for (uint64_t done = 0; done < header.vertexCount;)
+    {
+      uint64_t count = std::min(kBlockPoints, header.vertexCount - done);
+      file.read(reinterpret_cast<char *>(block.data()), static_cast<std::streamsize>(count * header.stride));
+      if (!file)
+        return false;
+      for (uint64_t i = 0; i < count; i++)
+      {
+        const uint8_t *vertex = block.data() + i * header.stride;
+        double position[3];
+        uint8_t rgb[3];
+        for (int k = 0; k < 3; k++)
+        {
+          const PlyProperty &p = header.properties[header.position[k]];
+          position[k] = readPlyValue(vertex + p.offset, p.type);
+          if (hasColor)
+          {
+            const PlyProperty &c = header.properties[header.color[k]];
+            double value = readPlyValue(vertex + c.offset, c.type);
+            // 16位与浮点颜色换算到8位
+            if (c.type == PlyType::UInt16)
+              value /= 257.0;
+            else if (c.type == PlyType::Float32 || c.type == PlyType::Float64)
+              value *= 255.0;
+            rgb[k] = static_cast<uint8_t>(std::clamp(value, 0.0, 255.0));
+          }
+        }
+        callback(position, hasColor ? rgb : nullptr);
+      }
+      done += count;
+    }
+    return true;
+  }
+
+  // 文本XYZ/PTS：每行 "x y z [r g b]" 或 PTS 的 "x y z 强度 r g b"；不足三个数的行（如PTS的点数行）跳过
+  bool readXyz(const std::string &path, const PointCallback &callback)
+  {
+    std::ifstream file(path);
+    if (!file.is_open())
+      return false;
+    std::string line;
+    double values[7];
+    while (std::getline(file, line))
+    {
+      const char *cursor = line.c_str();
+      int count = 0;
+      while (count < 7)
+      {
+        char *end = nullptr;
+        double value = std::strtod(cursor, &end);
+        if (end == cursor)
+          break;
+        values[count++] = value;
+        cursor = end;
+        while (*cursor == ',' || *cursor == ' ' || *cursor == '\t')
+          cursor++;
+      }
+      if (count < 3)
+        continue;
+      uint8_t rgb[3];
+      if (count >= 6)
+      {
+        int first = count == 7 ? 4 : 3;
+        for (int k = 0; k < 3; k++)
+          rgb[k] = static_cast<uint8_t>(std::clamp(values[first + k], 0.0, 255.0));
+      }
+      callback(values, count >= 6 ? rgb : nullptr);
+    }
+    return true;
+  }
+
+  bool readPoints(const std::string &path, const PointCallback &callback)
+  {
+    if (lowerExtension(path) == ".ply")
+      return readPly(path, callback);
+    return readXyz(path, callback);
+  }
+
+  // 无颜色的点按高度着色（蓝-绿-红）
+  uint32_t heightColor(float t)
+  {
+    t = std::clamp(t, 0.0f, 1.0f);
+    float r = std::clamp(2.0f * t - 1.0f, 0.0f, 1.0f);
+    float b = std::clamp(1.0f - 2.0f * t, 0.0f, 1.0f);
+    float g = 1.0f - r - b;
+    return packColor(static_cast<uint8_t>(r * 255.0f), static_cast<uint8_t>(g * 255.0f), static_cast<uint8_t>(b * 255.0f));
+  }
+} // namespace
+
+PointCloud::~PointCloud()
+{
+  release();
+}
+
+void PointCloud::release()
+{
+  if (vao_)
+  {
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &vbo_);
+    vao_ = vbo_ = 0;
+  }
+  nodes_.clear();
+  selected_.clear();
+  stats_ = Stats();
+}
+
+bool PointCloud::isPointCloudFile(const std::string &path)
+{
+  std::string ext = lowerExtension(path);
+  if (ext == ".xyz" || ext == ".pts")
+    return true;
+  if (ext != ".ply")
+    return false;
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  PlyHeader header;
+  return file.is_open() && readPlyHeader(file, header) && header.vertexCount > 0 && header.faceCount == 0;
+}
+
+// 按Morton码前缀递归划分；记录已排序，同一节点的点连续，子节点按码的下一组3位二分查找
+uint32_t PointCloud::build_node(const std::vector<PointRecord> &records, uint64_t first, uint64_t count, int level,
+                                const uint32_t cellMin[3])
+{
+  uint32_t index = static_cast<uint32_t>(nodes_.size());
+  nodes_.emplace_back();
+  Node &node = nodes_.back();
+  std::fill(std::begin(node.children), std::end(node.children), kNoChild);
+  std::copy(cellMin, cellMin + 3, node.cellMin);
+  node.level = static_cast<uint8_t>(level);
+  node.recordFirst = first;
+  node.recordCount = count;
+
+  if (count <= kLeafPoints || level == kCodeBits)
+  {
+    // 最深一层的重复点也只保留 kLeafPoints 个
+    node.count = static_cast<uint32_t>(std::min<uint64_t>(count, kLeafPoints));
+    return index;
+  }
+  node.leaf = false;
+  node.count = kSamplePoints;
+
+  int shift = 3 * (kCodeBits - level - 1);
+  uint32_t childSize = 1u << (kCodeBits - level - 1);
+  uint64_t begin = first;
+  for (uint32_t c = 0; c < 8 && begin < first + count; c++)
+  {
+    auto endIt = std::partition_point(records.begin() + begin, records.begin() + first + count,
+                                      [shift, c](const PointRecord &r)
+                                      { return ((r.code >> shift) & 7) <= c; });
+    uint64_t end = static_cast<uint64_t>(endIt - records.begin());
+    if (end == begin)
+      continue;
+    uint32_t childMin[3] = {cellMin[0] + (c & 1) * childSize, cellMin[1] + ((c >> 1) & 1) * childSize,
+                            cellMin[2] + ((c >> 2) & 1) * childSize};
+    uint32_t child = build_node(records, begin, end - begin, level + 1, childMin);
+    nodes_[index].children[c] = child;
+    begin = end;
+  }
+  return index;
+}
+
+bool PointCloud::load(const std::string &path, unsigned threads)
+{
+  release();
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  auto start = std::chrono::steady_clock::now();
+  auto elapsedMs = [](std::chrono::steady_clock::time_point from)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count();
+  };
+
+  // 第一遍：包围盒与点数（不保留原始坐标，内存只随点记录增长）
+  double boundsMin[3] = {DBL_MAX, DBL_MAX, DBL_MAX}, boundsMax[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+  uint64_t points = 0;
+  bool hasColor = false;
+  bool ok = readPoints(path, [&](const double *p, const uint8_t *rgb)
+                       {
+                         for (int k = 0; k < 3; k++)
+                         {
+                           boundsMin[k] = std::min(boundsMin[k], p[k]);
+                           boundsMax[k] = std::max(boundsMax[k], p[k]);
+                         }
+                         hasColor |= rgb != nullptr;
+                         points++; });
+  if (!ok || points == 0)
+  {
+    std::cout << "无法读取点云: " << path << std::endl;
+    return false;
+  }
+
+  // 第二遍：量化到包围立方体上的 2^21 网格并编码为Morton码
+  double cubeSize = std::max({boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2], 1e-9});
+  const double gridSize = double(1u << kCodeBits);
+  const uint32_t gridMax = (1u << kCodeBits) - 1;
+  std::vector<PointRecord> records;
+  records.reserve(points);
+  readPoints(path, [&](const double *p, const uint8_t *rgb)
+             {
+               if (records.size() == points)
+                 return;
+               uint32_t q[3];
+               for (int k = 0; k < 3; k++)
+                 q[k] = std::min(gridMax, static_cast<uint32_t>((p[k] - boundsMin[k]) / cubeSize * gridSize));
+               PointRecord record;
+               record.code = splitBits(q[0]) | splitBits(q[1]) << 1 | splitBits(q[2]) << 2;
+               record.color = rgb ? packColor(rgb[0], rgb[1], rgb[2]) : 0;
+               records.push_back(record); });
+  stats_.readMs = elapsedMs(start);
+
+  auto sortStart = std::chrono::steady_clock::now();
+  parallelSort(records, threads, [](const PointRecord &a, const PointRecord &b)
+               { return a.code < b.code; });
+  stats_.sortMs = elapsedMs(sortStart);
+
+  // 划分八叉树（只做二分查找，顺序执行），再并行把各节点的点编码为节点内坐标
+  auto buildStart = std::chrono::steady_clock::now();
+  const uint32_t origin[3] = {0, 0, 0};
+  build_node(records, 0, records.size(), 0, origin);
+  uint64_t stored = 0;
+  for (Node &node : nodes_)
+  {
+    node.first = stored;
+    stored += node.count;
+  }
+  float heightScale = 1.0f / float(std::max(1e-9, (boundsMax[1] - boundsMin[1]) / cubeSize * gridSize));
+  std::vector<PointVertex> vertices(stored);
+  parallelFor(nodes_.size(), threads, [&](size_t begin, size_t end)
+              {
+                for (size_t n = begin; n < end; n++)
+                {
+                  const Node &node = nodes_[n];
+                  int shift = std::max(0, kCodeBits - node.level - 16);
+                  for (uint32_t i = 0; i < node.count; i++)
+                  {
+                    // 在节点的记录区间中均匀抽样（叶子为全部点）
+                    const PointRecord &record = records[node.recordFirst + i * node.recordCount / node.count];
+                    uint32_t q[3] = {compactBits(record.code), compactBits(record.code >> 1), compactBits(record.code >> 2)};
+                    PointVertex &vertex = vertices[node.first + i];
+                    for (int k = 0; k < 3; k++)
+                      vertex.position[k] = static_cast<uint16_t>((q[k] - node.cellMin[k]) >> shift);
+                    vertex.padding = 0;
+                    uint32_t color = hasColor ? record.color : heightColor(q[1] * heightScale);
+                    std::memcpy(vertex.color, &color, sizeof(color));
+                  }
+                } });
+  // 峰值出现在归并排序（inplace_merge 的临时缓冲最多为半个数组）或编码顶点时，两者取大
+  stats_.peakHostBytes = records.capacity() * sizeof(PointRecord) +
+                         std::max<uint64_t>(points / 2 * sizeof(PointRecord), stored * sizeof(PointVertex));
+  std::vector<PointRecord>().swap(records);
+  stats_.buildMs = elapsedMs(buildStart);
+
+  auto uploadStart = std::chrono::steady_clock::now();
+  glGenVertexArrays(1, &vao_);
+  glGenBuffers(1, &vbo_);
+  glBindVertexArray(vao_);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PointVertex), vertices.data(), GL_STATIC_DRAW);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PointVertex), (void *)offsetof(PointVertex, position));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PointVertex), (void *)offsetof(PointVertex, color));
+  glBindVertexArray(0);
+  stats_.uploadMs = elapsedMs(uploadStart);
+
+  // 标准化：与 Model 相同，按实际包围盒（而非立方体）居中并缩放到最大边长2.0
+  glm::vec3 extent(float((boundsMax[0] - boundsMin[0]) / cubeSize * gridSize),
+                   float((boundsMax[1] - boundsMin[1]) / cubeSize * gridSize),
+                   float((boundsMax[2] - boundsMin[2]) / cubeSize * gridSize));
+  float scale = 2.0f / std::max(1.0f, std::max(extent.x, std::max(extent.y, extent.z)));
+  normalize_ = glm::scale(glm::mat4(1.0f), glm::vec3(scale)) * glm::translate(glm::mat4(1.0f), -extent * 0.5f);
+
+  path_ = path;
+  stats_.points = points;
+  stats_.storedPoints = stored;
+  stats_.hasColor = hasColor;
+  return true;
+}
+
+void PointCloud::update(const glm::mat4 &viewProjection, const glm::mat4 &transform, const glm::vec3 &cameraPosition,
+                        float viewportHeight, float fovY)
+{
+  selected_.clear();
+  draw_point_size_ = point_size_;
+  stats_.drawnNodes = 0;
+  stats_.drawnPoints = 0;
+  if (nodes_.empty())
+    return;
+  auto start = std::chrono::steady_clock::now();
+
+  // 在量化网格坐标系中计算：点间距与距离之比不受统一缩放影响
+  glm::mat4 toWorld = transform * normalize_;
+  glm::mat4 clip = viewProjection * toWorld;
+  glm::vec3 camera = glm::vec3(glm::inverse(toWorld) * glm::vec4(cameraPosition, 1.0f));
+  float pixelsPerRadian = viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+
+  auto nodeSize = [](const Node &node)
+  { return float(1u << (kCodeBits - node.level)); };
+  auto visible = [&](const Node &node)
+  {
+    glm::vec3 boundsMin(node.cellMin[0], node.cellMin[1], node.cellMin[2]);
+    return boxInFrustum(clip, boundsMin, boundsMin + glm::vec3(nodeSize(node)));
+  };
+  // 屏幕空间点间距（像素）：按表面采样估计节点内点间距为 边长 / sqrt(点数)
+  auto spacing = [&](const Node &node)
+  {
+    float size = nodeSize(node);
+    glm::vec3 boundsMin(node.cellMin[0], node.cellMin[1], node.cellMin[2]);
+    glm::vec3 d = glm::max(glm::max(boundsMin - camera, camera - (boundsMin + glm::vec3(size))), glm::vec3(0.0f));
+    float distance = std::max(glm::length(d), 1.0f);
+    return size / std::sqrt(float(node.count)) / distance * pixelsPerRadian;
+  };
+
+  // 从根开始，每次细化屏幕空间点间距最大的节点（替换为其可见子节点），直到间距达标或超出点数预算
+  using Item = std::pair<float, uint32_t>;
+  std::priority_queue<Item> queue;
+  uint64_t total = 0;
+  if (visible(nodes_[0]))
+  {
+    queue.emplace(spacing(nodes_[0]), 0);
+    total = nodes_[0].count;
+  }
+  while (!queue.empty())
+  {
+    Item item = queue.top();
+    queue.pop();
+    const Node &node = nodes_[item.second];
+    if (!node.leaf && item.first > target_spacing_)
+    {
+      uint32_t children[8];
+      int childCount = 0;
+      uint64_t childPoints = 0;
+      for (uint32_t child : node.children)
+      {
+        if (child != kNoChild && visible(nodes_[child]))
+        {
+          children[childCount++] = child;
+          childPoints += nodes_[child].count;
+        }
+      }
+      if (total - node.count + childPoints <= point_budget_)
+      {
+        total = total - node.count + childPoints;
+        for (int i = 0; i < childCount; i++)
+          queue.emplace(spacing(nodes_[children[i]]), children[i]);
+        continue;
+      }
+    }
+    selected_.push_back(item.second);
+  }
+
+  stats_.drawnNodes = static_cast<uint32_t>(selected_.size());
+  stats_.drawnPoints = total;
+  stats_.selectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PointCloud::draw(Shader *shader, const glm::mat4 &transform)
+{
+  if (selected_.empty())
+    return;
+
+  shader->setMat4("model", transform * normalize_);
+  shader->setFloat("pointSize", draw_point_size_);
+  GLint nodeMinLocation = glGetUniformLocation(shader->ID, "nodeMin");
+  GLint nodeScaleLocation = glGetUniformLocation(shader->ID, "nodeScale");
+
+  glEnable(GL_PROGRAM_POINT_SIZE);
+  glBindVertexArray(vao_);
+  for (uint32_t index : selected_)
+  {
+    const Node &node = nodes_[index];
+    int shift = std::max(0, kCodeBits - node.level - 16);
+    glUniform3f(nodeMinLocation, float(node.cellMin[0]), float(node.cellMin[1]), float(node.cellMin[2]));
+    glUniform1f(nodeScaleLocation, float(1u << shift));
+    glDrawArrays(GL_POINTS, static_cast<GLint>(node.first), static_cast<GLsizei>(node.count));
+  }
+  glBindVertexArray(0);
+  glDisable(GL_PROGRAM_POINT_SIZE);
+}
+
+void PointCloud::render_panel()
+{
+  if (!ImGui::CollapsingHeader("点云"))
+    return;
+
+  const double MB = 1024.0 * 1024.0;
+  ImGui::Text("文件: %s", path_.c_str());
+  ImGui::Text("点数: %llu (%s), 节点: %zu, 显存 %.1f MB", (unsigned long long)stats_.points,
+              stats_.hasColor ? "RGB" : "按高度着色", nodes_.size(), stats_.storedPoints * sizeof(PointVertex) / MB);
+  ImGui::Text("读取 %.0f ms, 排序 %.0f ms, 构建 %.0f ms, 上传 %.0f ms, 加载内存峰值 %.1f MB", stats_.readMs,
+              stats_.sortMs, stats_.buildMs, stats_.uploadMs, stats_.peakHostBytes / MB);
+  ImGui::Text("上一帧: %u 节点, %llu 点, 选择耗时 %.3f ms", stats_.drawnNodes, (unsigned long long)stats_.drawnPoints,
+              stats_.selectMs);
+
+  int budget = static_cast<int>(point_budget_ / 100000);
+  if (ImGui::SliderInt("每帧点数预算 (10万)", &budget, 1, 500))
+    point_budget_ = uint64_t(budget) * 100000;
+  ImGui::SliderFloat("目标点间距 (像素)", &target_spacing_, 0.5f, 8.0f);
+  ImGui::SliderFloat("点大小", &point_size_, 1.0f, 8.0f);
+}
@@ -0,0 +1,109 @@
+#ifndef __POINT_CLOUD_H
+#define __POINT_CLOUD_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 大规模点云（LiDAR扫描等）：不经过Assimp，直接读取二进制PLY或文本XYZ。
+// 点按包围立方体上的21位/轴网格量化并按Morton码排序（并行），再按码的前缀划分为八叉树：
+// 叶子保存全部点，内部节点保存按Morton顺序均匀抽取的子样本（替换式LOD）。
+// 每个节点的点以节点内16位坐标 + RGBA8 的12字节格式存放在同一个顶点缓冲中。
+// 绘制时按屏幕空间点间距从粗到细细化节点，直到点间距低于目标像素数或达到每帧点数预算。
+// 全部点记录在加载期间驻留内存、全部节点常驻同一个顶点缓冲，规模受内存与显存限制（见 Stats::peakHostBytes）；
+// 没有按节点换入换出的路径，分块流式加载只支持三角网格
+class PointCloud
+{
+public:
+  static constexpr int kCodeBits = 21;            // Morton码每轴位数
+  static constexpr uint32_t kLeafPoints = 32768;  // 点数不超过该值的节点不再划分
+  static constexpr uint32_t kSamplePoints = 8192; // 内部节点的子样本点数
+
+  // 12字节顶点：节点内量化坐标（乘以 nodeScale 后加 nodeMin）与颜色
+  struct PointVertex
+  {
+    uint16_t position[3];
+    uint16_t padding;
+    uint8_t color[4];
+  };
+
+  struct Node
+  {
+    uint32_t children[8];
+    uint32_t cellMin[3]; // 节点在量化网格中的最小角
+    uint8_t level = 0;
+    bool leaf = true;
+    uint64_t recordFirst = 0; // 排序后点记录中的区间（构建期间使用）
+    uint64_t recordCount = 0;
+    uint64_t first = 0; // 顶点缓冲中的区间
+    uint32_t count = 0;
+  };
+
+  struct Stats
+  {
+    uint64_t points = 0;       // 文件中的点数
+    uint64_t storedPoints = 0; // 含内部节点子样本
+    bool hasColor = false;
+    double readMs = 0.0;
+    double sortMs = 0.0;
+    double buildMs = 0.0;
+    double uploadMs = 0.0;
+    uint64_t peakHostBytes = 0; // 加载期间的内存峰值（点记录 + 归并缓冲，或点记录 + 顶点数据）
+    uint32_t drawnNodes = 0; // 上一帧
+    uint64_t drawnPoints = 0;
+    double selectMs = 0.0;
+  };
+
+  static constexpr uint32_t kNoChild = UINT32_MAX;
+
+private:
+  // 加载期间的点记录：Morton码与RGBA颜色
+  struct PointRecord
+  {
+    uint64_t code;
+    uint32_t color;
+  };
+
+  std::string path_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> selected_;
+  glm::mat4 normalize_ = glm::mat4(1.0f); // 量化网格坐标 -> 标准化空间（最大边长2.0并居中）
+  GLuint vao_ = 0, vbo_ = 0;
+  Stats stats_;
+
+  uint64_t point_budget_ = 5000000;
+  float target_spacing_ = 1.5f; // 屏幕空间点间距（像素）低于该值时不再细化
+  float point_size_ = 2.0f;
+  float draw_point_size_ = 2.0f; // update 时复制，draw 只读这份（渲染线程模式下绘制时面板可能修改设置）
+
+  uint32_t build_node(const std::vector<PointRecord> &records, uint64_t first, uint64_t count, int level,
+                      const uint32_t cellMin[3]);
+  void release();
+
+public:
+  PointCloud() = default;
+  ~PointCloud();
+  PointCloud(const PointCloud &) = delete;
+  PointCloud &operator=(const PointCloud &) = delete;
+
+  // 扩展名为 .xyz/.pts，或不含面的PLY
+  static bool isPointCloudFile(const std::string &path);
+
+  bool load(const std::string &path, unsigned threads = 0);
+
+  // 视锥剔除并按屏幕空间密度选择本帧绘制的节点；viewportHeight 与 fovY（弧度）用于换算像素。
+  // update 读取面板设置并写统计，须在场景锁内调用；draw 只读 update 的结果
+  void update(const glm::mat4 &viewProjection, const glm::mat4 &transform, const glm::vec3 &cameraPosition,
+              float viewportHeight, float fovY);
+  void draw(Shader *shader, const glm::mat4 &transform);
+
+  const Stats &stats() const { return stats_; }
+  size_t nodeCount() const { return nodes_.size(); }
+
+  void render_panel();
+};
+
+#endif
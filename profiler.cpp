@@ -0,0 +1,236 @@
+#include "profiler.h"
+#include "imgui.h"
+#include "imgui_stdlib.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+Profiler::Profiler() : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+Profiler::~Profiler()
+{
+  // GL上下文可能已销毁，查询对象随上下文一起释放
+}
+
+double Profiler::nowUs() const
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void Profiler::beginFrame()
+{
+  if (!enabled_)
+    return;
+
+  // 复用三帧前的槽位：先非阻塞地取回它的查询结果
+  FrameSlot &slot = slots_[frame_ % kFrameLatency];
+  if (slot.pending)
+    resolve(slot, false);
+
+  slot.record = FrameRecord();
+  slot.record.frame = frame_;
+  slot.record.cpuStartUs = nowUs();
+  slot.scopeQuery.clear();
+  slot.queryUsed = 0;
+  stack_.clear();
+  gpuScopeOpen_ = -1;
+  thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+  inFrame_ = true;
+}
+
+void Profiler::endFrame()
+{
+  if (!inFrame_)
+    return;
+
+  while (!stack_.empty())
+    endScope();
+
+  FrameSlot &slot = slots_[frame_ % kFrameLatency];
+  slot.record.cpuMs = (nowUs() - slot.record.cpuStartUs) / 1000.0;
+  slot.pending = true;
+  inFrame_ = false;
+  frame_++;
+}
+
+void Profiler::beginScope(const char *name, bool gpu)
+{
+  if (!onFrameThread() || !inFrame_)
+    return;
+
+  FrameSlot &slot = slots_[frame_ % kFrameLatency];
+  int index = static_cast<int>(slot.record.scopes.size());
+  slot.record.scopes.push_back({name, static_cast<int>(stack_.size()), nowUs(), 0.0, -1.0});
+
+  int query = -1;
+  if (gpu && gpuScopeOpen_ < 0)
+  {
+    if (slot.queryUsed == static_cast<int>(slot.queries.size()))
+    {
+      GLuint id = 0;
+      glGenQueries(1, &id);
+      slot.queries.push_back(id);
+    }
+    query = slot.queryUsed++;
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[query]);
+    gpuScopeOpen_ = index;
+  }
+  slot.scopeQuery.push_back(query);
+  stack_.push_back(index);
+}
+
+void Profiler::endScope()
+{
+  if (!onFrameThread() || !inFrame_ || stack_.empty())
+    return;
+
+  FrameSlot &slot = slots_[frame_ % kFrameLatency];
+  int index = stack_.back();
+  stack_.pop_back();
+
+  ScopeRecord &scope = slot.record.scopes[index];
+  scope.cpuMs = (nowUs() - scope.cpuStartUs) / 1000.0;
+  if (gpuScopeOpen_ == index)
+  {
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuScopeOpen_ = -1;
+  }
+}
+
+void Profiler::resolve(FrameSlot &slot, bool wait)
+{
+  slot.record.gpuMs = 0.0;
+  for (size_t i = 0; i < slot.record.scopes.size(); i++)
+  {
+    int query = slot.scopeQuery[i];
+    if (query < 0)
+      continue;
+
+    GLuint id = slot.queries[query];
+    GLint available = 0;
+    if (!wait)
+      glGetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!wait && !available)
+    {
+      // 结果仍未返回时丢弃，避免阻塞当前帧
+      continue;
+    }
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(id, GL_QUERY_RESULT, &elapsed);
+    slot.record.scopes[i].gpuMs = elapsed / 1.0e6;
+    slot.record.gpuMs += slot.record.scopes[i].gpuMs;
+  }
+
+  history_.push_back(std::move(slot.record));
+  while (history_.size() > kHistorySize)
+    history_.pop_front();
+  slot.pending = false;
+}
+
+void Profiler::flush()
+{
+  // 按帧序从旧到新取回
+  for (int i = 0; i < kFrameLatency; i++)
+  {
+    FrameSlot &slot = slots_[(frame_ + i) % kFrameLatency];
+    if (slot.pending)
+      resolve(slot, true);
+  }
+}
+
+const Profiler::FrameRecord *Profiler::findFrame(uint64_t frame) const
+{
+  for (auto it = history_.rbegin(); it != history_.rend(); ++it)
+  {
+    if (it->frame == frame)
+      return &*it;
+    if (it->frame < frame)
+      break;
+  }
+  return nullptr;
+}
+
+void Profiler::render_panel()
+{
+  ImGui::Checkbox("性能分析", &enabled_);
+  if (!enabled_ || history_.empty())
+    return;
+
+  // 滚动帧时间曲线
+  constexpr int kGraphFrames = 120;
+  float cpu[kGraphFrames] = {0.0f};
+  float gpu[kGraphFrames] = {0.0f};
+  int count = static_cast<int>(std::min<size_t>(kGraphFrames, history_.size()));
+  size_t first = history_.size() - count;
+  float maxMs = 1.0f;
+  for (int i = 0; i < count; i++)
+  {
+    cpu[i] = static_cast<float>(history_[first + i].cpuMs);
+    gpu[i] = static_cast<float>(history_[first + i].gpuMs);
+    maxMs = std::max(maxMs, std::max(cpu[i], gpu[i]));
+  }
+
+  const FrameRecord &last = history_.back();
+  char overlay[64];
+  snprintf(overlay, sizeof(overlay), "CPU %.2f ms", last.cpuMs);
+  ImGui::PlotLines("CPU帧时间", cpu, count, 0, overlay, 0.0f, maxMs, ImVec2(0, 50));
+  snprintf(overlay, sizeof(overlay), "GPU %.2f ms", last.gpuMs);
+  ImGui::PlotLines("GPU帧时间", gpu, count, 0, overlay, 0.0f, maxMs, ImVec2(0, 50));
+
+  // 各作用域耗时（最近一个已完成帧）
+  for (const ScopeRecord &scope : last.scopes)
+  {
+    if (scope.gpuMs >= 0.0)
+      ImGui::Text("%*s%s  CPU %.3f ms  GPU %.3f ms", scope.depth * 2, "", scope.name, scope.cpuMs, scope.gpuMs);
+    else
+      ImGui::Text("%*s%s  CPU %.3f ms", scope.depth * 2, "", scope.name, scope.cpuMs);
+  }
+
+  static std::string trace_path = "trace.json";
+  ImGui::InputText("Trace文件", &trace_path);
+  ImGui::SameLine();
+  if (ImGui::Button("导出Trace"))
+  {
+    dumpChromeTrace(trace_path);
+  }
+}
+
+// Chrome trace_event 格式：CPU作用域在线程1，GPU耗时在线程2（以CPU开始时间对齐）
+bool Profiler::dumpChromeTrace(const std::string &path) const
+{
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+  {
+    std::cout << "无法写入Trace文件: " << path << std::endl;
+    return false;
+  }
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+  file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+  file.setf(std::ios::fixed);
+  file.precision(3);
+  for (const FrameRecord &frame : history_)
+  {
+    file << ",\n{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << frame.cpuStartUs
+         << ",\"dur\":" << frame.cpuMs * 1000.0 << ",\"args\":{\"frame\":" << frame.frame << "}}";
+    for (const ScopeRecord &scope : frame.scopes)
+    {
+      file << ",\n{\"name\":\"" << scope.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << scope.cpuStartUs
+           << ",\"dur\":" << scope.cpuMs * 1000.0 << "}";
+      if (scope.gpuMs >= 0.0)
+      {
+        file << ",\n{\"name\":\"" << scope.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":" << scope.cpuStartUs
+             << ",\"dur\":" << scope.gpuMs * 1000.0 << "}";
+      }
+    }
+  }
+  file << "\n]}\n";
+
+  std::cout << "已导出Trace: " << path << "，帧数: " << history_.size() << std::endl;
+  return true;
+}
@@ -0,0 +1,114 @@
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 帧性能分析器：CPU作用域计时 + GL_TIME_ELAPSED 查询
+// GPU查询按帧三缓冲，结果在三帧后读取，不阻塞渲染
+// 只记录调用 beginFrame 的线程（持有GL上下文的线程）上的作用域，其他线程的作用域被忽略
+class Profiler
+{
+public:
+  struct ScopeRecord
+  {
+    const char *name;
+    int depth;
+    double cpuStartUs; // 相对分析器启动的微秒数
+    double cpuMs;
+    double gpuMs; // 非GPU作用域或查询未返回时为负数
+  };
+
+  struct FrameRecord
+  {
+    uint64_t frame = 0;
+    double cpuStartUs = 0.0;
+    double cpuMs = 0.0;
+    double gpuMs = 0.0; // 本帧所有GPU作用域之和
+    std::vector<ScopeRecord> scopes;
+  };
+
+private:
+  static constexpr int kFrameLatency = 3;    // 查询缓冲帧数
+  static constexpr size_t kHistorySize = 300; // 保留的已完成帧数
+
+  struct FrameSlot
+  {
+    FrameRecord record;
+    std::vector<int> scopeQuery; // 每个作用域对应的查询序号，-1表示仅CPU
+    std::vector<GLuint> queries;
+    int queryUsed = 0;
+    bool pending = false;
+  };
+
+  bool enabled_ = true;
+  uint64_t frame_ = 0;
+  bool inFrame_ = false;
+  std::atomic<std::thread::id> thread_{}; // 帧所在线程
+  FrameSlot slots_[kFrameLatency];
+  std::vector<int> stack_; // 当前打开的作用域
+  int gpuScopeOpen_ = -1;  // GL_TIME_ELAPSED 不能嵌套，同一时间只允许一个GPU作用域
+  std::chrono::steady_clock::time_point epoch_;
+
+  std::deque<FrameRecord> history_;
+
+  Profiler();
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  double nowUs() const;
+  bool onFrameThread() const { return thread_.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+  void resolve(FrameSlot &slot, bool wait);
+
+public:
+  ~Profiler();
+  static Profiler &get_instance()
+  {
+    static Profiler instance;
+    return instance;
+  }
+
+  void beginFrame();
+  void endFrame();
+  void beginScope(const char *name, bool gpu);
+  void endScope();
+  // 阻塞读取所有未返回的查询（回放结束或导出时使用）
+  void flush();
+
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  bool isEnabled() const { return enabled_; }
+  uint64_t frameIndex() const { return frame_; }
+
+  const std::deque<FrameRecord> &history() const { return history_; }
+  const FrameRecord *findFrame(uint64_t frame) const;
+
+  void render_panel();
+  bool dumpChromeTrace(const std::string &path) const;
+};
+
+// 作用域计时，gpu 为 true 时同时记录 GL_TIME_ELAPSED
+class ProfileScope
+{
+public:
+  ProfileScope(const char *name, bool gpu = false)
+  {
+    Profiler::get_instance().beginScope(name, gpu);
+  }
+  ~ProfileScope()
+  {
+    Profiler::get_instance().endScope();
+  }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name, true)
+
+#endif
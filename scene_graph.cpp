@@ -0,0 +1,82 @@
+#include "scene_graph.h"
+#include <algorithm>
+#include <stdexcept>
+
+uint32_t SceneGraph::addNode(uint32_t parent, const std::string &name, const glm::mat4 &local)
+{
+  uint32_t node = static_cast<uint32_t>(parents_.size());
+  if (parent != kNoParent && parent >= node)
+    throw std::invalid_argument("SceneGraph: parent must be added before its children");
+  parents_.push_back(parent);
+  names_.push_back(name);
+  local_.push_back(local);
+  world_.push_back(local);
+  normal_.push_back(glm::mat3(1.0f));
+  dirty_.push_back(1);
+  anyDirty_ = true;
+  return node;
+}
+
+void SceneGraph::clear()
+{
+  parents_.clear();
+  names_.clear();
+  local_.clear();
+  world_.clear();
+  normal_.clear();
+  dirty_.clear();
+  anyDirty_ = false;
+  lastUpdated_ = 0;
+  version_++;
+}
+
+void SceneGraph::setLocal(uint32_t node, const glm::mat4 &local)
+{
+  local_[node] = local;
+  dirty_[node] = 1;
+  anyDirty_ = true;
+}
+
+bool SceneGraph::update()
+{
+  lastUpdated_ = 0;
+  if (!anyDirty_)
+    return false;
+
+  // 父节点在前：扫描到子节点时父节点的脏标记与世界矩阵都已是最新的
+  for (size_t i = 0; i < parents_.size(); i++)
+  {
+    uint32_t parent = parents_[i];
+    if (parent != kNoParent && dirty_[parent])
+      dirty_[i] = 1;
+    if (!dirty_[i])
+      continue;
+    world_[i] = parent == kNoParent ? local_[i] : world_[parent] * local_[i];
+    normal_[i] = glm::transpose(glm::inverse(glm::mat3(world_[i])));
+    lastUpdated_++;
+  }
+  std::fill(dirty_.begin(), dirty_.end(), 0);
+  anyDirty_ = false;
+  version_++;
+  return true;
+}
+
+uint32_t SceneGraph::depth(uint32_t node) const
+{
+  uint32_t depth = 0;
+  while (parents_[node] != kNoParent)
+  {
+    node = parents_[node];
+    depth++;
+  }
+  return depth;
+}
+
+size_t SceneGraph::memoryBytes() const
+{
+  size_t bytes = parents_.capacity() * sizeof(uint32_t) + local_.capacity() * sizeof(glm::mat4) +
+                 world_.capacity() * sizeof(glm::mat4) + normal_.capacity() * sizeof(glm::mat3) + dirty_.capacity();
+  for (const std::string &name : names_)
+    bytes += sizeof(std::string) + name.capacity();
+  return bytes;
+}
@@ -0,0 +1,48 @@
+#ifndef __SCENE_GRAPH_H
+#define __SCENE_GRAPH_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 扁平场景图：节点按先序（父节点总在子节点之前）存放在连续数组中，父节点下标、局部/世界矩阵与
+// 脏标记分别保存。修改局部矩阵只标记该节点，update() 顺序扫描一遍，只重新计算自身或祖先被修改过的节点
+class SceneGraph
+{
+public:
+  static constexpr uint32_t kNoParent = UINT32_MAX;
+
+private:
+  std::vector<uint32_t> parents_;
+  std::vector<std::string> names_;
+  std::vector<glm::mat4> local_;
+  std::vector<glm::mat4> world_;
+  std::vector<glm::mat3> normal_; // 世界矩阵的法线矩阵（左上3x3的逆转置）
+  std::vector<uint8_t> dirty_;
+  bool anyDirty_ = false;
+  uint64_t version_ = 0;   // 世界矩阵每次更新后递增
+  size_t lastUpdated_ = 0; // 上一次 update() 重新计算的节点数
+
+public:
+  // parent 必须是已添加的节点（或 kNoParent），保证先序存放
+  uint32_t addNode(uint32_t parent, const std::string &name, const glm::mat4 &local);
+  void clear();
+
+  void setLocal(uint32_t node, const glm::mat4 &local);
+  bool update(); // 重新计算被修改节点及其子树的世界矩阵，返回是否有更新
+
+  size_t nodeCount() const { return parents_.size(); }
+  uint32_t parent(uint32_t node) const { return parents_[node]; }
+  const std::string &name(uint32_t node) const { return names_[node]; }
+  const glm::mat4 &local(uint32_t node) const { return local_[node]; }
+  const glm::mat4 &world(uint32_t node) const { return world_[node]; }
+  const glm::mat3 &normalMatrix(uint32_t node) const { return normal_[node]; }
+  uint32_t depth(uint32_t node) const;
+
+  uint64_t version() const { return version_; }
+  size_t lastUpdated() const { return lastUpdated_; }
+  size_t memoryBytes() const;
+};
+
+#endif
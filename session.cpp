@@ -0,0 +1,364 @@
+#include "session.h"
+#include "profiler.h"
+#include "GLFW/glfw3.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+static const char *kSessionHeader = "# gl_trackball session v1";
+
+// 鼠标采样标志位
+enum MouseFlag
+{
+  MouseFlag_Clicked = 1 << 0,
+  MouseFlag_Released = 1 << 1,
+  MouseFlag_Dragging = 1 << 2,
+  MouseFlag_Captured = 1 << 3,
+  MouseFlag_DoubleClicked = 1 << 4,
+};
+
+const char *sessionActionName(SessionAction action)
+{
+  switch (action)
+  {
+  case SessionAction::Calibrate:
+    return "calibrate";
+  case SessionAction::ResetCalibrated:
+    return "reset_calibrated";
+  case SessionAction::ResetDefault:
+    return "reset_default";
+  case SessionAction::LoadModel:
+    return "load_model";
+  case SessionAction::SetReverse:
+    return "set_reverse";
+  case SessionAction::Roll:
+    return "roll";
+  case SessionAction::SetCameraPosition:
+    return "set_camera_position";
+  }
+  return "unknown";
+}
+
+bool sessionActionFromName(const std::string &name, SessionAction &action)
+{
+  static const SessionAction all[] = {SessionAction::Calibrate, SessionAction::ResetCalibrated,
+                                      SessionAction::ResetDefault, SessionAction::LoadModel,
+                                      SessionAction::SetReverse, SessionAction::Roll,
+                                      SessionAction::SetCameraPosition};
+  for (SessionAction candidate : all)
+  {
+    if (name == sessionActionName(candidate))
+    {
+      action = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// ---------------------------------------------------------------------------
+// SessionRecorder
+// ---------------------------------------------------------------------------
+
+bool SessionRecorder::open(const std::string &path)
+{
+  file_.open(path, std::ios::out | std::ios::trunc);
+  if (!file_.is_open())
+  {
+    std::cout << "无法创建会话录制文件: " << path << std::endl;
+    return false;
+  }
+  // 使用足够的精度保证回放时鼠标坐标与时间戳完全一致
+  file_.precision(9);
+  file_ << kSessionHeader << "\n";
+  startTime_ = glfwGetTime();
+  frame_ = 0;
+  eventCount_ = 0;
+  return true;
+}
+
+void SessionRecorder::close()
+{
+  if (file_.is_open())
+  {
+    file_.flush();
+    file_.close();
+    std::cout << "会话录制完成，帧数: " << frame_ << "，事件数: " << eventCount_ << std::endl;
+  }
+}
+
+double SessionRecorder::elapsed() const
+{
+  return glfwGetTime() - startTime_;
+}
+
+// M <frame> <time> <x> <y> <width> <height> <flags>
+void SessionRecorder::recordMouse(const MouseSample &sample)
+{
+  if (!file_.is_open())
+    return;
+  int flags = (sample.clicked ? MouseFlag_Clicked : 0) |
+              (sample.released ? MouseFlag_Released : 0) |
+              (sample.dragging ? MouseFlag_Dragging : 0) |
+              (sample.captured ? MouseFlag_Captured : 0) |
+              (sample.doubleClicked ? MouseFlag_DoubleClicked : 0);
+  file_ << "M " << frame_ << " " << elapsed() << " "
+        << sample.position.x << " " << sample.position.y << " "
+        << sample.displaySize.x << " " << sample.displaySize.y << " " << flags << "\n";
+  eventCount_++;
+}
+
+// S <frame> <time> <xoffset> <yoffset>
+void SessionRecorder::recordScroll(double xoffset, double yoffset)
+{
+  if (!file_.is_open())
+    return;
+  file_ << "S " << frame_ << " " << elapsed() << " " << xoffset << " " << yoffset << "\n";
+  eventCount_++;
+}
+
+// A <frame> <time> <action> [arg]
+void SessionRecorder::recordAction(SessionAction action, const std::string &arg)
+{
+  if (!file_.is_open())
+    return;
+  file_ << "A " << frame_ << " " << elapsed() << " " << sessionActionName(action);
+  if (!arg.empty())
+    file_ << " " << arg;
+  file_ << "\n";
+  eventCount_++;
+}
+
+// ---------------------------------------------------------------------------
+// SessionPlayer
+// ---------------------------------------------------------------------------
+
+bool SessionPlayer::load(const std::string &path)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    std::cout << "无法打开会话文件: " << path << std::endl;
+    return false;
+  }
+
+  events_.clear();
+  std::string line;
+  size_t lineNumber = 0;
+  while (std::getline(file, line))
+  {
+    lineNumber++;
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream in(line);
+    char tag = 0;
+    SessionEvent event;
+    in >> tag >> event.frame >> event.time;
+    if (tag == 'M')
+    {
+      int flags = 0;
+      event.type = SessionEvent::Mouse;
+      in >> event.mouse.position.x >> event.mouse.position.y >> event.mouse.displaySize.x >> event.mouse.displaySize.y >> flags;
+      event.mouse.clicked = flags & MouseFlag_Clicked;
+      event.mouse.released = flags & MouseFlag_Released;
+      event.mouse.dragging = flags & MouseFlag_Dragging;
+      event.mouse.captured = flags & MouseFlag_Captured;
+      event.mouse.doubleClicked = flags & MouseFlag_DoubleClicked;
+    }
+    else if (tag == 'S')
+    {
+      event.type = SessionEvent::Scroll;
+      in >> event.scrollX >> event.scrollY;
+    }
+    else if (tag == 'A')
+    {
+      std::string name;
+      event.type = SessionEvent::Action;
+      in >> name;
+      if (!sessionActionFromName(name, event.action))
+      {
+        std::cout << "会话文件第 " << lineNumber << " 行包含未知动作: " << name << std::endl;
+        continue;
+      }
+      std::getline(in >> std::ws, event.arg);
+    }
+    else
+    {
+      std::cout << "会话文件第 " << lineNumber << " 行格式错误" << std::endl;
+      continue;
+    }
+
+    if (in.fail())
+    {
+      std::cout << "会话文件第 " << lineNumber << " 行格式错误" << std::endl;
+      continue;
+    }
+    events_.push_back(event);
+  }
+
+  // 事件按帧序号排序（同一帧内保持文件中的先后顺序）
+  std::stable_sort(events_.begin(), events_.end(), [](const SessionEvent &a, const SessionEvent &b)
+                   { return a.frame < b.frame; });
+  lastFrame_ = events_.empty() ? 0 : events_.back().frame;
+  std::cout << "已加载会话: " << path << "，事件数: " << events_.size() << "，帧数: " << frameCount() << std::endl;
+  return !events_.empty();
+}
+
+void SessionPlayer::start(bool fast)
+{
+  fast_ = fast;
+  finished_ = events_.empty();
+  reported_ = false;
+  cursor_ = 0;
+  frame_ = 0;
+  timings_.clear();
+  timings_.reserve(frameCount());
+  resolved_ = 0;
+  startTime_ = glfwGetTime();
+}
+
+void SessionPlayer::waitForFrame()
+{
+  if (finished_ || fast_)
+    return;
+
+  // 按录制速度回放：等待到该帧第一个事件的录制时间
+  double frameTime = -1.0;
+  for (size_t i = cursor_; i < events_.size() && events_[i].frame <= frame_; i++)
+  {
+    if (frameTime < 0.0 || events_[i].time < frameTime)
+      frameTime = events_[i].time;
+  }
+  double remaining = frameTime - (glfwGetTime() - startTime_);
+  if (frameTime > 0.0 && remaining > 0.0)
+    std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+}
+
+void SessionPlayer::beginFrame()
+{
+  frameEvents_.clear();
+  hasFrameMouse_ = false;
+  if (finished_)
+    return;
+
+  // 收集属于当前帧的事件
+  while (cursor_ < events_.size() && events_[cursor_].frame <= frame_)
+  {
+    const SessionEvent &event = events_[cursor_++];
+    if (event.type == SessionEvent::Mouse)
+    {
+      frameMouse_ = event.mouse;
+      hasFrameMouse_ = true;
+    }
+    else
+    {
+      frameEvents_.push_back(event);
+    }
+  }
+}
+
+void SessionPlayer::takeFrameEvents(std::vector<SessionEvent> &out)
+{
+  out.swap(frameEvents_);
+  frameEvents_.clear();
+}
+
+bool SessionPlayer::mouseSample(MouseSample &out) const
+{
+  if (!hasFrameMouse_)
+    return false;
+  out = frameMouse_;
+  return true;
+}
+
+void SessionPlayer::endFrame()
+{
+  if (finished_)
+    return;
+
+  frame_++;
+  if (frame_ > lastFrame_)
+  {
+    finished_.store(true, std::memory_order_release);
+  }
+}
+
+void SessionPlayer::recordFrame(uint64_t frame)
+{
+  // 刚结束的 Profiler 帧；GPU查询要几帧后才返回，这里只记录帧序号，结果稍后取回
+  timings_.push_back({frame, Profiler::get_instance().frameIndex() - 1, -1.0, -1.0});
+  collectTimings();
+}
+
+void SessionPlayer::collectTimings()
+{
+  Profiler &profiler = Profiler::get_instance();
+  while (resolved_ < timings_.size())
+  {
+    FrameTiming &timing = timings_[resolved_];
+    if (timing.profilerFrame >= profiler.frameIndex())
+      break;
+    const Profiler::FrameRecord *record = profiler.findFrame(timing.profilerFrame);
+    if (!record)
+    {
+      // 查询结果尚未取回
+      if (profiler.history().empty() || profiler.history().back().frame < timing.profilerFrame)
+        break;
+    }
+    else
+    {
+      timing.cpuMs = record->cpuMs;
+      timing.gpuMs = record->gpuMs;
+    }
+    resolved_++;
+  }
+}
+
+bool SessionPlayer::writeReport(const std::string &path)
+{
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+  {
+    std::cout << "无法写入回放报告: " << path << std::endl;
+    reported_.store(true, std::memory_order_release); // 写不出报告也算回放结束，退出与帧节奏照常恢复
+    return false;
+  }
+
+  // 回放最后几帧的计时仍在 Profiler 的查询缓冲中
+  Profiler::get_instance().flush();
+  collectTimings();
+
+  file << "frame,cpu_ms,gpu_ms\n";
+  std::vector<double> cpu, gpu;
+  for (const FrameTiming &timing : timings_)
+  {
+    file << timing.frame << "," << timing.cpuMs << "," << timing.gpuMs << "\n";
+    if (timing.cpuMs >= 0.0)
+      cpu.push_back(timing.cpuMs);
+    if (timing.gpuMs >= 0.0)
+      gpu.push_back(timing.gpuMs);
+  }
+
+  auto summarize = [](const char *name, std::vector<double> values)
+  {
+    if (values.empty())
+      return;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values)
+      sum += v;
+    std::cout << "  " << name << " 平均: " << sum / values.size()
+              << " ms, p50: " << values[values.size() / 2]
+              << " ms, p95: " << values[std::min(values.size() - 1, values.size() * 95 / 100)]
+              << " ms, 最大: " << values.back() << " ms" << std::endl;
+  };
+
+  std::cout << "回放完成，帧数: " << timings_.size() << "，报告: " << path << std::endl;
+  summarize("CPU", cpu);
+  summarize("GPU", gpu);
+  reported_.store(true, std::memory_order_release);
+  return true;
+}
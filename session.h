@@ -0,0 +1,145 @@
+#ifndef __SESSION_H
+#define __SESSION_H
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 一帧的鼠标输入快照（来源于ImGui IO，或来自回放文件）
+struct MouseSample
+{
+  glm::vec2 position = glm::vec2(0.0f);    // 鼠标位置（窗口坐标）
+  glm::vec2 displaySize = glm::vec2(1.0f); // 窗口显示尺寸
+  bool clicked = false;                    // 本帧左键按下
+  bool doubleClicked = false;              // 本帧左键双击
+  bool released = false;                   // 本帧左键松开
+  bool dragging = false;                   // 左键正在拖拽
+  bool captured = false;                   // ImGui占用鼠标
+};
+
+// 可录制的面板动作
+enum class SessionAction
+{
+  Calibrate,         // 校准当前角度
+  ResetCalibrated,   // 重置到校准角度
+  ResetDefault,      // 重置到默认角度
+  LoadModel,         // 加载模型，参数为模型路径
+  SetReverse,        // 反向控制开关，参数为 0/1
+  Roll,              // 滚转，参数为角度
+  SetCameraPosition, // 设置相机位置，参数为 "x y z"
+};
+
+const char *sessionActionName(SessionAction action);
+bool sessionActionFromName(const std::string &name, SessionAction &action);
+
+struct SessionEvent
+{
+  enum Type
+  {
+    Mouse,
+    Scroll,
+    Action
+  };
+
+  Type type = Mouse;
+  uint64_t frame = 0; // 事件所属帧序号（从录制开始计数）
+  double time = 0.0;  // 距录制开始的秒数
+
+  MouseSample mouse;
+  double scrollX = 0.0;
+  double scrollY = 0.0;
+  SessionAction action = SessionAction::Calibrate;
+  std::string arg;
+};
+
+// 会话录制：把每帧鼠标采样、滚轮和面板动作按时间戳写入文本文件
+class SessionRecorder
+{
+private:
+  std::ofstream file_;
+  double startTime_ = 0.0;
+  uint64_t frame_ = 0;
+  uint64_t eventCount_ = 0;
+
+  double elapsed() const;
+
+public:
+  bool open(const std::string &path);
+  void close();
+  bool isOpen() const { return file_.is_open(); }
+
+  void recordMouse(const MouseSample &sample);
+  void recordScroll(double xoffset, double yoffset);
+  void recordAction(SessionAction action, const std::string &arg);
+  void nextFrame() { frame_++; }
+
+  uint64_t frame() const { return frame_; }
+  uint64_t eventCount() const { return eventCount_; }
+};
+
+// 会话回放：按帧把录制的事件重新注入Core，每帧CPU/GPU耗时取自 Profiler
+class SessionPlayer
+{
+public:
+  struct FrameTiming
+  {
+    uint64_t frame;
+    uint64_t profilerFrame; // 对应的 Profiler 帧序号
+    double cpuMs;
+    double gpuMs; // 查询结果未返回时为负数
+  };
+
+private:
+  std::vector<SessionEvent> events_;
+  size_t cursor_ = 0;
+  std::vector<SessionEvent> frameEvents_; // 当前帧的滚轮与面板事件
+  MouseSample frameMouse_;                // 当前帧的鼠标采样
+  bool hasFrameMouse_ = false;
+  uint64_t frame_ = 0;
+  uint64_t lastFrame_ = 0;
+  bool fast_ = false;
+  std::atomic<bool> finished_{true};  // 事件已全部注入（主线程写，GL线程读）
+  std::atomic<bool> reported_{false}; // 报告已写出（GL线程写，主线程读）
+  double startTime_ = 0.0;
+
+  // 计时与报告只在持有GL上下文的线程上访问（报告写出后面板才读取）
+  std::vector<FrameTiming> timings_;
+  size_t resolved_ = 0; // 已从 Profiler 取回耗时的帧数
+
+  void collectTimings();
+
+public:
+  SessionPlayer() = default;
+  ~SessionPlayer() = default;
+
+  bool load(const std::string &path);
+  void start(bool fast);
+
+  // 按录制速度回放时等待到当前帧的录制时间（在帧计时开始前调用）
+  void waitForFrame();
+  // 帧开始：收集当前帧的事件（处理输入的线程）
+  void beginFrame();
+  // 取出当前帧的滚轮与面板事件（鼠标采样通过 mouseSample 获取）
+  void takeFrameEvents(std::vector<SessionEvent> &out);
+  bool mouseSample(MouseSample &out) const;
+  // 帧结束：前进到下一帧（处理输入的线程）
+  void endFrame();
+  // 记录呈现回放帧 frame 的那一帧的计时（持有GL上下文的线程，在 Profiler::endFrame 之后调用）。
+  // 渲染线程模式下输入帧与渲染帧不一一对应，没有被呈现的回放帧不计时
+  void recordFrame(uint64_t frame);
+
+  bool isFinished() const { return finished_.load(std::memory_order_acquire); }
+  bool isReported() const { return reported_.load(std::memory_order_acquire); }
+  bool isFast() const { return fast_; }
+  uint64_t frame() const { return frame_; }
+  uint64_t frameCount() const { return lastFrame_ + 1; }
+  const std::vector<FrameTiming> &timings() const { return timings_; }
+
+  // 写出逐帧耗时CSV，并在控制台打印汇总（持有GL上下文的线程：需要取回 Profiler 的查询结果）
+  bool writeReport(const std::string &path);
+};
+
+#endif
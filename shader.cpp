@@ -1,45 +1,29 @@
 #include "shader.h"
+#include "asset_archive.h"
 
 Shader::Shader(const char *vertexPath, const char *fragmentPath)
 {
-  std::string vertexCode;
-  std::string fragmentCode;
-  std::ifstream vShaderFile;
-  std::ifstream fShaderFile;
-
-  vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-  fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-  try
-  {
-    vShaderFile.open(vertexPath);
-    fShaderFile.open(fragmentPath);
-
-    std::stringstream vShaderStream, fShaderStream;
-    vShaderStream << vShaderFile.rdbuf();
-    fShaderStream << fShaderFile.rdbuf();
-
-    vShaderFile.close();
-    fShaderFile.close();
-
-    vertexCode = vShaderStream.str();
-    fragmentCode = fShaderStream.str();
-  }
-  catch (std::ifstream::failure e)
+  // 源码优先取自资源包的映射内存（按长度传给GL，无需结尾的0），否则从文件读入
+  AssetArchive &archive = AssetArchive::get_instance();
+  std::vector<char> vertexStorage, fragmentStorage;
+  AssetArchive::Blob vertexSource = archive.read(vertexPath, vertexStorage);
+  AssetArchive::Blob fragmentSource = archive.read(fragmentPath, fragmentStorage);
+  if (!vertexSource || !fragmentSource)
   {
-    std::cout << "ERROR::SHADER::FILE_NO_SUCCESFULLY_READ:\n"
-              << e.what() << std::endl;
+    std::cout << "ERROR::SHADER::FILE_NO_SUCCESFULLY_READ: " << (vertexSource ? fragmentPath : vertexPath) << std::endl;
   }
 
-  const char *vShaderCode = vertexCode.c_str();
-  const char *fShaderCode = fragmentCode.c_str();
+  const char *vShaderCode = vertexSource ? vertexSource.data : "";
+  const char *fShaderCode = fragmentSource ? fragmentSource.data : "";
+  GLint vShaderLength = static_cast<GLint>(vertexSource.size);
+  GLint fShaderLength = static_cast<GLint>(fragmentSource.size);
 
   unsigned int vertex, fragment;
   int success;
 
   char infoLog[512];
   vertex = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertex, 1, &vShaderCode, NULL);
+  glShaderSource(vertex, 1, &vShaderCode, &vShaderLength);
   glCompileShader(vertex);
 
   glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
@@ -52,7 +36,7 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
   }
 
   fragment = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragment, 1, &fShaderCode, NULL);
+  glShaderSource(fragment, 1, &fShaderCode, &fShaderLength);
   glCompileShader(fragment);
 
   glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
@@ -0,0 +1,244 @@
+#include "shadow_map.h"
+#include "mesh.h"
+#include "profiler.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+  glm::vec3 lightDirection(const ShadowMap::Light &light)
+  {
+    glm::vec3 direction = light.target - light.position;
+    float length = glm::length(direction);
+    return length > 1e-6f ? direction / length : glm::vec3(0.0f, -1.0f, 0.0f);
+  }
+
+  glm::vec3 upVector(const glm::vec3 &direction)
+  {
+    return std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+  }
+}
+
+void ShadowMap::init(const char *vertexPath, const char *fragmentPath)
+{
+  shader_ = std::make_unique<Shader>(vertexPath, fragmentPath);
+  shader_->use();
+  shader_->setInt("bonePalette", Mesh::kBonePaletteUnit);
+  glGenFramebuffers(1, &fbo_);
+  glGenTextures(1, &texture_);
+  allocate();
+}
+
+void ShadowMap::allocate()
+{
+  glBindTexture(GL_TEXTURE_2D, texture_);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size_, size_, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+  // 线性过滤 + 比较模式：每次采样由硬件完成2x2比较并插值
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+  // 贴图之外视为不在阴影中
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+  const float border[] = {1.0f, 1.0f, 1.0f, 1.0f};
+  glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  GLint framebuffer = 0;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture_, 0);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+  allocated_size_ = size_;
+  valid_ = false;
+  stale_ = true;
+}
+
+void ShadowMap::release()
+{
+  glDeleteFramebuffers(1, &fbo_);
+  glDeleteTextures(1, &texture_);
+  fbo_ = texture_ = 0;
+  allocated_size_ = 0;
+  valid_ = false;
+  shader_.reset();
+}
+
+void ShadowMap::invalidate(const char *reason)
+{
+  if (valid_)
+    reason_ = reason;
+  valid_ = false;
+  stale_ = true;
+}
+
+void ShadowMap::latch()
+{
+  frame_.enabled = enabled_;
+  frame_.light = light_;
+  frame_.bias = bias_;
+  frame_.pcfRadius = pcf_radius_;
+}
+
+bool ShadowMap::needsUpdate(const SceneKey &key)
+{
+  if (!frame_.enabled || !fbo_)
+    return false;
+  if (allocated_size_ != size_)
+  {
+    allocate();
+    reason_ = "贴图尺寸";
+  }
+  else if (stale_)
+  {
+    if (!*reason_)
+      reason_ = "首次绘制";
+  }
+  else if (!(scheduled_light_ == frame_.light))
+  {
+    reason_ = "光源";
+  }
+  else if (!(scheduled_key_ == key))
+  {
+    reason_ = scheduled_key_.model != key.model                     ? "模型"
+              : scheduled_key_.geometryVersion != key.geometryVersion ? "节点变换"
+              : scheduled_key_.transform != key.transform             ? "模型变换"
+                                                                      : "动画";
+  }
+  else
+  {
+    reuses_++;
+    return false;
+  }
+  stale_ = false;
+  scheduled_light_ = frame_.light;
+  scheduled_key_ = key;
+  renders_++;
+  return true;
+}
+
+Shader *ShadowMap::begin(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+{
+  glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+  float radius = std::max(glm::length(boundsMax - boundsMin) * 0.5f * 1.05f, 1e-3f);
+  const Light &light = frame_.light;
+  glm::vec3 direction = lightDirection(light);
+  glm::mat4 view;
+  glm::mat4 projection;
+  if (light.type == LightType::Directional)
+  {
+    // 正交投影恰好包住场景的包围球，相机旋转不影响覆盖范围
+    view = glm::lookAt(center - direction * (radius * 2.0f), center, upVector(direction));
+    projection = glm::ortho(-radius, radius, -radius, radius, radius * 0.5f, radius * 3.5f);
+  }
+  else
+  {
+    float distance = glm::length(center - light.position);
+    float nearPlane = std::max(distance - radius, distance * 0.01f + 1e-3f);
+    float farPlane = distance + radius;
+    view = glm::lookAt(light.position, light.target, upVector(direction));
+    projection = glm::perspective(glm::radians(light.spotOuterDeg * 2.0f), 1.0f, nearPlane, farPlane);
+  }
+  light_space_ = projection * view;
+
+  glGetIntegerv(GL_VIEWPORT, saved_viewport_);
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &saved_framebuffer_);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glViewport(0, 0, allocated_size_, allocated_size_);
+  glClear(GL_DEPTH_BUFFER_BIT);
+  // 斜率相关的深度偏移，减轻自阴影条纹
+  glEnable(GL_POLYGON_OFFSET_FILL);
+  glPolygonOffset(2.0f, 4.0f);
+
+  shader_->use();
+  shader_->setMat4("projection", projection);
+  shader_->setMat4("view", view);
+  return shader_.get();
+}
+
+void ShadowMap::end()
+{
+  glDisable(GL_POLYGON_OFFSET_FILL);
+  glBindFramebuffer(GL_FRAMEBUFFER, saved_framebuffer_);
+  glViewport(saved_viewport_[0], saved_viewport_[1], saved_viewport_[2], saved_viewport_[3]);
+  valid_ = true;
+}
+
+void ShadowMap::apply(Shader *shader, bool receive) const
+{
+  const Light &light = frame_.light;
+  glm::vec3 direction = lightDirection(light);
+  shader->setVec3("lightPos", light.position);
+  shader->setInt("lightType", static_cast<int>(light.type));
+  shader->setVec3("lightDirection", direction);
+  shader->setFloat("spotCosOuter", std::cos(glm::radians(light.spotOuterDeg)));
+  shader->setFloat("spotCosInner", std::cos(glm::radians(light.spotInnerDeg)));
+
+  bool shadows = receive && frame_.enabled && valid_;
+  shader->setBool("shadowsEnabled", shadows);
+  if (!shadows)
+    return;
+  shader->setMat4("lightSpace", light_space_);
+  shader->setFloat("shadowBias", frame_.bias);
+  shader->setInt("pcfRadius", frame_.pcfRadius);
+  shader->setInt("shadowMap", Mesh::kShadowMapUnit);
+  glActiveTexture(GL_TEXTURE0 + Mesh::kShadowMapUnit);
+  glBindTexture(GL_TEXTURE_2D, texture_);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void ShadowMap::render_panel()
+{
+  if (!ImGui::CollapsingHeader("阴影"))
+    return;
+
+  ImGui::Checkbox("阴影贴图", &enabled_);
+  const char *typeNames[] = {"方向光", "聚光灯"};
+  int type = static_cast<int>(light_.type) - 1;
+  if (ImGui::Combo("光源类型", &type, typeNames, IM_ARRAYSIZE(typeNames)))
+    light_.type = static_cast<LightType>(type + 1);
+  ImGui::DragFloat3("光源位置", &light_.position.x, 0.05f);
+  ImGui::DragFloat3("照射目标", &light_.target.x, 0.05f);
+  if (light_.type == LightType::Spot)
+  {
+    ImGui::SliderFloat("外锥半角", &light_.spotOuterDeg, 5.0f, 80.0f, "%.1f°");
+    ImGui::SliderFloat("内锥半角", &light_.spotInnerDeg, 1.0f, light_.spotOuterDeg, "%.1f°");
+    light_.spotInnerDeg = std::min(light_.spotInnerDeg, light_.spotOuterDeg);
+  }
+  const char *sizeNames[] = {"1024", "2048", "4096"};
+  const int sizes[] = {1024, 2048, 4096};
+  int sizeIndex = 1;
+  for (int i = 0; i < IM_ARRAYSIZE(sizes); i++)
+  {
+    if (sizes[i] == size_)
+      sizeIndex = i;
+  }
+  if (ImGui::Combo("贴图尺寸", &sizeIndex, sizeNames, IM_ARRAYSIZE(sizeNames)))
+    size_ = sizes[sizeIndex];
+  ImGui::SliderInt("PCF半径", &pcf_radius_, 0, 3);
+  ImGui::SliderFloat("深度偏移", &bias_, 0.0f, 0.01f, "%.4f");
+
+  // 最近一次重绘的GPU耗时（只在重绘的帧中出现）
+  double gpuMs = -1.0;
+  const auto &history = Profiler::get_instance().history();
+  for (auto frame = history.rbegin(); frame != history.rend() && gpuMs < 0.0; ++frame)
+  {
+    for (const Profiler::ScopeRecord &scope : frame->scopes)
+    {
+      if (std::strcmp(scope.name, "shadow_map") == 0 && scope.gpuMs >= 0.0)
+        gpuMs = scope.gpuMs;
+    }
+  }
+  ImGui::Text("重绘 %llu 次, 沿用缓存 %llu 帧", (unsigned long long)renders_, (unsigned long long)reuses_);
+  if (renders_ > 0)
+    ImGui::Text("上次重绘原因: %s", reason_);
+  if (gpuMs >= 0.0)
+    ImGui::Text("上次重绘GPU耗时 %.3f ms", gpuMs);
+  ImGui::TextDisabled("只在光源、模型、节点变换或动画姿态变化时重绘；播放动画时每帧重绘");
+}
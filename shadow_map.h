@@ -0,0 +1,117 @@
+#ifndef __SHADOW_MAP_H
+#define __SHADOW_MAP_H
+
+#include "shader.h"
+#include <cstdint>
+#include <memory>
+
+// 方向光/聚光灯的阴影贴图，片元着色器以 sampler2DShadow 做 PCF 采样。
+// 轨迹球只移动相机，阴影贴图的内容只取决于光源与场景（模型、整体变换、节点变换、动画姿态），
+// 因此在帧之间缓存：只有这些状态变化时才重绘，其余帧只绑定已有的深度纹理
+class ShadowMap
+{
+public:
+  // 数值与 fragment.glsl 的 lightType 一致；0 为未设置时的点光源（不投射阴影）
+  enum class LightType
+  {
+    Directional = 1,
+    Spot = 2,
+  };
+
+  struct Light
+  {
+    LightType type = LightType::Directional;
+    glm::vec3 position = glm::vec3(1.2f, 1.0f, 2.0f); // 方向光只用于确定方向
+    glm::vec3 target = glm::vec3(0.0f);
+    float spotOuterDeg = 35.0f; // 聚光灯外锥半角
+    float spotInnerDeg = 28.0f; // 聚光灯内锥半角（之间平滑衰减）
+
+    bool operator==(const Light &other) const
+    {
+      return type == other.type && position == other.position && target == other.target &&
+             spotOuterDeg == other.spotOuterDeg && spotInnerDeg == other.spotInnerDeg;
+    }
+  };
+
+  // 除光源外决定阴影贴图内容的场景状态
+  struct SceneKey
+  {
+    const void *model = nullptr;
+    uint64_t geometryVersion = 0;
+    glm::mat4 transform = glm::mat4(1.0f);
+    int animationClip = -1;
+    float animationTime = 0.0f;
+    uint32_t crowd = 1;
+
+    bool operator==(const SceneKey &other) const
+    {
+      return model == other.model && geometryVersion == other.geometryVersion && transform == other.transform &&
+             animationClip == other.animationClip && animationTime == other.animationTime && crowd == other.crowd;
+    }
+  };
+
+private:
+  std::unique_ptr<Shader> shader_;
+  GLuint fbo_ = 0;
+  GLuint texture_ = 0;
+  int size_ = 2048;
+  int allocated_size_ = 0;
+
+  bool enabled_ = true;
+  Light light_;
+  float bias_ = 0.0015f; // 比较深度的常量偏移（按光线掠射角放大）
+  int pcf_radius_ = 1;   // PCF 采样 (2r+1)^2 次，每次为硬件的2x2比较滤波
+
+  // 本帧使用的设置：渲染线程模式下提交阶段不持有场景锁，面板可能同时修改上面的设置，
+  // 因此在场景锁内由 latch 复制一份，判断重绘、绘制与设置 uniform 都只读这份
+  struct Settings
+  {
+    bool enabled = true;
+    Light light;
+    float bias = 0.0015f;
+    int pcfRadius = 1;
+  };
+  Settings frame_;
+
+  // 缓存状态。needsUpdate 登记重绘时就记下光源与场景状态，绘制在之后的提交阶段完成
+  bool valid_ = false; // 贴图中已有绘制结果
+  bool stale_ = true;  // 需要重新登记重绘（首次、尺寸变化或 invalidate）
+  Light scheduled_light_;
+  SceneKey scheduled_key_;
+  glm::mat4 light_space_ = glm::mat4(1.0f);
+  const char *reason_ = "";  // 最近一次重绘的原因
+  uint64_t renders_ = 0;     // 重绘次数
+  uint64_t reuses_ = 0;      // 沿用缓存的帧数
+  GLint saved_viewport_[4] = {};
+  GLint saved_framebuffer_ = 0;
+
+  void allocate();
+
+public:
+  ShadowMap() = default;
+  ~ShadowMap() = default;
+  ShadowMap(const ShadowMap &) = delete;
+  ShadowMap &operator=(const ShadowMap &) = delete;
+
+  void init(const char *vertexPath, const char *fragmentPath);
+  void release();
+
+  const Light &light() const { return light_; }
+  bool enabled() const { return enabled_; }
+  void invalidate(const char *reason); // 加载模型等无法由 SceneKey 区分的变化
+
+  // 每帧在场景锁内调用一次，复制面板可修改的设置供本帧使用
+  void latch();
+  // 本帧是否需要重绘（光源、场景状态或贴图尺寸变化）；需要时登记该状态，不需要时计入沿用次数
+  bool needsUpdate(const SceneKey &key);
+  // 按场景包围盒设置光源矩阵并绑定阴影帧缓冲，返回深度程序供绘制；end 恢复帧缓冲与视口
+  Shader *begin(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax);
+  void end();
+
+  // 设置光源与阴影 uniform 并绑定深度纹理；receive 为 false 时只设置光照（不采样阴影）
+  void apply(Shader *shader, bool receive) const;
+
+  void render_panel();
+};
+
+#endif
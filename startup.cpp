@@ -0,0 +1,103 @@
+#include "startup.h"
+#include "asset_archive.h"
+#include "point_cloud.h"
+#include "stress_scene.h"
+#include "imgui.h"
+#include <fstream>
+#include <iostream>
+
+double Startup::elapsedMs() const
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+}
+
+void Startup::mark(const std::string &name)
+{
+  double ms = elapsedMs();
+  std::lock_guard<std::mutex> lock(mutex_);
+  phases_.push_back(Phase{name, ms});
+}
+
+void Startup::firstFrame()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first_frame_ms_ > 0.0)
+      return;
+    first_frame_ms_ = elapsedMs();
+    phases_.push_back(Phase{"first_frame", first_frame_ms_});
+  }
+
+  std::cout << "首帧耗时 " << first_frame_ms_ << " ms（";
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < phases_.size(); i++)
+    std::cout << (i ? ", " : "") << phases_[i].name << " " << phases_[i].ms;
+  std::cout << "）" << std::endl;
+}
+
+double Startup::firstFrameMs() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return first_frame_ms_;
+}
+
+std::string Startup::lastModel()
+{
+  std::ifstream file(kLastModelFile);
+  std::string path;
+  std::getline(file, path);
+  return path;
+}
+
+void Startup::rememberModel(const std::string &path)
+{
+  std::ofstream file(kLastModelFile, std::ios::out | std::ios::trunc);
+  file << path << "\n";
+}
+
+void Startup::prefetchModel(const std::string &path)
+{
+  // 只预取经过Assimp的模型文件；点云、分块模型与压力场景各有自己的加载路径
+  bool chunked = path.size() > 7 && path.compare(path.size() - 7, 7, ".chunks") == 0;
+  if (path.empty() || chunked || StressSceneParams::isStressPath(path))
+    return;
+  std::string file = AssetArchive::get_instance().resolve(path);
+  if (PointCloud::isPointCloudFile(file))
+    return;
+  if (!AssetArchive::get_instance().find(path) && !std::ifstream(file).good())
+    return;
+  prefetch_path_ = path;
+  prefetch_ = std::async(std::launch::async, [this, path]()
+                         {
+                           std::unique_ptr<ImportedScene> imported = Model::importFile(path);
+                           mark("model_prefetched");
+                           return imported; });
+}
+
+bool Startup::prefetching(const std::string &path) const
+{
+  return prefetch_.valid() && path == prefetch_path_ &&
+         prefetch_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+std::unique_ptr<ImportedScene> Startup::takePrefetched(const std::string &path)
+{
+  if (!prefetch_.valid() || path != prefetch_path_)
+    return nullptr;
+  prefetch_path_.clear();
+  return prefetch_.get();
+}
+
+void Startup::render_panel()
+{
+  if (!ImGui::CollapsingHeader("启动"))
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (first_frame_ms_ > 0.0)
+    ImGui::Text("首帧 %.1f ms", first_frame_ms_);
+  for (const Phase &phase : phases_)
+    ImGui::BulletText("%s: %.1f ms", phase.name.c_str(), phase.ms);
+  if (!prefetch_path_.empty())
+    ImGui::TextDisabled("正在预取 %s", prefetch_path_.c_str());
+}
@@ -0,0 +1,65 @@
+#ifndef __STARTUP_H
+#define __STARTUP_H
+
+#include "model.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 启动关键路径：记录从进程启动到各阶段与首帧（交换缓冲返回）的耗时，并在创建窗口之前
+// 在工作线程上预取模型（Assimp导入与后处理），与窗口创建、GL加载、着色器编译重叠。
+// 最近一次打开的模型路径保存在工作目录下的 kLastModelFile 中，下次启动时自动预取并打开
+class Startup
+{
+public:
+  struct Phase
+  {
+    std::string name;
+    double ms; // 自进程启动
+  };
+
+private:
+  static constexpr const char *kLastModelFile = "gl_trackball_last_model.txt";
+
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+  mutable std::mutex mutex_;
+  std::vector<Phase> phases_;
+  double first_frame_ms_ = 0.0; // 0 表示首帧尚未完成
+
+  // 模型预取（只在主线程/GL线程上访问）
+  std::string prefetch_path_;
+  std::future<std::unique_ptr<ImportedScene>> prefetch_;
+
+  Startup() = default;
+  Startup(const Startup &) = delete;
+  Startup &operator=(const Startup &) = delete;
+
+public:
+  static Startup &get_instance()
+  {
+    static Startup instance;
+    return instance;
+  }
+
+  // 在 main 的第一行调用，作为计时起点
+  void begin() { start_ = std::chrono::steady_clock::now(); }
+  double elapsedMs() const;
+  void mark(const std::string &name); // 记录一个阶段完成（任意线程）
+  void firstFrame();                  // 每次交换缓冲后调用，只有第一次记录
+  double firstFrameMs() const;
+
+  static std::string lastModel();                     // 上次打开的模型文件（没有时为空）
+  static void rememberModel(const std::string &path); // 记录本次打开的模型文件
+
+  void prefetchModel(const std::string &path);
+  bool prefetching(const std::string &path) const; // 正在预取该路径且尚未完成
+  // 取走该路径的预取结果（未预取时返回空；尚未完成时等待）
+  std::unique_ptr<ImportedScene> takePrefetched(const std::string &path);
+
+  void render_panel();
+};
+
+#endif
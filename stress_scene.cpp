@@ -0,0 +1,181 @@
+#include "stress_scene.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static const char *kStressPrefix = "stress:";
+
+std::string StressSceneParams::toString() const
+{
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer), "%s%u,%u,%u,%u,%u", kStressPrefix, meshCount, trianglesPerMesh, materialCount,
+           textureSize, seed);
+  return buffer;
+}
+
+bool StressSceneParams::isStressPath(const std::string &path)
+{
+  return path.compare(0, std::strlen(kStressPrefix), kStressPrefix) == 0;
+}
+
+bool StressSceneParams::parse(const std::string &text, StressSceneParams &params)
+{
+  std::string body = isStressPath(text) ? text.substr(std::strlen(kStressPrefix)) : text;
+  StressSceneParams parsed;
+  int fields = sscanf(body.c_str(), "%u,%u,%u,%u,%u", &parsed.meshCount, &parsed.trianglesPerMesh,
+                      &parsed.materialCount, &parsed.textureSize, &parsed.seed);
+  if (fields < 2 || parsed.meshCount == 0 || parsed.trianglesPerMesh == 0)
+    return false;
+  parsed.materialCount = std::max(1u, parsed.materialCount);
+  params = parsed;
+  return true;
+}
+
+// 网格为 n x n 个顶点的经纬网格，三角形数为 2(n-1)^2
+static unsigned int gridResolution(unsigned int triangles)
+{
+  return std::max(2u, static_cast<unsigned int>(std::ceil(std::sqrt(triangles / 2.0))) + 1);
+}
+
+uint64_t StressSceneParams::actualTrianglesPerMesh() const
+{
+  uint64_t n = gridResolution(trianglesPerMesh);
+  return 2 * (n - 1) * (n - 1);
+}
+
+static aiMesh *createSphereMesh(unsigned int index, unsigned int resolution, const glm::vec3 &center, float radius,
+                                unsigned int materialIndex)
+{
+  const unsigned int n = resolution;
+  aiMesh *mesh = new aiMesh();
+  mesh->mName = aiString("stress_" + std::to_string(index));
+  mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+  mesh->mMaterialIndex = materialIndex;
+  mesh->mNumVertices = n * n;
+  mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+  mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+  mesh->mTangents = new aiVector3D[mesh->mNumVertices];
+  mesh->mBitangents = new aiVector3D[mesh->mNumVertices];
+  mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+  mesh->mNumUVComponents[0] = 2;
+
+  const float pi = 3.14159265358979f;
+  for (unsigned int y = 0; y < n; y++)
+  {
+    float v = y / float(n - 1);
+    float theta = v * pi; // 极角
+    for (unsigned int x = 0; x < n; x++)
+    {
+      float u = x / float(n - 1);
+      float phi = u * 2.0f * pi; // 方位角
+      glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+      glm::vec3 tangent(-std::sin(phi), 0.0f, std::cos(phi));
+      glm::vec3 bitangent = glm::cross(tangent, normal);
+      glm::vec3 position = center + normal * radius;
+
+      unsigned int i = y * n + x;
+      mesh->mVertices[i] = aiVector3D(position.x, position.y, position.z);
+      mesh->mNormals[i] = aiVector3D(normal.x, normal.y, normal.z);
+      mesh->mTangents[i] = aiVector3D(tangent.x, tangent.y, tangent.z);
+      mesh->mBitangents[i] = aiVector3D(bitangent.x, bitangent.y, bitangent.z);
+      mesh->mTextureCoords[0][i] = aiVector3D(u, 1.0f - v, 0.0f);
+    }
+  }
+
+  // 逆时针为正面（从球外观察）
+  mesh->mNumFaces = 2 * (n - 1) * (n - 1);
+  mesh->mFaces = new aiFace[mesh->mNumFaces];
+  unsigned int f = 0;
+  for (unsigned int y = 0; y + 1 < n; y++)
+  {
+    for (unsigned int x = 0; x + 1 < n; x++)
+    {
+      unsigned int i0 = y * n + x;
+      unsigned int i1 = i0 + 1;
+      unsigned int i2 = i0 + n;
+      unsigned int i3 = i2 + 1;
+      aiFace &a = mesh->mFaces[f++];
+      a.mNumIndices = 3;
+      a.mIndices = new unsigned int[3]{i0, i1, i2};
+      aiFace &b = mesh->mFaces[f++];
+      b.mNumIndices = 3;
+      b.mIndices = new unsigned int[3]{i1, i3, i2};
+    }
+  }
+  return mesh;
+}
+
+// 棋盘格纹理，颜色由种子决定
+static aiTexture *createCheckerTexture(unsigned int size, std::mt19937 &rng)
+{
+  std::uniform_int_distribution<int> channel(64, 255);
+  aiTexel colorA{static_cast<unsigned char>(channel(rng)), static_cast<unsigned char>(channel(rng)),
+                 static_cast<unsigned char>(channel(rng)), 255};
+  aiTexel colorB{static_cast<unsigned char>(colorA.b / 3), static_cast<unsigned char>(colorA.g / 3),
+                 static_cast<unsigned char>(colorA.r / 3), 255};
+
+  aiTexture *texture = new aiTexture();
+  texture->mWidth = size;
+  texture->mHeight = size;
+  texture->pcData = new aiTexel[size * size];
+  const unsigned int cell = std::max(1u, size / 8);
+  for (unsigned int y = 0; y < size; y++)
+  {
+    for (unsigned int x = 0; x < size; x++)
+    {
+      bool odd = ((x / cell) + (y / cell)) & 1;
+      texture->pcData[y * size + x] = odd ? colorA : colorB;
+    }
+  }
+  return texture;
+}
+
+std::unique_ptr<aiScene> createStressScene(const StressSceneParams &params)
+{
+  std::mt19937 rng(params.seed);
+  std::unique_ptr<aiScene> scene(new aiScene());
+
+  // 材质与内嵌纹理
+  const bool textured = params.textureSize > 0;
+  scene->mNumMaterials = params.materialCount;
+  scene->mMaterials = new aiMaterial *[params.materialCount];
+  if (textured)
+  {
+    scene->mNumTextures = params.materialCount;
+    scene->mTextures = new aiTexture *[params.materialCount];
+  }
+  for (unsigned int m = 0; m < params.materialCount; m++)
+  {
+    aiMaterial *material = new aiMaterial();
+    aiString name("stress_material_" + std::to_string(m));
+    material->AddProperty(&name, AI_MATKEY_NAME);
+    if (textured)
+    {
+      scene->mTextures[m] = createCheckerTexture(params.textureSize, rng);
+      aiString path("*" + std::to_string(m));
+      material->AddProperty(&path, AI_MATKEY_TEXTURE_DIFFUSE(0));
+    }
+    scene->mMaterials[m] = material;
+  }
+
+  // 网格排布成 k x k x k 的立方阵列
+  const unsigned int resolution = gridResolution(params.trianglesPerMesh);
+  const unsigned int k = std::max(1u, static_cast<unsigned int>(std::ceil(std::cbrt(double(params.meshCount)))));
+  std::uniform_real_distribution<float> radius(0.3f, 0.45f);
+  scene->mNumMeshes = params.meshCount;
+  scene->mMeshes = new aiMesh *[params.meshCount];
+  scene->mRootNode = new aiNode("stress_root");
+  scene->mRootNode->mNumMeshes = params.meshCount;
+  scene->mRootNode->mMeshes = new unsigned int[params.meshCount];
+  for (unsigned int i = 0; i < params.meshCount; i++)
+  {
+    glm::vec3 center(float(i % k), float((i / k) % k), float(i / (k * k)));
+    center -= glm::vec3((k - 1) * 0.5f);
+    scene->mMeshes[i] = createSphereMesh(i, resolution, center, radius(rng), i % params.materialCount);
+    scene->mRootNode->mMeshes[i] = i;
+  }
+  return scene;
+}
@@ -0,0 +1,31 @@
+#ifndef __STRESS_SCENE_H
+#define __STRESS_SCENE_H
+
+#include <assimp/scene.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 程序生成的压力测试场景参数
+// 文本形式为 "stress:网格数,每网格三角形数,材质数,纹理边长,种子"，可作为模型路径使用
+struct StressSceneParams
+{
+  unsigned int meshCount = 64;
+  unsigned int trianglesPerMesh = 10000;
+  unsigned int materialCount = 4;
+  unsigned int textureSize = 256; // 每个材质一张漫反射纹理，0表示不生成纹理
+  uint32_t seed = 1;
+
+  std::string toString() const;
+  static bool parse(const std::string &text, StressSceneParams &params);
+  static bool isStressPath(const std::string &path);
+
+  // 每个网格实际生成的三角形数（按网格分辨率取整）
+  uint64_t actualTrianglesPerMesh() const;
+};
+
+// 在内存中生成场景：网格为排布成立方阵列的UV球，已三角化并带法线/切线/UV，
+// 纹理以未压缩的内嵌纹理（"*N"）提供，不访问磁盘
+std::unique_ptr<aiScene> createStressScene(const StressSceneParams &params);
+
+#endif
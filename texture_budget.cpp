@@ -0,0 +1,289 @@
+#include "texture_budget.h"
+#include "texture_streamer.h"
+#include "gl_task_queue.h"
+#include "imgui.h"
+#include <algorithm>
+
+TextureBudget::~TextureBudget()
+{
+  if (worker_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+}
+
+uint64_t TextureBudget::levelBytes(const TextureInfo &info, int level)
+{
+  uint64_t width = std::max(1u, info.width >> level);
+  uint64_t height = std::max(1u, info.height >> level);
+  if (info.compressed)
+    return (width + 3) / 4 * ((height + 3) / 4) * info.texelBytes;
+  // 驱动通常将RGB按RGBA存储
+  return width * height * (info.texelBytes == 3 ? 4 : info.texelBytes);
+}
+
+uint64_t TextureBudget::bytesFrom(const TextureInfo &info, int level)
+{
+  uint64_t bytes = 0;
+  for (int i = std::max(0, level); i < info.levelCount; i++)
+    bytes += levelBytes(info, i);
+  return bytes;
+}
+
+int TextureBudget::targetLevel(const Entry &entry) const
+{
+  return std::min(entry.floorLevel, std::max(0, mipBias_));
+}
+
+void TextureBudget::add(const TextureInfo &info, Reloader reloader)
+{
+  Entry entry;
+  entry.info = info;
+  entry.reloader = std::move(reloader);
+  entry.allocatedLevel = 0;
+  entry.lastDrawn = frame_; // 刚加载的纹理视为本帧使用过，避免立即被降级
+  while (entry.floorLevel + 1 < info.levelCount &&
+         std::max(info.width >> entry.floorLevel, info.height >> entry.floorLevel) > uint32_t(kMinResidentSize))
+    entry.floorLevel++;
+  allocatedBytes_ += bytesFrom(info, entry.allocatedLevel);
+  entries_[info.texture] = std::move(entry);
+}
+
+void TextureBudget::remove(GLuint texture)
+{
+  auto it = entries_.find(texture);
+  if (it == entries_.end())
+    return;
+  allocatedBytes_ -= bytesFrom(it->second.info, it->second.allocatedLevel);
+  entries_.erase(it);
+}
+
+uint64_t TextureBudget::allocatedBytes(GLuint texture) const
+{
+  auto it = entries_.find(texture);
+  return it == entries_.end() ? 0 : bytesFrom(it->second.info, it->second.allocatedLevel);
+}
+
+void TextureBudget::onLevelResident(GLuint texture, int level)
+{
+  auto it = entries_.find(texture);
+  if (it == entries_.end())
+    return;
+  Entry &entry = it->second;
+  entry.info.baseLevel = level;
+  if (level <= entry.allocatedLevel && entry.restoreTicket == 0)
+    entry.restoring = false;
+}
+
+// 降级到 level：未完成的流式上传一并取消，level 之前已分配的层重定义为0x0以释放显存
+// （纹理为可变存储，基础层以上的层不参与完整性判断）
+void TextureBudget::reduce(Entry &entry, int level)
+{
+  TextureInfo &info = entry.info;
+  TextureStreamer::get_instance().cancel(info.texture);
+  entry.restoring = false;
+  entry.restoreTicket = 0;
+  level = std::max(level, info.baseLevel);
+
+  glBindTexture(GL_TEXTURE_2D, info.texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+  for (int i = entry.allocatedLevel; i < level; i++)
+  {
+    if (info.compressed)
+      glCompressedTexImage2D(GL_TEXTURE_2D, i, info.internalFormat, 0, 0, 0, 0, nullptr);
+    else
+      glTexImage2D(GL_TEXTURE_2D, i, info.internalFormat, 0, 0, 0, info.format, info.type, nullptr);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  allocatedBytes_ -= bytesFrom(info, entry.allocatedLevel) - bytesFrom(info, level);
+  reductions_ += level - info.baseLevel;
+  info.baseLevel = level;
+  entry.allocatedLevel = level;
+}
+
+// 只登记在途的重新加载，解码与转码在工作线程上进行，不阻塞当前帧
+void TextureBudget::restore(Entry &entry)
+{
+  entry.restoring = true;
+  entry.restoreTicket = ++next_ticket_;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reloads_.push_back({entry.info.texture, entry.restoreTicket, entry.reloader});
+  }
+  if (!worker_.joinable())
+    worker_ = std::thread(&TextureBudget::reload_loop, this);
+  cv_.notify_one();
+}
+
+void TextureBudget::reload_loop()
+{
+  while (true)
+  {
+    ReloadJob job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]
+               { return stop_ || !reloads_.empty(); });
+      if (stop_)
+        return;
+      job = std::move(reloads_.front());
+      reloads_.pop_front();
+    }
+
+    std::vector<TextureLevel> levels = job.reloader();
+    GlTaskQueue::get_instance().post([this, texture = job.texture, ticket = job.ticket, levels = std::move(levels)]() mutable
+                                     { finish_restore(texture, ticket, std::move(levels)); });
+  }
+}
+
+void TextureBudget::finish_restore(GLuint texture, uint64_t ticket, std::vector<TextureLevel> levels)
+{
+  auto it = entries_.find(texture);
+  if (it == entries_.end() || it->second.restoreTicket != ticket)
+    return; // 纹理已删除，或等待期间被降级
+  Entry &entry = it->second;
+  TextureInfo &info = entry.info;
+  entry.restoreTicket = 0;
+  entry.restoring = false;
+  if (static_cast<int>(levels.size()) != info.levelCount || levels[0].width != info.width ||
+      levels[0].height != info.height)
+  {
+    // 源数据已变化或不可用，此后不再尝试恢复
+    entry.reloader = Reloader();
+    return;
+  }
+
+  // 加载期间mip偏置或预算可能已变化，按当前状态重新确认
+  int target = targetLevel(entry);
+  if (entry.allocatedLevel <= target)
+    return;
+  uint64_t needed = bytesFrom(info, target) - bytesFrom(info, entry.allocatedLevel);
+  if (allocatedBytes_ + needed > static_cast<uint64_t>(budgetBytes_ * kRestoreHeadroom))
+    return;
+
+  allocatedBytes_ += needed;
+  entry.allocatedLevel = target;
+  entry.restoring = true;
+  restores_++;
+  TextureStreamer::get_instance().restore(info.texture, info.compressed, info.internalFormat, info.format, info.type,
+                                          info.texelBytes, std::move(levels), info.baseLevel, target);
+}
+
+void TextureBudget::update()
+{
+  for (GLuint texture : touched_)
+  {
+    auto it = entries_.find(texture);
+    if (it != entries_.end())
+      it->second.lastDrawn = frame_;
+  }
+  touched_.clear();
+  frame_++;
+
+  // mip偏置：基础层高于目标层的纹理直接降到目标层
+  for (auto &item : entries_)
+  {
+    Entry &entry = item.second;
+    int target = targetLevel(entry);
+    if (entry.allocatedLevel < target)
+      reduce(entry, target);
+  }
+
+  // 超出预算：每次选最久未绘制的纹理（同一帧绘制的选当前最大层最大的）降一层
+  while (allocatedBytes_ > budgetBytes_)
+  {
+    Entry *victim = nullptr;
+    for (auto &item : entries_)
+    {
+      Entry &entry = item.second;
+      if (entry.allocatedLevel >= entry.floorLevel)
+        continue;
+      if (!victim || entry.lastDrawn < victim->lastDrawn ||
+          (entry.lastDrawn == victim->lastDrawn &&
+           levelBytes(entry.info, entry.allocatedLevel) > levelBytes(victim->info, victim->allocatedLevel)))
+        victim = &entry;
+    }
+    if (!victim)
+      break;
+    reduce(*victim, std::min(victim->floorLevel, victim->info.baseLevel + 1));
+  }
+
+  // 预算有余量：每帧最多恢复一张最近绘制过、被降级的纹理（优先最近绘制、缺失字节最少的）
+  uint64_t limit = static_cast<uint64_t>(budgetBytes_ * kRestoreHeadroom);
+  Entry *candidate = nullptr;
+  uint64_t candidateBytes = 0;
+  for (auto &item : entries_)
+  {
+    Entry &entry = item.second;
+    int target = targetLevel(entry);
+    if (!entry.reloader || entry.restoring || entry.allocatedLevel <= target || entry.lastDrawn + kRecentFrames < frame_)
+      continue;
+    uint64_t needed = bytesFrom(entry.info, target) - bytesFrom(entry.info, entry.allocatedLevel);
+    if (allocatedBytes_ + needed > limit)
+      continue;
+    if (!candidate || entry.lastDrawn > candidate->lastDrawn ||
+        (entry.lastDrawn == candidate->lastDrawn && needed < candidateBytes))
+    {
+      candidate = &entry;
+      candidateBytes = needed;
+    }
+  }
+  if (candidate)
+    restore(*candidate);
+}
+
+void TextureBudget::render_panel()
+{
+  if (!ImGui::CollapsingHeader("纹理显存预算"))
+    return;
+
+  const double MB = 1024.0 * 1024.0;
+  int budgetMB = static_cast<int>(budgetBytes_ >> 20);
+  if (ImGui::SliderInt("显存预算 (MB)", &budgetMB, 16, 8192))
+    budgetBytes_ = uint64_t(budgetMB) << 20;
+  ImGui::SliderInt("Mip偏置", &mipBias_, 0, 6);
+  ImGui::Text("已分配: %.1f / %.1f MB, 纹理 %zu, 累计降级 %llu 层, 恢复 %llu 次", allocatedBytes_ / MB,
+              budgetBytes_ / MB, entries_.size(), (unsigned long long)reductions_, (unsigned long long)restores_);
+
+  // 驻留情况：按占用从大到小
+  std::vector<const Entry *> sorted;
+  sorted.reserve(entries_.size());
+  for (const auto &item : entries_)
+    sorted.push_back(&item.second);
+  std::sort(sorted.begin(), sorted.end(), [](const Entry *a, const Entry *b)
+            { return bytesFrom(a->info, a->allocatedLevel) > bytesFrom(b->info, b->allocatedLevel); });
+
+  ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+  if (!sorted.empty() && ImGui::BeginTable("texture_residency", 5, flags, ImVec2(0, 160)))
+  {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("纹理");
+    ImGui::TableSetupColumn("驻留尺寸");
+    ImGui::TableSetupColumn("基础层");
+    ImGui::TableSetupColumn("MB");
+    ImGui::TableSetupColumn("未绘制帧数");
+    ImGui::TableHeadersRow();
+    for (const Entry *entry : sorted)
+    {
+      const TextureInfo &info = entry->info;
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(info.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%ux%u", std::max(1u, info.width >> info.baseLevel), std::max(1u, info.height >> info.baseLevel));
+      ImGui::TableNextColumn();
+      ImGui::Text("%d/%d%s", info.baseLevel, info.levelCount - 1, entry->restoring ? " (恢复中)" : "");
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", bytesFrom(info, entry->allocatedLevel) / MB);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)(frame_ - entry->lastDrawn));
+    }
+    ImGui::EndTable();
+  }
+}
@@ -0,0 +1,122 @@
+#ifndef __TEXTURE_BUDGET_H
+#define __TEXTURE_BUDGET_H
+
+#include <glad/glad.h>
+#include "texture_codec.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 纹理显存预算：记录每张纹理已分配的mip层与当前基础层。
+// 超出预算时按最近绘制时间（LRU）从最久未绘制的纹理开始逐层降级：上调 GL_TEXTURE_BASE_LEVEL
+// 并把被跳过的高分辨率层重定义为0x0以释放显存。全局mip偏置把所有纹理额外降低若干层。
+// 预算有余量时，最近绘制过且被降级的纹理在工作线程上执行重新加载回调（解码/转码），
+// 结果经 GlTaskQueue 交回GL线程，再由 TextureStreamer 分帧上传
+class TextureBudget
+{
+public:
+  // 重新加载完整mip链（已按分辨率上限裁剪，与注册时的层结构一致），失败时返回空
+  using Reloader = std::function<std::vector<TextureLevel>()>;
+
+  struct TextureInfo
+  {
+    GLuint texture = 0;
+    std::string name;
+    uint32_t width = 0; // level 0 尺寸
+    uint32_t height = 0;
+    int levelCount = 1;
+    bool compressed = false;
+    GLenum internalFormat = 0;
+    GLenum format = 0; // 未压缩格式的像素格式与类型
+    GLenum type = 0;
+    uint32_t texelBytes = 0; // 未压缩：每像素字节数；压缩：每4x4块字节数
+    int baseLevel = 0;       // 注册时已驻留的最大层（流式上传中的纹理为尾部层）
+  };
+
+private:
+  static constexpr int kMinResidentSize = 64;    // 降级不会低于边长不超过该值的层
+  static constexpr uint64_t kRecentFrames = 2;   // 这么多帧内绘制过的纹理才会被恢复
+  static constexpr double kRestoreHeadroom = 0.9; // 恢复后占用不超过预算的比例（避免反复降级/恢复）
+
+  struct Entry
+  {
+    TextureInfo info;
+    Reloader reloader;
+    int allocatedLevel = 0; // 已分配存储的最大层（流式上传中可能小于基础层）
+    int floorLevel = 0;     // 降级的下限
+    uint64_t lastDrawn = 0; // 最近绘制的帧号
+    bool restoring = false; // 已提交恢复，等待重新加载与流式上传完成
+    uint64_t restoreTicket = 0; // 在途的重新加载；降级或重新提交后旧结果作废
+  };
+
+  struct ReloadJob
+  {
+    GLuint texture = 0;
+    uint64_t ticket = 0;
+    Reloader reloader;
+  };
+
+  std::unordered_map<GLuint, Entry> entries_;
+  std::vector<GLuint> touched_; // 上一帧绘制过的纹理，update 时写入 lastDrawn
+  uint64_t frame_ = 0;
+  uint64_t budgetBytes_ = 1024ull << 20;
+  int mipBias_ = 0;
+
+  uint64_t allocatedBytes_ = 0;
+  uint64_t reductions_ = 0; // 累计降级的层数
+  uint64_t restores_ = 0;
+  uint64_t next_ticket_ = 0;
+
+  // 重新加载线程：只执行回调，不访问 entries_
+  std::thread worker_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<ReloadJob> reloads_;
+  bool stop_ = false;
+
+  TextureBudget() = default;
+  ~TextureBudget();
+  static uint64_t levelBytes(const TextureInfo &info, int level);
+  static uint64_t bytesFrom(const TextureInfo &info, int level); // level 及更小各层的总字节数
+  int targetLevel(const Entry &entry) const;                     // mip偏置与下限决定的期望基础层
+  void reduce(Entry &entry, int level);
+  void restore(Entry &entry);
+  void reload_loop();
+  void finish_restore(GLuint texture, uint64_t ticket, std::vector<TextureLevel> levels); // GL线程
+
+public:
+  TextureBudget(const TextureBudget &) = delete;
+  TextureBudget &operator=(const TextureBudget &) = delete;
+  static TextureBudget &get_instance()
+  {
+    static TextureBudget instance;
+    return instance;
+  }
+
+  void add(const TextureInfo &info, Reloader reloader = Reloader());
+  void remove(GLuint texture);
+  // 绘制时调用，记录最近使用的帧。渲染线程模式下提交阶段不持有场景锁而面板会读取 lastDrawn，
+  // 因此只记下纹理，由下一次 update（场景锁内）写入
+  void touch(GLuint texture) { touched_.push_back(texture); }
+  // 流式上传完成一层时由 TextureStreamer 调用
+  void onLevelResident(GLuint texture, int level);
+
+  void update(); // 每帧调用一次：应用mip偏置、超预算时降级、有余量时恢复
+
+  void setBudget(uint64_t bytes) { budgetBytes_ = bytes; }
+  uint64_t budget() const { return budgetBytes_; }
+  void setMipBias(int bias) { mipBias_ = bias; }
+  int mipBias() const { return mipBias_; }
+  uint64_t allocatedBytes() const { return allocatedBytes_; }
+  uint64_t allocatedBytes(GLuint texture) const;
+
+  void render_panel();
+};
+
+#endif
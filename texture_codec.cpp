@@ -0,0 +1,715 @@
+#include "texture_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+  constexpr uint32_t kCacheVersion = 2;  // 编码器或文件布局变化时递增，使旧缓存失效
+  constexpr size_t kParallelMinRows = 16; // 少于该块行数时单线程编码
+
+  // KTX2 文件标识与 Vulkan 格式编号
+  const uint8_t kKtx2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+  constexpr uint32_t kVkFormatBC1RgbUnorm = 131;
+  constexpr uint32_t kVkFormatBC3Unorm = 137;
+  constexpr uint32_t kVkFormatBC5Unorm = 141;
+  const char kCacheKeyName[] = "gltrackball.cacheKey";
+
+  // KTX2 头部各字段在文件中的偏移（规范第3节）。按字节逐个读写，不依赖结构体布局与主机字节序
+  enum Ktx2Offset : size_t
+  {
+    kVkFormat = 12,
+    kTypeSize = 16,
+    kPixelWidth = 20,
+    kPixelHeight = 24,
+    kPixelDepth = 28,
+    kLayerCount = 32,
+    kFaceCount = 36,
+    kLevelCount = 40,
+    kSupercompressionScheme = 44,
+    kDfdByteOffset = 48,
+    kDfdByteLength = 52,
+    kKvdByteOffset = 56,
+    kKvdByteLength = 60,
+    kSgdByteOffset = 64, // uint64
+    kSgdByteLength = 72, // uint64
+    kHeaderBytes = 80,   // 层级索引从这里开始
+  };
+  constexpr size_t kLevelIndexBytes = 24; // byteOffset、byteLength、uncompressedByteLength 各8字节
+
+  // 数据格式描述（Khronos Data Format 1.3）中用到的常量
+  constexpr uint32_t kDfModelBC1A = 128;
+  constexpr uint32_t kDfModelBC3 = 130;
+  constexpr uint32_t kDfModelBC5 = 132;
+  constexpr uint32_t kDfPrimariesBT709 = 1;
+  constexpr uint32_t kDfTransferLinear = 1;
+  constexpr uint32_t kDfVersion = 2;
+
+  void put32(std::vector<uint8_t> &out, size_t offset, uint32_t value)
+  {
+    for (int i = 0; i < 4; i++)
+      out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+
+  void put64(std::vector<uint8_t> &out, size_t offset, uint64_t value)
+  {
+    put32(out, offset, static_cast<uint32_t>(value));
+    put32(out, offset + 4, static_cast<uint32_t>(value >> 32));
+  }
+
+  uint32_t get32(const uint8_t *in)
+  {
+    return uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24;
+  }
+
+  uint64_t get64(const uint8_t *in) { return uint64_t(get32(in)) | uint64_t(get32(in + 4)) << 32; }
+
+  // 块压缩格式的基本数据格式描述块：4x4纹素块，BC1一个颜色样本，BC3为Alpha+颜色，BC5为R+G两个样本
+  std::vector<uint8_t> buildDfd(BlockFormat format, uint32_t blockBytes)
+  {
+    struct Sample
+    {
+      uint32_t bitOffset;
+      uint32_t channel;
+    };
+    std::vector<Sample> samples;
+    uint32_t model = kDfModelBC1A;
+    if (format == BlockFormat::BC3)
+    {
+      model = kDfModelBC3;
+      samples = {{0, 15}, {64, 0}}; // Alpha 在前64位，颜色在后64位
+    }
+    else if (format == BlockFormat::BC5)
+    {
+      model = kDfModelBC5;
+      samples = {{0, 0}, {64, 1}};
+    }
+    else
+    {
+      samples = {{0, 0}};
+    }
+
+    uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+    std::vector<uint8_t> dfd(4 + blockSize, 0);
+    put32(dfd, 0, static_cast<uint32_t>(dfd.size())); // dfdTotalSize
+    put32(dfd, 4, 0);                                  // vendorId = Khronos, descriptorType = 基本描述块
+    put32(dfd, 8, kDfVersion | blockSize << 16);
+    put32(dfd, 12, model | kDfPrimariesBT709 << 8 | kDfTransferLinear << 16);
+    put32(dfd, 16, 3 | 3 << 8); // 纹素块尺寸减1：4x4x1x1
+    put32(dfd, 20, blockBytes); // bytesPlane0
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+      size_t offset = 28 + 16 * i;
+      put32(dfd, offset, samples[i].bitOffset | 63u << 16 | samples[i].channel << 24); // bitLength 存储为位数减1
+      put32(dfd, offset + 4, 0);                                                       // 样本位置
+      put32(dfd, offset + 8, 0);                                                       // sampleLower
+      put32(dfd, offset + 12, UINT32_MAX);                                             // sampleUpper
+    }
+    return dfd;
+  }
+
+  uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 1469598103934665603ull)
+  {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  template <typename Fn>
+  void parallelFor(size_t count, Fn fn)
+  {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads <= 1 || count < kParallelMinRows)
+    {
+      fn(size_t(0), count);
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++)
+    {
+      size_t begin = t * chunk;
+      size_t end = std::min(count, begin + chunk);
+      if (begin >= end)
+        break;
+      workers.emplace_back(fn, begin, end);
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  // ---------------------------------------------------------------------------
+  // mip链
+  // ---------------------------------------------------------------------------
+
+  using RgbaImage = TextureLevel;
+
+  // 2x2盒式滤波下采样，奇数边长时最后一行/列被钳制
+  TextureLevel downsample(const TextureLevel &src, uint32_t channels, bool normalMap)
+  {
+    TextureLevel dst;
+    dst.width = std::max(1u, src.width / 2);
+    dst.height = std::max(1u, src.height / 2);
+    dst.data.resize(size_t(dst.width) * dst.height * channels);
+    normalMap = normalMap && channels >= 3;
+    for (uint32_t y = 0; y < dst.height; y++)
+    {
+      uint32_t y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+      for (uint32_t x = 0; x < dst.width; x++)
+      {
+        uint32_t x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+        const uint8_t *p[4] = {&src.data[(size_t(y0) * src.width + x0) * channels], &src.data[(size_t(y0) * src.width + x1) * channels],
+                               &src.data[(size_t(y1) * src.width + x0) * channels], &src.data[(size_t(y1) * src.width + x1) * channels]};
+        uint8_t *out = &dst.data[(size_t(y) * dst.width + x) * channels];
+        uint32_t first = 0;
+        if (normalMap)
+        {
+          // 在[-1,1]空间平均后重新归一化，避免远处法线变短
+          float n[3] = {0.0f, 0.0f, 0.0f};
+          for (int i = 0; i < 4; i++)
+            for (int c = 0; c < 3; c++)
+              n[c] += p[i][c] / 127.5f - 1.0f;
+          float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+          for (int c = 0; c < 3; c++)
+          {
+            float v = length > 1e-6f ? n[c] / length : (c == 2 ? 1.0f : 0.0f);
+            out[c] = static_cast<uint8_t>(std::clamp((v + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f));
+          }
+          first = 3;
+        }
+        for (uint32_t c = first; c < channels; c++)
+          out[c] = static_cast<uint8_t>((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+      }
+    }
+    return dst;
+  }
+
+  // ---------------------------------------------------------------------------
+  // 块编码
+  // ---------------------------------------------------------------------------
+
+  // 取出4x4块（RGBA），越过图像边缘的像素钳制到边缘
+  void fetchBlock(const RgbaImage &image, uint32_t bx, uint32_t by, uint8_t block[16][4])
+  {
+    for (uint32_t y = 0; y < 4; y++)
+    {
+      uint32_t sy = std::min(by * 4 + y, image.height - 1);
+      for (uint32_t x = 0; x < 4; x++)
+      {
+        uint32_t sx = std::min(bx * 4 + x, image.width - 1);
+        std::memcpy(block[y * 4 + x], &image.data[(size_t(sy) * image.width + sx) * 4], 4);
+      }
+    }
+  }
+
+  uint16_t packRgb565(const float c[3])
+  {
+    auto quantize = [](float v, int bits)
+    {
+      int maxValue = (1 << bits) - 1;
+      return std::clamp(static_cast<int>(v * maxValue / 255.0f + 0.5f), 0, maxValue);
+    };
+    return static_cast<uint16_t>((quantize(c[0], 5) << 11) | (quantize(c[1], 6) << 5) | quantize(c[2], 5));
+  }
+
+  void unpackRgb565(uint16_t packed, int out[3])
+  {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+  }
+
+  // BC1颜色块：沿颜色主轴（幂迭代求得）取两端点并向内收缩1/16，4色模式
+  void encodeColorBlock(const uint8_t block[16][4], uint8_t *out)
+  {
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++)
+      for (int c = 0; c < 3; c++)
+        mean[c] += block[i][c];
+    for (int c = 0; c < 3; c++)
+      mean[c] /= 16.0f;
+
+    float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++)
+    {
+      float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+      cov[0] += r * r;
+      cov[1] += r * g;
+      cov[2] += r * b;
+      cov[3] += g * g;
+      cov[4] += g * b;
+      cov[5] += b * b;
+    }
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 4; iteration++)
+    {
+      float next[3] = {cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                       cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                       cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+      float length = std::max({std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2])});
+      if (length < 1e-6f)
+        break;
+      for (int c = 0; c < 3; c++)
+        axis[c] = next[c] / length;
+    }
+
+    float minT = 1e30f, maxT = -1e30f;
+    int minIndex = 0, maxIndex = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      float t = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+      if (t < minT)
+      {
+        minT = t;
+        minIndex = i;
+      }
+      if (t > maxT)
+      {
+        maxT = t;
+        maxIndex = i;
+      }
+    }
+    float high[3], low[3];
+    for (int c = 0; c < 3; c++)
+    {
+      float inset = (block[maxIndex][c] - block[minIndex][c]) / 16.0f;
+      high[c] = block[maxIndex][c] - inset;
+      low[c] = block[minIndex][c] + inset;
+    }
+
+    uint16_t c0 = packRgb565(high), c1 = packRgb565(low);
+    if (c0 < c1)
+      std::swap(c0, c1);
+    uint32_t indices = 0;
+    if (c0 != c1)
+    {
+      int palette[4][3];
+      unpackRgb565(c0, palette[0]);
+      unpackRgb565(c1, palette[1]);
+      for (int c = 0; c < 3; c++)
+      {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+      }
+      for (int i = 0; i < 16; i++)
+      {
+        int best = 0, bestDistance = INT32_MAX;
+        for (int p = 0; p < 4; p++)
+        {
+          int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+          int distance = dr * dr + dg * dg + db * db;
+          if (distance < bestDistance)
+          {
+            bestDistance = distance;
+            best = p;
+          }
+        }
+        indices |= uint32_t(best) << (i * 2);
+      }
+    }
+    out[0] = c0 & 0xFF;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF;
+    out[3] = c1 >> 8;
+    for (int i = 0; i < 4; i++)
+      out[4 + i] = (indices >> (i * 8)) & 0xFF;
+  }
+
+  // BC4单通道块（BC3的Alpha与BC5的两个通道）：端点取最大/最小值，8级插值模式
+  void encodeChannelBlock(const uint8_t block[16][4], int channel, uint8_t *out)
+  {
+    int high = 0, low = 255;
+    for (int i = 0; i < 16; i++)
+    {
+      high = std::max<int>(high, block[i][channel]);
+      low = std::min<int>(low, block[i][channel]);
+    }
+    out[0] = static_cast<uint8_t>(high);
+    out[1] = static_cast<uint8_t>(low);
+    uint64_t indices = 0;
+    if (high != low)
+    {
+      int palette[8] = {high, low};
+      for (int p = 2; p < 8; p++)
+        palette[p] = ((8 - p) * high + (p - 1) * low + 3) / 7;
+      for (int i = 0; i < 16; i++)
+      {
+        int best = 0, bestDistance = INT32_MAX;
+        for (int p = 0; p < 8; p++)
+        {
+          int distance = std::abs(block[i][channel] - palette[p]);
+          if (distance < bestDistance)
+          {
+            bestDistance = distance;
+            best = p;
+          }
+        }
+        indices |= uint64_t(best) << (i * 3);
+      }
+    }
+    for (int i = 0; i < 6; i++)
+      out[2 + i] = (indices >> (i * 8)) & 0xFF;
+  }
+
+  void encodeLevel(const RgbaImage &image, BlockFormat format, std::vector<uint8_t> &out)
+  {
+    uint32_t blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+    uint32_t blockBytes = blockFormatBytes(format);
+    out.resize(size_t(blocksX) * blocksY * blockBytes);
+    parallelFor(blocksY, [&](size_t begin, size_t end)
+                {
+      uint8_t block[16][4];
+      for (size_t by = begin; by < end; by++)
+      {
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+          fetchBlock(image, bx, static_cast<uint32_t>(by), block);
+          uint8_t *dst = &out[(by * blocksX + bx) * blockBytes];
+          switch (format)
+          {
+          case BlockFormat::BC1:
+            encodeColorBlock(block, dst);
+            break;
+          case BlockFormat::BC3:
+            encodeChannelBlock(block, 3, dst);
+            encodeColorBlock(block, dst + 8);
+            break;
+          case BlockFormat::BC5:
+            encodeChannelBlock(block, 0, dst);
+            encodeChannelBlock(block, 1, dst + 8);
+            break;
+          }
+        }
+      } });
+  }
+
+  uint32_t vkFormatOf(BlockFormat format)
+  {
+    switch (format)
+    {
+    case BlockFormat::BC3:
+      return kVkFormatBC3Unorm;
+    case BlockFormat::BC5:
+      return kVkFormatBC5Unorm;
+    default:
+      return kVkFormatBC1RgbUnorm;
+    }
+  }
+
+  bool blockFormatFromVk(uint32_t vkFormat, BlockFormat &format)
+  {
+    switch (vkFormat)
+    {
+    case kVkFormatBC1RgbUnorm:
+      format = BlockFormat::BC1;
+      return true;
+    case kVkFormatBC3Unorm:
+      format = BlockFormat::BC3;
+      return true;
+    case kVkFormatBC5Unorm:
+      format = BlockFormat::BC5;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  const char *roleName(TextureRole role)
+  {
+    switch (role)
+    {
+    case TextureRole::Specular:
+      return "specular";
+    case TextureRole::Normal:
+      return "normal";
+    case TextureRole::Height:
+      return "height";
+    default:
+      return "diffuse";
+    }
+  }
+}
+
+TextureRole textureRoleFromType(const std::string &typeName)
+{
+  if (typeName == "texture_normal")
+    return TextureRole::Normal;
+  if (typeName == "texture_specular")
+    return TextureRole::Specular;
+  if (typeName == "texture_height")
+    return TextureRole::Height;
+  return TextureRole::Diffuse;
+}
+
+BlockFormat chooseBlockFormat(TextureRole role, bool hasAlpha)
+{
+  switch (role)
+  {
+  case TextureRole::Normal:
+    return BlockFormat::BC5;
+  case TextureRole::Diffuse:
+    return hasAlpha ? BlockFormat::BC3 : BlockFormat::BC1;
+  default:
+    return BlockFormat::BC1;
+  }
+}
+
+const char *blockFormatName(BlockFormat format)
+{
+  switch (format)
+  {
+  case BlockFormat::BC3:
+    return "BC3";
+  case BlockFormat::BC5:
+    return "BC5";
+  default:
+    return "BC1";
+  }
+}
+
+uint32_t blockFormatBytes(BlockFormat format)
+{
+  return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+uint64_t CompressedTexture::totalBytes() const
+{
+  uint64_t total = 0;
+  for (const Level &level : levels)
+    total += level.data.size();
+  return total;
+}
+
+std::vector<TextureLevel> buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t channels,
+                                        bool normalMap)
+{
+  std::vector<TextureLevel> levels;
+  if (!pixels || width == 0 || height == 0)
+    return levels;
+  TextureLevel level;
+  level.width = width;
+  level.height = height;
+  level.data.assign(pixels, pixels + size_t(width) * height * channels);
+  levels.push_back(std::move(level));
+  while (levels.back().width > 1 || levels.back().height > 1)
+    levels.push_back(downsample(levels.back(), channels, normalMap));
+  return levels;
+}
+
+int capTextureLevels(std::vector<TextureLevel> &levels, uint32_t maxSize)
+{
+  if (maxSize == 0)
+    return 0;
+  size_t drop = 0;
+  while (drop + 1 < levels.size() && std::max(levels[drop].width, levels[drop].height) > maxSize)
+    drop++;
+  levels.erase(levels.begin(), levels.begin() + drop);
+  return static_cast<int>(drop);
+}
+
+CompressedTexture compressTexture(const uint8_t *rgba, uint32_t width, uint32_t height, BlockFormat format,
+                                  TextureRole role)
+{
+  CompressedTexture texture;
+  texture.format = format;
+  texture.width = width;
+  texture.height = height;
+  if (!rgba || width == 0 || height == 0)
+    return texture;
+
+  RgbaImage image;
+  image.width = width;
+  image.height = height;
+  image.data.assign(rgba, rgba + size_t(width) * height * 4);
+  bool normalMap = role == TextureRole::Normal;
+  while (true)
+  {
+    CompressedTexture::Level level;
+    level.width = image.width;
+    level.height = image.height;
+    encodeLevel(image, format, level.data);
+    texture.levels.push_back(std::move(level));
+    if (image.width == 1 && image.height == 1)
+      break;
+    image = downsample(image, 4, normalMap);
+  }
+  return texture;
+}
+
+// ---------------------------------------------------------------------------
+// 磁盘缓存
+// ---------------------------------------------------------------------------
+
+std::string TextureCache::keyForFile(const std::string &path, TextureRole role)
+{
+  std::error_code error;
+  std::filesystem::path file(path);
+  uintmax_t size = std::filesystem::file_size(file, error);
+  if (error)
+    return std::string();
+  auto modified = std::filesystem::last_write_time(file, error);
+  if (error)
+    return std::string();
+
+  std::ostringstream key;
+  key << "v" << kCacheVersion << "|file|" << std::filesystem::absolute(file, error).generic_string() << "|" << size
+      << "|" << modified.time_since_epoch().count() << "|" << roleName(role);
+  return key.str();
+}
+
+std::string TextureCache::keyForMemory(const void *data, size_t size, TextureRole role)
+{
+  std::ostringstream key;
+  key << "v" << kCacheVersion << "|memory|" << std::hex << fnv1a(data, size) << std::dec << "|" << size << "|"
+      << roleName(role);
+  return key.str();
+}
+
+std::string TextureCache::pathForKey(const std::string &key) const
+{
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.ktx2", (unsigned long long)fnv1a(key.data(), key.size()));
+  return (std::filesystem::path(directory_) / name).string();
+}
+
+bool TextureCache::load(const std::string &key, CompressedTexture &texture) const
+{
+  if (key.empty() || directory_.empty())
+    return false;
+  std::ifstream file(pathForKey(key), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  uint8_t header[kHeaderBytes];
+  file.read(reinterpret_cast<char *>(header), sizeof(header));
+  if (!file || std::memcmp(header, kKtx2Identifier, sizeof(kKtx2Identifier)) != 0)
+    return false;
+  uint32_t levelCount = get32(header + kLevelCount);
+  uint32_t pixelWidth = get32(header + kPixelWidth);
+  uint32_t pixelHeight = get32(header + kPixelHeight);
+  if (levelCount == 0 || levelCount > 32 || get32(header + kSupercompressionScheme) != 0)
+    return false;
+
+  BlockFormat format;
+  if (!blockFormatFromVk(get32(header + kVkFormat), format))
+    return false;
+
+  std::vector<uint8_t> index(levelCount * kLevelIndexBytes);
+  file.read(reinterpret_cast<char *>(index.data()), index.size());
+
+  // 键值数据：单个 "gltrackball.cacheKey" 条目，与请求的键不一致时视为哈希冲突
+  std::vector<uint8_t> kvd(get32(header + kKvdByteLength));
+  file.seekg(get32(header + kKvdByteOffset));
+  file.read(reinterpret_cast<char *>(kvd.data()), kvd.size());
+  if (!file || kvd.size() < sizeof(uint32_t))
+    return false;
+  uint32_t entryLength = get32(kvd.data());
+  std::string entry(reinterpret_cast<const char *>(kvd.data()) + sizeof(uint32_t),
+                    std::min<size_t>(entryLength, kvd.size() - sizeof(uint32_t)));
+  std::string expected = std::string(kCacheKeyName) + '\0' + key + '\0';
+  if (entry != expected)
+    return false;
+
+  texture.format = format;
+  texture.width = pixelWidth;
+  texture.height = pixelHeight;
+  texture.levels.assign(levelCount, CompressedTexture::Level());
+  for (uint32_t i = 0; i < levelCount; i++)
+  {
+    CompressedTexture::Level &level = texture.levels[i];
+    level.width = std::max(1u, pixelWidth >> i);
+    level.height = std::max(1u, pixelHeight >> i);
+    uint64_t byteOffset = get64(&index[i * kLevelIndexBytes]);
+    uint64_t byteLength = get64(&index[i * kLevelIndexBytes + 8]);
+    uint64_t expectedBytes = uint64_t((level.width + 3) / 4) * ((level.height + 3) / 4) * blockFormatBytes(format);
+    if (byteLength != expectedBytes)
+      return false;
+    level.data.resize(byteLength);
+    file.seekg(byteOffset);
+    file.read(reinterpret_cast<char *>(level.data.data()), level.data.size());
+  }
+  return static_cast<bool>(file);
+}
+
+bool TextureCache::store(const std::string &key, const CompressedTexture &texture) const
+{
+  if (key.empty() || directory_.empty() || texture.levels.empty())
+    return false;
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+
+  uint32_t blockBytes = blockFormatBytes(texture.format);
+  uint32_t levelCount = static_cast<uint32_t>(texture.levels.size());
+  std::vector<uint8_t> dfd = buildDfd(texture.format, blockBytes);
+
+  std::string entry = std::string(kCacheKeyName) + '\0' + key + '\0';
+  std::vector<uint8_t> kvd(sizeof(uint32_t) + entry.size());
+  put32(kvd, 0, static_cast<uint32_t>(entry.size()));
+  std::memcpy(kvd.data() + sizeof(uint32_t), entry.data(), entry.size());
+  while (kvd.size() % 4)
+    kvd.push_back(0);
+
+  // 头部、层级索引、DFD、键值数据依次紧接，之后是层级数据
+  size_t dfdOffset = kHeaderBytes + levelCount * kLevelIndexBytes;
+  size_t kvdOffset = dfdOffset + dfd.size();
+  std::vector<uint8_t> head(kvdOffset + kvd.size(), 0);
+  std::memcpy(head.data(), kKtx2Identifier, sizeof(kKtx2Identifier));
+  put32(head, kVkFormat, vkFormatOf(texture.format));
+  put32(head, kTypeSize, 1);
+  put32(head, kPixelWidth, texture.width);
+  put32(head, kPixelHeight, texture.height);
+  put32(head, kFaceCount, 1);
+  put32(head, kLevelCount, levelCount);
+  put32(head, kDfdByteOffset, static_cast<uint32_t>(dfdOffset));
+  put32(head, kDfdByteLength, static_cast<uint32_t>(dfd.size()));
+  put32(head, kKvdByteOffset, static_cast<uint32_t>(kvdOffset));
+  put32(head, kKvdByteLength, static_cast<uint32_t>(kvd.size()));
+  std::memcpy(&head[dfdOffset], dfd.data(), dfd.size());
+  std::memcpy(&head[kvdOffset], kvd.data(), kvd.size());
+
+  // KTX2要求层级数据从最小的mip开始存放，按 lcm(块字节数, 4) 对齐，BC格式即块大小本身
+  uint64_t alignment = blockBytes;
+  uint64_t offset = (head.size() + alignment - 1) / alignment * alignment;
+  uint64_t dataStart = offset;
+  for (uint32_t i = levelCount; i-- > 0;)
+  {
+    uint64_t byteLength = texture.levels[i].data.size();
+    size_t entryOffset = kHeaderBytes + i * kLevelIndexBytes;
+    put64(head, entryOffset, offset);
+    put64(head, entryOffset + 8, byteLength);
+    put64(head, entryOffset + 16, byteLength);
+    offset += (byteLength + alignment - 1) / alignment * alignment;
+  }
+
+  // 先写临时文件再改名，避免中断时留下残缺的缓存
+  std::string path = pathForKey(key);
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      return false;
+    file.write(reinterpret_cast<const char *>(head.data()), head.size());
+    std::vector<char> padding(alignment, 0);
+    file.write(padding.data(), dataStart - head.size());
+    for (uint32_t i = levelCount; i-- > 0;)
+    {
+      const std::vector<uint8_t> &data = texture.levels[i].data;
+      file.write(reinterpret_cast<const char *>(data.data()), data.size());
+      file.write(padding.data(), (alignment - data.size() % alignment) % alignment);
+    }
+    if (!file)
+      return false;
+  }
+  std::filesystem::rename(temporary, path, error);
+  return !error;
+}
@@ -0,0 +1,82 @@
+#ifndef __TEXTURE_CODEC_H
+#define __TEXTURE_CODEC_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 纹理在材质中的用途，决定压缩格式
+enum class TextureRole
+{
+  Diffuse,  // 漫反射：不透明用BC1，含透明度用BC3
+  Specular, // 高光：BC1
+  Normal,   // 法线：BC5（只存XY，着色器中重建Z）
+  Height    // 高度/环境光遮蔽：BC1
+};
+
+enum class BlockFormat : uint32_t
+{
+  BC1, // 8字节/块，RGB
+  BC3, // 16字节/块，RGB + 插值Alpha
+  BC5  // 16字节/块，两个独立通道（RG）
+};
+
+TextureRole textureRoleFromType(const std::string &typeName); // "texture_diffuse" 等
+BlockFormat chooseBlockFormat(TextureRole role, bool hasAlpha);
+const char *blockFormatName(BlockFormat format);
+uint32_t blockFormatBytes(BlockFormat format); // 每个4x4块的字节数
+
+// 一层mip数据：未压缩时为紧密排列的像素，压缩时为按行排列的4x4块
+struct TextureLevel
+{
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> data;
+};
+
+// 块压缩纹理及完整mip链（level 0为最大层）
+struct CompressedTexture
+{
+  using Level = TextureLevel;
+
+  BlockFormat format = BlockFormat::BC1;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<Level> levels;
+
+  uint64_t totalBytes() const;
+};
+
+// 未压缩像素（1/3/4通道）的CPU mip链，level 0为原图，最后一层为1x1；法线图逐层重新归一化
+std::vector<TextureLevel> buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t channels,
+                                        bool normalMap);
+
+// 按分辨率上限（0表示不限）裁掉mip链顶部的层，返回裁掉的层数；至少保留最后一层
+int capTextureLevels(std::vector<TextureLevel> &levels, uint32_t maxSize);
+
+// RGBA8 像素 -> 块压缩纹理：CPU上生成mip链（法线图逐层重新归一化）后逐层编码
+CompressedTexture compressTexture(const uint8_t *rgba, uint32_t width, uint32_t height, BlockFormat format,
+                                  TextureRole role);
+
+// 转码结果的磁盘缓存。文件为标准KTX2（按规范偏移写入头部、层级索引、基本数据格式描述块，
+// 层级数据从小到大存放），可用 ktx 工具直接查看；键值数据中保存缓存键用于校验
+class TextureCache
+{
+private:
+  std::string directory_;
+
+  std::string pathForKey(const std::string &key) const;
+
+public:
+  explicit TextureCache(const std::string &directory) : directory_(directory) {}
+
+  // 源文件的缓存键：路径、大小、修改时间与目标格式，源文件变化后自动失效
+  static std::string keyForFile(const std::string &path, TextureRole role);
+  // 内存数据（内嵌纹理）的缓存键：按内容哈希
+  static std::string keyForMemory(const void *data, size_t size, TextureRole role);
+
+  bool load(const std::string &key, CompressedTexture &texture) const;
+  bool store(const std::string &key, const CompressedTexture &texture) const;
+};
+
+#endif
@@ -0,0 +1,305 @@
+#include "texture_streamer.h"
+#include "texture_budget.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cstring>
+
+void TextureStreamer::enqueue(GLuint texture, GLenum internalFormat, GLenum format, GLenum type, uint32_t texelBytes,
+                              std::vector<TextureLevel> levels)
+{
+  Job job;
+  job.texture = texture;
+  job.internalFormat = internalFormat;
+  job.format = format;
+  job.type = type;
+  job.texelBytes = texelBytes;
+  job.levels = std::move(levels);
+  enqueue(std::move(job), static_cast<int>(job.levels.size()));
+}
+
+void TextureStreamer::enqueueCompressed(GLuint texture, GLenum internalFormat, uint32_t blockBytes,
+                                        std::vector<TextureLevel> levels)
+{
+  Job job;
+  job.texture = texture;
+  job.internalFormat = internalFormat;
+  job.texelBytes = blockBytes;
+  job.compressed = true;
+  job.levels = std::move(levels);
+  enqueue(std::move(job), static_cast<int>(job.levels.size()));
+}
+
+void TextureStreamer::restore(GLuint texture, bool compressed, GLenum internalFormat, GLenum format, GLenum type,
+                              uint32_t texelBytes, std::vector<TextureLevel> levels, int residentLevel, int topLevel)
+{
+  cancel(texture);
+  Job job;
+  job.texture = texture;
+  job.internalFormat = internalFormat;
+  job.format = format;
+  job.type = type;
+  job.texelBytes = texelBytes;
+  job.compressed = compressed;
+  job.levels = std::move(levels);
+  job.topLevel = topLevel;
+  enqueue(std::move(job), residentLevel);
+}
+
+// residentLevel 及更小的层已驻留（新纹理为层数），不再分配和上传
+void TextureStreamer::enqueue(Job job, int residentLevel)
+{
+  if (job.levels.empty())
+    return;
+
+  // 尾部小mip直接上传，保证纹理从第一帧起就是完整的（基础层为尾部最大的一层）
+  int levelCount = static_cast<int>(job.levels.size());
+  int tail = levelCount - 1;
+  while (tail > 0 && std::max(job.levels[tail - 1].width, job.levels[tail - 1].height) <= kResidentTailSize)
+    tail--;
+  tail = std::max(job.topLevel, std::min(tail, residentLevel));
+  for (int i = 0; i < job.topLevel; i++)
+    std::vector<uint8_t>().swap(job.levels[i].data);
+
+  GLint alignment = 4;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glBindTexture(GL_TEXTURE_2D, job.texture);
+  for (int i = job.topLevel; i < std::min(levelCount, residentLevel); i++)
+  {
+    TextureLevel &level = job.levels[i];
+    const void *data = i >= tail ? level.data.data() : nullptr;
+    if (job.compressed)
+      glCompressedTexImage2D(GL_TEXTURE_2D, i, job.internalFormat, level.width, level.height, 0,
+                             static_cast<GLsizei>(level.data.size()), data);
+    else
+      glTexImage2D(GL_TEXTURE_2D, i, job.internalFormat, level.width, level.height, 0, job.format, job.type, data);
+  }
+  for (int i = tail; i < levelCount; i++)
+    std::vector<uint8_t>().swap(job.levels[i].data);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, tail);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  TextureBudget::get_instance().onLevelResident(job.texture, tail);
+
+  if (tail == job.topLevel)
+  {
+    completedTextures_++;
+    return;
+  }
+  job.level = tail - 1;
+  job.rowsDone = 0;
+  pendingBytes_ += remainingBytes(job);
+  jobs_.push_back(std::move(job));
+}
+
+uint32_t TextureStreamer::rowBytes(const Job &job, const TextureLevel &level)
+{
+  if (job.compressed)
+    return (level.width + 3) / 4 * job.texelBytes;
+  return level.width * job.texelBytes;
+}
+
+uint32_t TextureStreamer::rowCount(const Job &job, const TextureLevel &level)
+{
+  return job.compressed ? (level.height + 3) / 4 : level.height;
+}
+
+uint64_t TextureStreamer::remainingBytes(const Job &job)
+{
+  if (job.level < job.topLevel)
+    return 0;
+  uint64_t bytes = 0;
+  for (int i = job.topLevel; i <= job.level; i++)
+    bytes += job.levels[i].data.size();
+  return bytes - uint64_t(job.rowsDone) * rowBytes(job, job.levels[job.level]);
+}
+
+uint64_t TextureStreamer::pendingBytes(GLuint texture) const
+{
+  for (const Job &job : jobs_)
+  {
+    if (job.texture == texture)
+      return remainingBytes(job);
+  }
+  return 0;
+}
+
+int TextureStreamer::residentLevel(GLuint texture) const
+{
+  for (const Job &job : jobs_)
+  {
+    if (job.texture == texture)
+      return job.level + 1;
+  }
+  return 0;
+}
+
+void TextureStreamer::cancel(GLuint texture)
+{
+  auto it = std::find_if(jobs_.begin(), jobs_.end(), [texture](const Job &job)
+                         { return job.texture == texture; });
+  if (it == jobs_.end())
+    return;
+  pendingBytes_ -= remainingBytes(*it);
+  jobs_.erase(it);
+}
+
+void TextureStreamer::uploadRows(const Job &job, uint32_t firstRow, uint32_t rows, const void *pixels)
+{
+  const TextureLevel &level = job.levels[job.level];
+  if (job.compressed)
+  {
+    // 压缩格式按4像素高的块行提交，最后一块行可能不足4像素
+    GLint y = firstRow * 4;
+    GLsizei height = std::min<GLsizei>(rows * 4, level.height - y);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, job.level, 0, y, level.width, height, job.internalFormat,
+                              rows * rowBytes(job, level), pixels);
+  }
+  else
+  {
+    glTexSubImage2D(GL_TEXTURE_2D, job.level, 0, firstRow, level.width, rows, job.format, job.type, pixels);
+  }
+}
+
+// 环形取下一个槽位；槽位上次的上传尚未被GPU消费时不等待（返回空），除非 wait 为 true
+TextureStreamer::Slot *TextureStreamer::acquireSlot(uint32_t bytes, bool wait)
+{
+  Slot &slot = slots_[nextSlot_];
+  if (slot.fence)
+  {
+    GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? UINT64_MAX : 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      return nullptr;
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+  }
+  if (!slot.buffer)
+    glGenBuffers(1, &slot.buffer);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+  if (slot.size < bytes)
+  {
+    slot.size = std::max(bytes, kSlotBytes);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, slot.size, nullptr, GL_STREAM_DRAW);
+  }
+  nextSlot_ = (nextSlot_ + 1) % kSlotCount;
+  return &slot;
+}
+
+void TextureStreamer::finishLevel(Job &job)
+{
+  // 该层的上传命令已全部提交，之后的绘制命令按顺序执行，可以立即把基础层下调到该层
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, job.level);
+  TextureBudget::get_instance().onLevelResident(job.texture, job.level);
+  std::vector<uint8_t>().swap(job.levels[job.level].data);
+  job.level--;
+  job.rowsDone = 0;
+}
+
+uint64_t TextureStreamer::upload(uint64_t budget, bool wait)
+{
+  uint64_t uploaded = 0;
+  if (jobs_.empty())
+    return uploaded;
+
+  GLint alignment = 4;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  while (!jobs_.empty())
+  {
+    Job &job = jobs_.front();
+    const TextureLevel &level = job.levels[job.level];
+    uint32_t bytesPerRow = rowBytes(job, level);
+    uint32_t rows = rowCount(job, level) - job.rowsDone;
+
+    // 预算内能提交的行数（每帧至少推进一行），并受槽位大小限制
+    uint64_t left = budget > uploaded ? budget - uploaded : 0;
+    uint64_t affordable = left / bytesPerRow;
+    if (affordable == 0)
+    {
+      if (uploaded > 0)
+        break;
+      affordable = 1;
+    }
+    rows = static_cast<uint32_t>(std::min<uint64_t>(rows, affordable));
+    rows = std::min(rows, std::max(1u, kSlotBytes / bytesPerRow));
+    uint32_t bytes = rows * bytesPerRow;
+
+    Slot *slot = acquireSlot(bytes, wait);
+    if (!slot)
+    {
+      slotWaits_++;
+      break;
+    }
+    const uint8_t *src = level.data.data() + uint64_t(job.rowsDone) * bytesPerRow;
+    glBindTexture(GL_TEXTURE_2D, job.texture);
+    void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst)
+    {
+      std::memcpy(dst, src, bytes);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      uploadRows(job, job.rowsDone, rows, nullptr); // PBO绑定时指针参数为缓冲内偏移
+      slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else
+    {
+      // 映射失败时退回直接从客户端内存上传
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      uploadRows(job, job.rowsDone, rows, src);
+    }
+
+    uploaded += bytes;
+    pendingBytes_ -= bytes;
+    job.rowsDone += rows;
+    if (job.rowsDone == rowCount(job, level))
+    {
+      finishLevel(job);
+      if (job.level < job.topLevel)
+      {
+        completedTextures_++;
+        jobs_.pop_front();
+      }
+    }
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  return uploaded;
+}
+
+void TextureStreamer::update()
+{
+  uploadedLastFrame_ = upload(frameBudget_, false);
+}
+
+void TextureStreamer::flush()
+{
+  upload(UINT64_MAX, true);
+}
+
+void TextureStreamer::release()
+{
+  jobs_.clear();
+  pendingBytes_ = 0;
+  for (Slot &slot : slots_)
+  {
+    if (slot.fence)
+      glDeleteSync(slot.fence);
+    if (slot.buffer)
+      glDeleteBuffers(1, &slot.buffer);
+    slot = Slot();
+  }
+}
+
+void TextureStreamer::render_panel()
+{
+  if (!ImGui::CollapsingHeader("纹理流式上传"))
+    return;
+
+  const double MB = 1024.0 * 1024.0;
+  int budgetMB = static_cast<int>(frameBudget_ >> 20);
+  if (ImGui::SliderInt("每帧上传预算 (MB)", &budgetMB, 1, 256))
+    frameBudget_ = uint64_t(budgetMB) << 20;
+  ImGui::Text("排队纹理: %zu, 待上传 %.1f MB", jobs_.size(), pendingBytes_ / MB);
+  ImGui::Text("上一帧上传: %.2f MB, 已完成纹理: %llu", uploadedLastFrame_ / MB, (unsigned long long)completedTextures_);
+  ImGui::Text("PBO槽位占用导致的提前结束: %llu 次", (unsigned long long)slotWaits_);
+}
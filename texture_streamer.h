@@ -0,0 +1,93 @@
+#ifndef __TEXTURE_STREAMER_H
+#define __TEXTURE_STREAMER_H
+
+#include <glad/glad.h>
+#include "texture_codec.h"
+#include <cstdint>
+#include <deque>
+
+// 纹理流式上传：入队时分配完整mip链并立即上传小尺寸的尾部mip（作为基础层先显示），
+// 其余各层从小到大经由PBO环形缓冲逐行上传，每帧不超过字节预算；PBO槽位用栅栏同步复用。
+// 每完成一层就把 GL_TEXTURE_BASE_LEVEL 下调到该层，直到完整mip链驻留
+class TextureStreamer
+{
+private:
+  static constexpr int kSlotCount = 4;              // PBO槽位数（最多同时有这么多次上传在GPU上未完成）
+  static constexpr uint32_t kSlotBytes = 4u << 20;  // 每个槽位的默认大小
+  static constexpr uint32_t kResidentTailSize = 64; // 边长不超过该值的mip层在入队时直接上传
+
+  struct Slot
+  {
+    GLuint buffer = 0;
+    uint32_t size = 0;
+    GLsync fence = nullptr;
+  };
+
+  struct Job
+  {
+    GLuint texture = 0;
+    GLenum internalFormat = 0;
+    GLenum format = 0; // 压缩格式为0
+    GLenum type = 0;
+    uint32_t texelBytes = 0; // 未压缩：每像素字节数；压缩：每4x4块字节数
+    bool compressed = false;
+    std::vector<TextureLevel> levels;
+    int level = -1;        // 正在上传的层，小于 topLevel 表示已完成
+    int topLevel = 0;      // 上传到该层为止（恢复被降级的纹理时可能大于0）
+    uint32_t rowsDone = 0; // 当前层已提交的行数（压缩格式按块行计）
+  };
+
+  std::deque<Job> jobs_;
+  Slot slots_[kSlotCount];
+  int nextSlot_ = 0;
+
+  uint64_t frameBudget_ = 16ull << 20;
+  uint64_t uploadedLastFrame_ = 0;
+  uint64_t pendingBytes_ = 0;
+  uint64_t completedTextures_ = 0;
+  uint64_t slotWaits_ = 0; // 因槽位仍被GPU占用而提前结束的帧数
+
+  TextureStreamer() = default;
+  void enqueue(Job job, int residentLevel);
+  static uint32_t rowBytes(const Job &job, const TextureLevel &level);
+  static uint32_t rowCount(const Job &job, const TextureLevel &level);
+  static uint64_t remainingBytes(const Job &job);
+  void uploadRows(const Job &job, uint32_t firstRow, uint32_t rows, const void *pixels);
+  Slot *acquireSlot(uint32_t bytes, bool wait);
+  void finishLevel(Job &job);
+  uint64_t upload(uint64_t budget, bool wait);
+
+public:
+  TextureStreamer(const TextureStreamer &) = delete;
+  TextureStreamer &operator=(const TextureStreamer &) = delete;
+  static TextureStreamer &get_instance()
+  {
+    static TextureStreamer instance;
+    return instance;
+  }
+
+  // levels[0]为最大层；返回时纹理仍绑定在当前纹理单元上，调用方可继续设置采样参数
+  void enqueue(GLuint texture, GLenum internalFormat, GLenum format, GLenum type, uint32_t texelBytes,
+               std::vector<TextureLevel> levels);
+  void enqueueCompressed(GLuint texture, GLenum internalFormat, uint32_t blockBytes, std::vector<TextureLevel> levels);
+  // 恢复被降级的纹理：residentLevel 及更小的层仍驻留，只重新分配并上传 [topLevel, residentLevel) 各层
+  void restore(GLuint texture, bool compressed, GLenum internalFormat, GLenum format, GLenum type, uint32_t texelBytes,
+               std::vector<TextureLevel> levels, int residentLevel, int topLevel);
+  // 删除纹理前调用，丢弃未上传的数据
+  void cancel(GLuint texture);
+
+  void update();  // 每帧调用一次，在预算内推进上传
+  void flush();   // 不受预算限制地上传全部排队数据
+  void release(); // 释放PBO与栅栏（GL上下文销毁前调用）
+
+  void setFrameBudget(uint64_t bytes) { frameBudget_ = bytes; }
+  uint64_t frameBudget() const { return frameBudget_; }
+  uint64_t pendingBytes() const { return pendingBytes_; }
+  uint64_t pendingBytes(GLuint texture) const;
+  size_t pendingTextures() const { return jobs_.size(); }
+  int residentLevel(GLuint texture) const; // 当前已完整驻留的最大层（没有排队任务时为0）
+
+  void render_panel();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef __TRIPLE_BUFFER_H
+#define __TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// 单生产者/单消费者的无锁三缓冲：生产者总有一个可写的槽位，消费者总能拿到最新发布的完整数据，
+// 双方都不会等待对方。中间槽位的下标与“有新数据”标志放在同一个原子变量里交换。
+// 消费者跳过的旧数据直接被覆盖，适合相机状态、界面快照这类只关心最新值的数据
+template <typename T>
+class TripleBuffer
+{
+private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFresh = 0x4;
+
+  T buffers_[3];
+  std::atomic<uint8_t> middle_{1};
+  uint8_t write_ = 0; // 仅生产者访问
+  uint8_t read_ = 2;  // 仅消费者访问
+
+public:
+  TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer &) = delete;
+  TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+  // 生产者：写入 writeBuffer() 后调用 publish()，换回一个空闲槽位继续写
+  T &writeBuffer() { return buffers_[write_]; }
+  void publish()
+  {
+    uint8_t previous = middle_.exchange(static_cast<uint8_t>(write_ | kFresh), std::memory_order_acq_rel);
+    write_ = previous & kIndexMask;
+  }
+
+  // 消费者：有新数据时换入最新槽位并返回 true；否则 readBuffer() 仍是上一次取得的数据
+  bool acquire()
+  {
+    if (!(middle_.load(std::memory_order_acquire) & kFresh))
+      return false;
+    uint8_t previous = middle_.exchange(read_, std::memory_order_acq_rel);
+    read_ = previous & kIndexMask;
+    return true;
+  }
+  T &readBuffer() { return buffers_[read_]; }
+};
+
+#endif